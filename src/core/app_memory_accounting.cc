@@ -0,0 +1,198 @@
+// Copyright (c) 2021 LG Electronics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#include "app_memory_accounting.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <map>
+#include <unordered_set>
+
+#include <json/value.h>
+
+#include "utils.h"
+
+namespace {
+
+// Returns the value in kB of the first "|key| <value> kB" line of |path|.
+bool ReadKbField(const std::string& path,
+                 const std::string& key,
+                 uint64_t& value) {
+  std::ifstream in(path);
+  if (!in.is_open()) {
+    return false;
+  }
+
+  std::string line;
+  while (std::getline(in, line)) {
+    if (line.compare(0, key.size(), key) != 0) {
+      continue;
+    }
+    std::string number = util::TrimString(line.substr(key.size()));
+    value = std::strtoull(number.c_str(), nullptr, 10);
+    return true;
+  }
+  return false;
+}
+
+}  // namespace
+
+AppMemoryAccounting::AppMemoryAccounting(const std::string& proc_root,
+                                         size_t history_limit)
+    : proc_root_(proc_root),
+      history_limit_(std::max<size_t>(history_limit, 1)) {}
+
+uint64_t AppMemoryAccounting::ReadProcessPss(uint32_t pid) const {
+  if (!pid) {
+    return 0;
+  }
+
+  std::string dir = proc_root_ + "/" + std::to_string(pid);
+  uint64_t kb = 0;
+  if (ReadKbField(dir + "/smaps_rollup", "Pss:", kb)) {
+    return kb;
+  }
+  if (ReadKbField(dir + "/status", "VmRSS:", kb)) {
+    return kb;
+  }
+  return 0;
+}
+
+const std::vector<AppMemoryAccounting::Usage>& AppMemoryAccounting::Update(
+    const std::vector<Share>& shares) {
+  std::map<uint32_t, std::vector<const Share*>> by_pid;
+  for (const Share& share : shares) {
+    by_pid[share.pid].push_back(&share);
+  }
+
+  usages_.clear();
+  usages_.reserve(shares.size());
+  for (const auto& [pid, apps] : by_pid) {
+    const uint64_t process_pss = ReadProcessPss(pid);
+
+    double total_weight = 0;
+    for (const Share* share : apps) {
+      total_weight += std::max(share->weight, 0.0);
+    }
+
+    for (const Share* share : apps) {
+      Usage usage;
+      usage.app_id = share->app_id;
+      usage.instance_id = share->instance_id;
+      usage.pid = pid;
+      usage.process_pss_kb = process_pss;
+      usage.sharing_apps = apps.size();
+      // Without any usable weight the process is split evenly.
+      double ratio = total_weight > 0
+                         ? std::max(share->weight, 0.0) / total_weight
+                         : 1.0 / apps.size();
+      usage.pss_kb = static_cast<uint64_t>(std::llround(process_pss * ratio));
+      usages_.push_back(std::move(usage));
+    }
+  }
+
+  std::stable_sort(usages_.begin(), usages_.end(),
+                   [](const Usage& a, const Usage& b) {
+                     return a.pss_kb > b.pss_kb;
+                   });
+
+  RecordHistory();
+  return usages_;
+}
+
+void AppMemoryAccounting::RecordHistory() {
+  std::unordered_map<std::string, uint64_t> per_app;
+  for (const Usage& usage : usages_) {
+    per_app[usage.app_id] += usage.pss_kb;
+  }
+
+  for (const auto& [app_id, pss_kb] : per_app) {
+    std::deque<uint64_t>& samples = history_[app_id];
+    samples.push_back(pss_kb);
+    while (samples.size() > history_limit_) {
+      samples.pop_front();
+    }
+  }
+
+  // History of closed apps is kept for relaunches, but only as long as the
+  // number of tracked ids stays bounded.
+  if (history_.size() > kMaxTrackedApps) {
+    for (auto it = history_.begin(); it != history_.end();) {
+      if (!per_app.contains(it->first)) {
+        it = history_.erase(it);
+      } else {
+        ++it;
+      }
+    }
+  }
+}
+
+uint64_t AppMemoryAccounting::AttributedPss(
+    const std::string& instance_id) const {
+  auto found = std::find_if(
+      usages_.begin(), usages_.end(),
+      [&](const Usage& usage) { return usage.instance_id == instance_id; });
+  return found != usages_.end() ? found->pss_kb : 0;
+}
+
+const std::deque<uint64_t>* AppMemoryAccounting::History(
+    const std::string& app_id) const {
+  auto found = history_.find(app_id);
+  return found != history_.end() ? &found->second : nullptr;
+}
+
+Json::Value AppMemoryAccounting::ToJson(const std::string& app_id) const {
+  Json::Value apps(Json::arrayValue);
+  std::unordered_set<std::string> listed;
+  for (const Usage& usage : usages_) {
+    if (!app_id.empty() && usage.app_id != app_id) {
+      continue;
+    }
+    Json::Value app;
+    app["id"] = usage.app_id;
+    app["instanceId"] = usage.instance_id;
+    app["pid"] = usage.pid;
+    app["pss"] = static_cast<Json::UInt64>(usage.pss_kb);
+    app["processPss"] = static_cast<Json::UInt64>(usage.process_pss_kb);
+    app["sharingApps"] = static_cast<Json::UInt>(usage.sharing_apps);
+    apps.append(std::move(app));
+    listed.insert(usage.app_id);
+  }
+
+  if (!app_id.empty()) {
+    listed.insert(app_id);
+  }
+
+  Json::Value history(Json::objectValue);
+  for (const std::string& id : listed) {
+    const std::deque<uint64_t>* samples = History(id);
+    if (!samples) {
+      continue;
+    }
+    Json::Value values(Json::arrayValue);
+    for (uint64_t sample : *samples) {
+      values.append(static_cast<Json::UInt64>(sample));
+    }
+    history[id] = std::move(values);
+  }
+
+  Json::Value result;
+  result["apps"] = std::move(apps);
+  result["history"] = std::move(history);
+  return result;
+}
@@ -0,0 +1,88 @@
+// Copyright (c) 2021 LG Electronics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef CORE_APP_MEMORY_ACCOUNTING_H_
+#define CORE_APP_MEMORY_ACCOUNTING_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace Json {
+class Value;
+}
+
+// Attributes the memory of shared web processes to the apps they host.
+// The PSS of every renderer is read from procfs and split between its apps
+// in proportion to their weights.
+class AppMemoryAccounting {
+ public:
+  struct Share {
+    std::string app_id;
+    std::string instance_id;
+    uint32_t pid = 0;
+    // Relative cost of the app inside its renderer. The number of pages the
+    // app owns is used unless the engine provides a better estimate.
+    double weight = 1.0;
+  };
+
+  struct Usage {
+    std::string app_id;
+    std::string instance_id;
+    uint32_t pid = 0;
+    uint64_t pss_kb = 0;
+    uint64_t process_pss_kb = 0;
+    size_t sharing_apps = 0;
+  };
+
+  static constexpr size_t kDefaultHistoryLimit = 16;
+  static constexpr size_t kMaxTrackedApps = 64;
+
+  explicit AppMemoryAccounting(const std::string& proc_root = "/proc",
+                               size_t history_limit = kDefaultHistoryLimit);
+
+  void SetProcRoot(const std::string& proc_root) { proc_root_ = proc_root; }
+  const std::string& ProcRoot() const { return proc_root_; }
+
+  // Reads the memory of every pid in |shares| once and recomputes the
+  // attribution. Usages are kept sorted from the most to the least costly.
+  const std::vector<Usage>& Update(const std::vector<Share>& shares);
+  const std::vector<Usage>& Usages() const { return usages_; }
+
+  uint64_t AttributedPss(const std::string& instance_id) const;
+  // Attributed PSS (kB) of an app id summed over its instances, oldest
+  // sample first.
+  const std::deque<uint64_t>* History(const std::string& app_id) const;
+
+  // PSS of the process in kB. Falls back to VmRSS if smaps_rollup is not
+  // available and returns 0 if the process is gone.
+  uint64_t ReadProcessPss(uint32_t pid) const;
+
+  Json::Value ToJson(const std::string& app_id = {}) const;
+
+ private:
+  void RecordHistory();
+
+  std::string proc_root_;
+  size_t history_limit_;
+  std::vector<Usage> usages_;
+  std::unordered_map<std::string, std::deque<uint64_t>> history_;
+};
+
+#endif  // CORE_APP_MEMORY_ACCOUNTING_H_
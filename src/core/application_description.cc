@@ -241,6 +241,7 @@ std::unique_ptr<ApplicationDescription> ApplicationDescription::FromJsonString(
       int modifier = k["modifier"].asInt();
       app_desc->key_filter_table_[from] = std::make_pair(to, modifier);
     }
+    app_desc->key_filter_ = KeyFilter(app_desc->key_filter_table_);
   }
 
   // Handle trustLevel
@@ -335,6 +336,11 @@ std::unique_ptr<ApplicationDescription> ApplicationDescription::FromJsonString(
     app_desc->use_unlimited_media_policy_ = use_unlimited_media_policy.asBool();
   }
 
+  const auto& coalesce_pointer_events = json_obj["coalescePointerEvents"];
+  if (coalesce_pointer_events.isBool()) {
+    app_desc->coalesce_pointer_events_ = coalesce_pointer_events.asBool();
+  }
+
   const auto& suspend_dom_time = json_obj["suspendDOMTime"];
   if (suspend_dom_time.isInt()) {
     app_desc->custom_suspend_dom_time_ = suspend_dom_time.asInt();
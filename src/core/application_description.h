@@ -24,6 +24,7 @@
 #include <unordered_map>
 
 #include "display_id.h"
+#include "key_filter.h"
 
 class ApplicationDescription {
  public:
@@ -110,6 +111,8 @@ class ApplicationDescription {
   const std::unordered_map<int, std::pair<int, int>>& KeyFilterTable() const {
     return key_filter_table_;
   }
+  // KeyFilterTable() compiled for the lookups on key events.
+  const KeyFilter& GetKeyFilter() const { return key_filter_; }
 
   std::optional<double> NetworkStableTimeout() const {
     return network_stable_timeout_;
@@ -121,6 +124,8 @@ class ApplicationDescription {
     return delay_ms_for_launch_optimization_;
   }
   bool UseUnlimitedMediaPolicy() const { return use_unlimited_media_policy_; }
+  // Whether pointer moves are merged to one per frame.
+  bool CoalescePointerEvents() const { return coalesce_pointer_events_; }
   const std::string& LocationHint() const { return location_hint_; }
 
   struct WindowOwnerInfo {
@@ -183,6 +188,7 @@ class ApplicationDescription {
   std::optional<int> width_override_;
   std::optional<int> height_override_;
   std::unordered_map<int, std::pair<int, int>> key_filter_table_;
+  KeyFilter key_filter_;
   std::string group_window_desc_;
   bool do_not_track_ = false;
   bool handle_exit_key_ = false;
@@ -197,6 +203,7 @@ class ApplicationDescription {
   bool disallow_scrolling_in_main_frame_ = true;
   std::optional<int> delay_ms_for_launch_optimization_;
   bool use_unlimited_media_policy_ = false;
+  bool coalesce_pointer_events_ = true;
   ThirdPartyCookiesPolicy third_party_cookies_policy_ =
       ThirdPartyCookiesPolicy::kDefault;
   int display_affinity_ = kUndefinedDisplayId;
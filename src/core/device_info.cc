@@ -16,42 +16,37 @@
 
 #include "device_info.h"
 
-#include "utils.h"
+#include <utility>
 
-bool DeviceInfo::GetDisplayWidth(int& value) const {
-  bool ret = false;
-  std::string value_str;
+DeviceInfo::DeviceInfo()
+    : snapshot_(DeviceInfoSnapshot::Create({}, 0)) {}
 
-  ret = GetDeviceInfo("DisplayWidth", value_str);
-  if (ret) {
-    ret = util::StrToInt(value_str, value);
+bool DeviceInfo::GetDisplayWidth(int& value) const {
+  std::optional<int> width = Snapshot()->DisplayWidth();
+  if (!width) {
+    return false;
   }
 
-  return ret;
+  value = *width;
+  return true;
 }
 
 void DeviceInfo::SetDisplayWidth(int value) {
-  if (!device_info_.emplace("DisplayWidth", std::to_string(value)).second) {
-    device_info_["DisplayWidth"] = std::to_string(value);
-  }
+  Update("DisplayWidth", std::to_string(value));
 }
 
 bool DeviceInfo::GetDisplayHeight(int& value) const {
-  bool ret = false;
-  std::string value_str;
-
-  ret = GetDeviceInfo("DisplayHeight", value_str);
-  if (ret) {
-    ret = util::StrToInt(value_str, value);
+  std::optional<int> height = Snapshot()->DisplayHeight();
+  if (!height) {
+    return false;
   }
 
-  return ret;
+  value = *height;
+  return true;
 }
 
 void DeviceInfo::SetDisplayHeight(int value) {
-  if (!device_info_.emplace("DisplayHeight", std::to_string(value)).second) {
-    device_info_["DisplayHeight"] = std::to_string(value);
-  }
+  Update("DisplayHeight", std::to_string(value));
 }
 
 bool DeviceInfo::GetSystemLanguage(std::string& value) const {
@@ -59,25 +54,57 @@ bool DeviceInfo::GetSystemLanguage(std::string& value) const {
 }
 
 void DeviceInfo::SetSystemLanguage(const std::string& value) {
-  if (!device_info_.emplace("SystemLanguage", value).second) {
-    device_info_["SystemLanguage"] = value;
-  }
+  Update("SystemLanguage", value);
 }
 
 bool DeviceInfo::GetDeviceInfo(const std::string& name,
                                std::string& value) const {
-  auto info = device_info_.find(name);
-  if (info != device_info_.end()) {
-    value = info->second;
-    return true;
+  std::shared_ptr<const DeviceInfoSnapshot> snapshot = Snapshot();
+  if (!snapshot->Has(name)) {
+    return false;
   }
 
-  return false;
+  value = snapshot->Value(name);
+  return true;
 }
 
 void DeviceInfo::SetDeviceInfo(const std::string& name,
                                const std::string& value) {
-  if (!device_info_.emplace(name, value).second) {
-    device_info_[name] = value;
+  Update(name, value);
+}
+
+std::shared_ptr<const DeviceInfoSnapshot> DeviceInfo::Snapshot() const {
+  std::lock_guard<std::mutex> lock(snapshot_lock_);
+  return snapshot_;
+}
+
+void DeviceInfo::AddObserver(Observer* observer) {
+  observers_.AddObserver(observer);
+}
+
+void DeviceInfo::RemoveObserver(Observer* observer) {
+  observers_.RemoveObserver(observer);
+}
+
+void DeviceInfo::Update(const std::string& name, const std::string& value) {
+  std::shared_ptr<const DeviceInfoSnapshot> next;
+  DeviceInfoSnapshot::Fields changed = 0;
+  {
+    // Held from the read to the swap, so concurrent updates of different
+    // fields build on each other rather than drop one another.
+    std::lock_guard<std::mutex> lock(snapshot_lock_);
+    const DeviceInfoSnapshot& previous = *snapshot_;
+    if (previous.Has(name) && previous.Value(name) == value) {
+      return;
+    }
+
+    DeviceInfoSnapshot::ValueMap values = previous.Values();
+    values[name] = value;
+    next = DeviceInfoSnapshot::Create(std::move(values),
+                                      previous.Generation() + 1);
+    changed = next->Diff(previous);
+    snapshot_ = next;
   }
+
+  FOR_EACH_OBSERVER(Observer, observers_, DeviceInfoChanged(*next, changed));
 }
@@ -17,11 +17,24 @@
 #ifndef CORE_DEVICE_INFO_H_
 #define CORE_DEVICE_INFO_H_
 
+#include <memory>
+#include <mutex>
 #include <string>
-#include <unordered_map>
+
+#include "device_info_snapshot.h"
+#include "observer_list.h"
 
 class DeviceInfo {
  public:
+  class Observer {
+   public:
+    virtual ~Observer() = default;
+    // |changed| holds only the fields that differ from the previous snapshot.
+    virtual void DeviceInfoChanged(const DeviceInfoSnapshot& snapshot,
+                                   DeviceInfoSnapshot::Fields changed) = 0;
+  };
+
+  DeviceInfo();
   virtual ~DeviceInfo() = default;
 
   virtual void Initialize() {}
@@ -39,8 +52,18 @@ class DeviceInfo {
   virtual bool GetDeviceInfo(const std::string& name, std::string& value) const;
   virtual void SetDeviceInfo(const std::string& name, const std::string& value);
 
+  // The returned snapshot never changes; a new one replaces it on update.
+  std::shared_ptr<const DeviceInfoSnapshot> Snapshot() const;
+
+  void AddObserver(Observer* observer);
+  void RemoveObserver(Observer* observer);
+
  private:
-  std::unordered_map<std::string, std::string> device_info_;
+  void Update(const std::string& name, const std::string& value);
+
+  mutable std::mutex snapshot_lock_;
+  std::shared_ptr<const DeviceInfoSnapshot> snapshot_;
+  ObserverList<Observer> observers_;
 };
 
 #endif  // CORE_DEVICE_INFO_H_
@@ -0,0 +1,131 @@
+// Copyright (c) 2021 LG Electronics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#include "device_info_snapshot.h"
+
+#include <utility>
+
+#include "utils.h"
+
+namespace {
+
+struct FieldName {
+  const char* name;
+  DeviceInfoSnapshot::Field field;
+};
+
+constexpr FieldName kFieldNames[] = {
+    {"DisplayWidth", DeviceInfoSnapshot::kDisplayWidth},
+    {"DisplayHeight", DeviceInfoSnapshot::kDisplayHeight},
+    {"HardwareScreenWidth", DeviceInfoSnapshot::kHardwareScreenWidth},
+    {"HardwareScreenHeight", DeviceInfoSnapshot::kHardwareScreenHeight},
+    {"SystemLanguage", DeviceInfoSnapshot::kSystemLanguage},
+    {"LocalCountry", DeviceInfoSnapshot::kLocalCountry},
+    {"SmartServiceCountry", DeviceInfoSnapshot::kSmartServiceCountry},
+    {"CountryGroup", DeviceInfoSnapshot::kCountryGroup},
+    {"TvSystemName", DeviceInfoSnapshot::kTvSystemName},
+    {"TvDeviceInfo", DeviceInfoSnapshot::kTvDeviceInfo},
+    {"boardType", DeviceInfoSnapshot::kBoardType},
+    {"ScreenRotation", DeviceInfoSnapshot::kScreenRotation},
+};
+
+std::optional<int> ToInt(const DeviceInfoSnapshot::ValueMap& values,
+                         const char* name) {
+  auto found = values.find(name);
+  int value = 0;
+  if (found == values.end() || !util::StrToInt(found->second, value)) {
+    return std::nullopt;
+  }
+  return value;
+}
+
+std::string ToString(const DeviceInfoSnapshot::ValueMap& values,
+                     const char* name) {
+  auto found = values.find(name);
+  return found != values.end() ? found->second : std::string();
+}
+
+DeviceInfoSnapshot::ScreenRotation ToScreenRotation(const std::string& value) {
+  if (value == "90") {
+    return DeviceInfoSnapshot::ScreenRotation::k90;
+  }
+  if (value == "180") {
+    return DeviceInfoSnapshot::ScreenRotation::k180;
+  }
+  if (value == "270") {
+    return DeviceInfoSnapshot::ScreenRotation::k270;
+  }
+  return DeviceInfoSnapshot::ScreenRotation::kOff;
+}
+
+}  // namespace
+
+std::shared_ptr<const DeviceInfoSnapshot> DeviceInfoSnapshot::Create(
+    ValueMap values,
+    uint64_t generation) {
+  return std::shared_ptr<const DeviceInfoSnapshot>(
+      new DeviceInfoSnapshot(std::move(values), generation));
+}
+
+DeviceInfoSnapshot::DeviceInfoSnapshot(ValueMap values, uint64_t generation)
+    : values_(std::move(values)),
+      generation_(generation),
+      display_width_(ToInt(values_, "DisplayWidth")),
+      display_height_(ToInt(values_, "DisplayHeight")),
+      hardware_screen_width_(ToInt(values_, "HardwareScreenWidth")),
+      hardware_screen_height_(ToInt(values_, "HardwareScreenHeight")),
+      screen_rotation_(ToScreenRotation(ToString(values_, "ScreenRotation"))),
+      system_language_(ToString(values_, "SystemLanguage")),
+      local_country_(ToString(values_, "LocalCountry")),
+      smart_service_country_(ToString(values_, "SmartServiceCountry")),
+      country_group_(ToString(values_, "CountryGroup")),
+      tv_system_name_(ToString(values_, "TvSystemName")),
+      tv_device_info_(ToString(values_, "TvDeviceInfo")),
+      board_type_(ToString(values_, "boardType")) {}
+
+DeviceInfoSnapshot::Field DeviceInfoSnapshot::FieldFromName(
+    const std::string& name) {
+  for (const FieldName& entry : kFieldNames) {
+    if (name == entry.name) {
+      return entry.field;
+    }
+  }
+  return kOtherField;
+}
+
+DeviceInfoSnapshot::Fields DeviceInfoSnapshot::Diff(
+    const DeviceInfoSnapshot& other) const {
+  Fields changed = kNoField;
+
+  auto compare = [&](const ValueMap& from, const ValueMap& to) {
+    for (const auto& [name, value] : from) {
+      auto found = to.find(name);
+      if (found == to.end() || found->second != value) {
+        changed |= FieldFromName(name);
+      }
+    }
+  };
+  compare(values_, other.values_);
+  compare(other.values_, values_);
+
+  return changed;
+}
+
+const std::string& DeviceInfoSnapshot::Value(const std::string& name) const {
+  static const std::string kEmpty;
+  auto found = values_.find(name);
+  return found != values_.end() ? found->second : kEmpty;
+}
@@ -0,0 +1,116 @@
+// Copyright (c) 2021 LG Electronics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef CORE_DEVICE_INFO_SNAPSHOT_H_
+#define CORE_DEVICE_INFO_SNAPSHOT_H_
+
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string>
+#include <unordered_map>
+
+// Immutable, typed view of the device information. A new snapshot is built
+// whenever a value changes, so readers never convert strings on their own.
+class DeviceInfoSnapshot {
+ public:
+  enum class ScreenRotation { kOff, k90, k180, k270 };
+
+  enum Field : uint32_t {
+    kNoField = 0,
+    kDisplayWidth = 1u << 0,
+    kDisplayHeight = 1u << 1,
+    kHardwareScreenWidth = 1u << 2,
+    kHardwareScreenHeight = 1u << 3,
+    kSystemLanguage = 1u << 4,
+    kLocalCountry = 1u << 5,
+    kSmartServiceCountry = 1u << 6,
+    kCountryGroup = 1u << 7,
+    kTvSystemName = 1u << 8,
+    kTvDeviceInfo = 1u << 9,
+    kBoardType = 1u << 10,
+    kScreenRotation = 1u << 11,
+    // Any value that has no typed accessor.
+    kOtherField = 1u << 31,
+  };
+  // Bit mask of Field values.
+  using Fields = uint32_t;
+
+  using ValueMap = std::unordered_map<std::string, std::string>;
+
+  static std::shared_ptr<const DeviceInfoSnapshot> Create(ValueMap values,
+                                                          uint64_t generation);
+
+  DeviceInfoSnapshot(const DeviceInfoSnapshot&) = delete;
+  DeviceInfoSnapshot& operator=(const DeviceInfoSnapshot&) = delete;
+
+  // Returns the fields whose values differ between the two snapshots.
+  Fields Diff(const DeviceInfoSnapshot& other) const;
+  static Field FieldFromName(const std::string& name);
+
+  uint64_t Generation() const { return generation_; }
+
+  std::optional<int> DisplayWidth() const { return display_width_; }
+  std::optional<int> DisplayHeight() const { return display_height_; }
+  std::optional<int> HardwareScreenWidth() const {
+    return hardware_screen_width_;
+  }
+  std::optional<int> HardwareScreenHeight() const {
+    return hardware_screen_height_;
+  }
+  bool HasHardwareResolution() const {
+    return hardware_screen_width_.has_value() &&
+           hardware_screen_height_.has_value();
+  }
+  ScreenRotation Rotation() const { return screen_rotation_; }
+
+  const std::string& SystemLanguage() const { return system_language_; }
+  const std::string& LocalCountry() const { return local_country_; }
+  const std::string& SmartServiceCountry() const {
+    return smart_service_country_;
+  }
+  const std::string& CountryGroup() const { return country_group_; }
+  const std::string& TvSystemName() const { return tv_system_name_; }
+  const std::string& TvDeviceInfo() const { return tv_device_info_; }
+  const std::string& BoardType() const { return board_type_; }
+
+  bool Has(const std::string& name) const { return values_.contains(name); }
+  // Returns an empty string for unknown names.
+  const std::string& Value(const std::string& name) const;
+  const ValueMap& Values() const { return values_; }
+
+ private:
+  DeviceInfoSnapshot(ValueMap values, uint64_t generation);
+
+  const ValueMap values_;
+  const uint64_t generation_;
+
+  std::optional<int> display_width_;
+  std::optional<int> display_height_;
+  std::optional<int> hardware_screen_width_;
+  std::optional<int> hardware_screen_height_;
+  ScreenRotation screen_rotation_ = ScreenRotation::kOff;
+
+  std::string system_language_;
+  std::string local_country_;
+  std::string smart_service_country_;
+  std::string country_group_;
+  std::string tv_system_name_;
+  std::string tv_device_info_;
+  std::string board_type_;
+};
+
+#endif  // CORE_DEVICE_INFO_SNAPSHOT_H_
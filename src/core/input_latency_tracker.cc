@@ -0,0 +1,196 @@
+// Copyright (c) 2021 LG Electronics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+
+#include "input_latency_tracker.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+
+#include <json/value.h>
+
+namespace {
+
+int64_t SteadyClockUs() {
+  return std::chrono::duration_cast<std::chrono::microseconds>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+}  // namespace
+
+void InputLatencyTracker::Histogram::Add(int64_t latency_us) {
+  latency_us = std::max<int64_t>(latency_us, 0);
+  auto bound = std::lower_bound(kBucketBoundsUs.begin(), kBucketBoundsUs.end(),
+                                latency_us);
+  ++buckets[bound - kBucketBoundsUs.begin()];
+  ++count;
+  sum_us += latency_us;
+  max_us = std::max(max_us, latency_us);
+}
+
+int64_t InputLatencyTracker::Histogram::Percentile(double percentile) const {
+  if (!count) {
+    return 0;
+  }
+  const uint64_t rank = std::max<uint64_t>(
+      1, static_cast<uint64_t>(std::ceil(count * percentile / 100.0)));
+  uint64_t seen = 0;
+  for (size_t i = 0; i < kBucketBoundsUs.size(); ++i) {
+    seen += buckets[i];
+    if (seen >= rank) {
+      return std::min(kBucketBoundsUs[i], max_us);
+    }
+  }
+  return max_us;
+}
+
+InputLatencyTracker::InputLatencyTracker() : clock_(&SteadyClockUs) {}
+
+void InputLatencyTracker::SetEnabled(bool enabled) {
+  enabled_ = enabled;
+  if (!enabled_) {
+    windows_.clear();
+  }
+}
+
+void InputLatencyTracker::SetSampleInterval(uint32_t interval) {
+  sample_interval_ = std::max<uint32_t>(interval, 1);
+  sample_counter_ = 0;
+}
+
+void InputLatencyTracker::OnInput(const Atom& app,
+                                  const Atom& instance,
+                                  EventType type) {
+  if (!enabled_ || sample_counter_++ % sample_interval_) {
+    return;
+  }
+
+  Window& window = windows_[instance];
+  window.app = app;
+  if (window.events.size() >= kMaxPendingEvents) {
+    ++dropped_events_;
+    return;
+  }
+  window.events.push_back({type, clock_()});
+}
+
+void InputLatencyTracker::OnFrameSwapped(const Atom& instance) {
+  auto found = windows_.find(instance);
+  if (found == windows_.end() || found->second.events.empty()) {
+    return;
+  }
+
+  const std::string& app_id = found->second.app.String();
+  auto histograms = histograms_.find(app_id);
+  if (histograms == histograms_.end()) {
+    if (histograms_.size() >= kMaxTrackedApps) {
+      dropped_events_ += found->second.events.size();
+      found->second.events.clear();
+      return;
+    }
+    histograms = histograms_.try_emplace(app_id).first;
+  }
+
+  const int64_t now = clock_();
+  auto& app_histograms = histograms->second;
+  for (const PendingEvent& event : found->second.events) {
+    app_histograms[static_cast<size_t>(event.type)].Add(now - event.time_us);
+  }
+  found->second.events.clear();
+}
+
+void InputLatencyTracker::RemoveInstance(const Atom& instance) {
+  windows_.erase(instance);
+}
+
+void InputLatencyTracker::Reset() {
+  windows_.clear();
+  histograms_.clear();
+  sample_counter_ = 0;
+  dropped_events_ = 0;
+}
+
+const InputLatencyTracker::Histogram* InputLatencyTracker::Find(
+    const std::string& app_id,
+    EventType type) const {
+  auto found = histograms_.find(app_id);
+  if (found == histograms_.end()) {
+    return nullptr;
+  }
+  return &found->second[static_cast<size_t>(type)];
+}
+
+const char* InputLatencyTracker::EventTypeName(EventType type) {
+  switch (type) {
+    case EventType::kKey:
+      return "key";
+    case EventType::kMouseButton:
+      return "mouseButton";
+    case EventType::kMouseMove:
+      return "mouseMove";
+    case EventType::kWheel:
+      return "wheel";
+  }
+  return "";
+}
+
+Json::Value InputLatencyTracker::ToJson(const std::string& app_id) const {
+  Json::Value apps(Json::arrayValue);
+  for (const auto& [id, histograms] : histograms_) {
+    if (!app_id.empty() && id != app_id) {
+      continue;
+    }
+    Json::Value events(Json::objectValue);
+    for (size_t i = 0; i < kEventTypeCount; ++i) {
+      const Histogram& histogram = histograms[i];
+      if (!histogram.count) {
+        continue;
+      }
+      Json::Value buckets(Json::arrayValue);
+      for (uint64_t bucket : histogram.buckets) {
+        buckets.append(static_cast<Json::UInt64>(bucket));
+      }
+      Json::Value latency;
+      latency["count"] = static_cast<Json::UInt64>(histogram.count);
+      latency["meanUs"] =
+          static_cast<Json::Int64>(histogram.sum_us / histogram.count);
+      latency["p50Us"] = static_cast<Json::Int64>(histogram.Percentile(50));
+      latency["p95Us"] = static_cast<Json::Int64>(histogram.Percentile(95));
+      latency["maxUs"] = static_cast<Json::Int64>(histogram.max_us);
+      latency["buckets"] = std::move(buckets);
+      events[EventTypeName(static_cast<EventType>(i))] = std::move(latency);
+    }
+    Json::Value app;
+    app["id"] = id;
+    app["events"] = std::move(events);
+    apps.append(std::move(app));
+  }
+
+  Json::Value bounds(Json::arrayValue);
+  for (int64_t bound : kBucketBoundsUs) {
+    bounds.append(static_cast<Json::Int64>(bound));
+  }
+
+  Json::Value result;
+  result["enabled"] = enabled_;
+  result["sampleInterval"] = sample_interval_;
+  result["droppedEvents"] = static_cast<Json::UInt64>(dropped_events_);
+  result["bucketBoundsUs"] = std::move(bounds);
+  result["apps"] = std::move(apps);
+  return result;
+}
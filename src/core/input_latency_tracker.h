@@ -0,0 +1,120 @@
+// Copyright (c) 2021 LG Electronics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+
+#ifndef CORE_INPUT_LATENCY_TRACKER_H_
+#define CORE_INPUT_LATENCY_TRACKER_H_
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "atom.h"
+
+namespace Json {
+class Value;
+}
+
+// Measures the time from an input event reaching an app window to the next
+// compositor frame swap of its page. Latencies are kept as histograms per
+// app and event type. The tracker is off by default; when enabled, only one
+// event out of every |sample_interval| is timestamped.
+class InputLatencyTracker {
+ public:
+  enum class EventType {
+    kKey,
+    kMouseButton,
+    kMouseMove,
+    kWheel,
+    kLast = kWheel
+  };
+  static constexpr size_t kEventTypeCount =
+      static_cast<size_t>(EventType::kLast) + 1;
+
+  // Upper bounds of the histogram buckets in microseconds, the last bucket
+  // counts everything above.
+  static constexpr std::array<int64_t, 10> kBucketBoundsUs = {
+      1000,  2000,  4000,   8000,   16000,
+      32000, 64000, 128000, 256000, 512000};
+  static constexpr size_t kBucketCount = kBucketBoundsUs.size() + 1;
+
+  // Events waiting for a swap are bounded per window, the older ones are
+  // kept as they see the longest latency.
+  static constexpr size_t kMaxPendingEvents = 32;
+  static constexpr size_t kMaxTrackedApps = 64;
+
+  struct Histogram {
+    uint64_t count = 0;
+    int64_t sum_us = 0;
+    int64_t max_us = 0;
+    std::array<uint64_t, kBucketCount> buckets{};
+
+    void Add(int64_t latency_us);
+    // Upper bound of the bucket holding the |percentile|th sample.
+    int64_t Percentile(double percentile) const;
+  };
+
+  using Clock = int64_t (*)();
+
+  InputLatencyTracker();
+
+  InputLatencyTracker(const InputLatencyTracker&) = delete;
+  InputLatencyTracker& operator=(const InputLatencyTracker&) = delete;
+
+  void SetEnabled(bool enabled);
+  bool IsEnabled() const { return enabled_; }
+  void SetSampleInterval(uint32_t interval);
+  uint32_t SampleInterval() const { return sample_interval_; }
+  void SetClockForTesting(Clock clock) { clock_ = clock; }
+
+  // Timestamps an event arriving at the window of |instance|.
+  void OnInput(const Atom& app, const Atom& instance, EventType type);
+  // Resolves the events of |instance| waiting for this swap.
+  void OnFrameSwapped(const Atom& instance);
+  void RemoveInstance(const Atom& instance);
+  void Reset();
+
+  const Histogram* Find(const std::string& app_id, EventType type) const;
+  uint64_t DroppedEvents() const { return dropped_events_; }
+
+  Json::Value ToJson(const std::string& app_id = {}) const;
+
+  static const char* EventTypeName(EventType type);
+
+ private:
+  struct PendingEvent {
+    EventType type;
+    int64_t time_us;
+  };
+
+  struct Window {
+    Atom app;
+    std::vector<PendingEvent> events;
+  };
+
+  bool enabled_ = false;
+  uint32_t sample_interval_ = 1;
+  uint64_t sample_counter_ = 0;
+  uint64_t dropped_events_ = 0;
+  Clock clock_;
+  AtomMap<Window> windows_;
+  std::map<std::string, std::array<Histogram, kEventTypeCount>> histograms_;
+};
+
+#endif  // CORE_INPUT_LATENCY_TRACKER_H_
@@ -18,6 +18,7 @@
 
 #include <json/json.h>
 
+#include "device_info_snapshot.h"
 #include "utils.h"
 #include "web_app_manager.h"
 
@@ -28,25 +29,24 @@ std::string PalmSystemBase::GetDeviceInfo(const std::string& name) const {
   return value;
 }
 
-std::string PalmSystemBase::Country() const {
-  std::string local_country;
-  std::string smart_service_country;
+std::shared_ptr<const DeviceInfoSnapshot>
+PalmSystemBase::GetDeviceInfoSnapshot() const {
+  return WebAppManager::Instance()->GetDeviceInfoSnapshot();
+}
 
-  WebAppManager::Instance()->GetDeviceInfo("LocalCountry", local_country);
-  WebAppManager::Instance()->GetDeviceInfo("SmartServiceCountry",
-                                           smart_service_country);
+std::string PalmSystemBase::Country() const {
+  std::shared_ptr<const DeviceInfoSnapshot> device_info =
+      GetDeviceInfoSnapshot();
 
   Json::Value obj(Json::objectValue);
-  obj["country"] = local_country;
-  obj["smartServiceCountry"] = smart_service_country;
+  obj["country"] = device_info->LocalCountry();
+  obj["smartServiceCountry"] = device_info->SmartServiceCountry();
   std::string country = util::JsonToString(obj);
   return country;
 }
 
 std::string PalmSystemBase::Locale() const {
-  std::string system_locale;
-  WebAppManager::Instance()->GetSystemLanguage(system_locale);
-  return system_locale;
+  return GetDeviceInfoSnapshot()->SystemLanguage();
 }
 
 std::string PalmSystemBase::LocaleRegion() const {
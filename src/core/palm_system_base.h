@@ -17,8 +17,11 @@
 #ifndef CORE_PALM_SYSTEM_BASE_H_
 #define CORE_PALM_SYSTEM_BASE_H_
 
+#include <memory>
 #include <string>
 
+class DeviceInfoSnapshot;
+
 class PalmSystemBase {
  public:
   PalmSystemBase() = default;
@@ -26,6 +29,7 @@ class PalmSystemBase {
 
  protected:
   virtual std::string GetDeviceInfo(const std::string& name) const;
+  std::shared_ptr<const DeviceInfoSnapshot> GetDeviceInfoSnapshot() const;
   virtual std::string Country() const;
   virtual std::string Locale() const;
   virtual std::string LocaleRegion() const;
@@ -33,6 +33,8 @@ class ServiceSender {
                            const std::string& payload,
                            const std::string& app_id) = 0;
   virtual void CloseApp(const std::string& id) = 0;
+  // An app was launched or removed, or its web process changed.
+  virtual void RunningAppsChanged() = 0;
 };
 
 #endif  // CORE_SERVICE_SENDER_H_
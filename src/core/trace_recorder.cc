@@ -0,0 +1,209 @@
+// Copyright (c) 2021 LG Electronics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+
+#include "trace_recorder.h"
+
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <chrono>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace {
+
+// Slots are overwritten while WriteJson reads them: a thread that already
+// passed the IsEnabled() check finishes its event, and the rings of other
+// threads wrap around. Every slot is therefore guarded by a sequence number,
+// odd while the slot is written and 2 * (index + 1) once event |index| is
+// complete, and the reader skips slots whose sequence changed meanwhile.
+struct Event {
+  std::atomic<uint64_t> sequence{0};
+  std::atomic<const char*> name{nullptr};
+  std::atomic<const char*> category{nullptr};
+  std::atomic<int64_t> timestamp_us{0};
+  std::atomic<int64_t> value{0};
+  std::atomic<char> phase{0};
+};
+
+struct EventCopy {
+  const char* name;
+  const char* category;
+  int64_t timestamp_us;
+  int64_t value;
+  char phase;
+};
+
+// Copies event |index| out of |event|, fails if the slot holds another
+// event or was written during the copy.
+bool ReadEvent(const Event& event, uint64_t index, EventCopy* copy) {
+  const uint64_t sequence = 2 * (index + 1);
+  if (event.sequence.load(std::memory_order_acquire) != sequence) {
+    return false;
+  }
+  copy->name = event.name.load(std::memory_order_relaxed);
+  copy->category = event.category.load(std::memory_order_relaxed);
+  copy->timestamp_us = event.timestamp_us.load(std::memory_order_relaxed);
+  copy->value = event.value.load(std::memory_order_relaxed);
+  copy->phase = event.phase.load(std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_acquire);
+  return event.sequence.load(std::memory_order_relaxed) == sequence;
+}
+
+struct ThreadRing {
+  pid_t tid = 0;
+  std::unique_ptr<Event[]> events;
+  // Number of events ever recorded, only written by the owning thread.
+  std::atomic<uint64_t> count{0};
+};
+
+std::mutex rings_mutex;
+// Rings outlive their threads, so the events of finished threads are kept.
+std::vector<std::unique_ptr<ThreadRing>>& Rings() {
+  static auto* rings = new std::vector<std::unique_ptr<ThreadRing>>();
+  return *rings;
+}
+
+thread_local ThreadRing* thread_ring = nullptr;
+
+ThreadRing* CurrentRing() {
+  if (!thread_ring) {
+    auto ring = std::make_unique<ThreadRing>();
+    ring->tid = static_cast<pid_t>(syscall(SYS_gettid));
+    ring->events =
+        std::make_unique<Event[]>(TraceRecorder::kEventsPerThread);
+    thread_ring = ring.get();
+    std::lock_guard<std::mutex> lock(rings_mutex);
+    Rings().push_back(std::move(ring));
+  }
+  return thread_ring;
+}
+
+int64_t NowUs() {
+  return std::chrono::duration_cast<std::chrono::microseconds>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+void WriteEscaped(std::ostream& out, const char* str) {
+  out << '"';
+  for (const char* c = str ? str : ""; *c; ++c) {
+    switch (*c) {
+      case '"':
+        out << "\\\"";
+        break;
+      case '\\':
+        out << "\\\\";
+        break;
+      default:
+        if (static_cast<unsigned char>(*c) < 0x20) {
+          out << ' ';
+        } else {
+          out << *c;
+        }
+    }
+  }
+  out << '"';
+}
+
+}  // namespace
+
+void TraceRecorder::SetEnabled(bool enabled) {
+  if (enabled) {
+    CurrentRing();
+  }
+  enabled_.store(enabled, std::memory_order_relaxed);
+}
+
+void TraceRecorder::Clear() {
+  std::lock_guard<std::mutex> lock(rings_mutex);
+  for (auto& ring : Rings()) {
+    ring->count.store(0, std::memory_order_relaxed);
+  }
+}
+
+void TraceRecorder::Record(char phase,
+                           const char* name,
+                           const char* category,
+                           int64_t value) {
+  ThreadRing* ring = CurrentRing();
+  const uint64_t count = ring->count.load(std::memory_order_relaxed);
+  Event& event = ring->events[count % kEventsPerThread];
+  event.sequence.store(2 * count + 1, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_release);
+  event.name.store(name, std::memory_order_relaxed);
+  event.category.store(category, std::memory_order_relaxed);
+  event.timestamp_us.store(NowUs(), std::memory_order_relaxed);
+  event.value.store(value, std::memory_order_relaxed);
+  event.phase.store(phase, std::memory_order_relaxed);
+  event.sequence.store(2 * (count + 1), std::memory_order_release);
+  ring->count.store(count + 1, std::memory_order_release);
+}
+
+size_t TraceRecorder::WriteJson(std::ostream& out) {
+  const bool was_enabled = enabled_.exchange(false);
+  const pid_t pid = getpid();
+  size_t written = 0;
+
+  out << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+  {
+    std::lock_guard<std::mutex> lock(rings_mutex);
+    for (const auto& ring : Rings()) {
+      const uint64_t count = ring->count.load(std::memory_order_acquire);
+      const uint64_t first =
+          count > kEventsPerThread ? count - kEventsPerThread : 0;
+      for (uint64_t i = first; i < count; ++i) {
+        EventCopy event;
+        if (!ReadEvent(ring->events[i % kEventsPerThread], i, &event)) {
+          continue;
+        }
+        out << (written++ ? ",\n" : "\n") << "{\"name\":";
+        WriteEscaped(out, event.name);
+        if (event.category) {
+          out << ",\"cat\":";
+          WriteEscaped(out, event.category);
+        }
+        out << ",\"ph\":\"" << event.phase << "\",\"ts\":" << event.timestamp_us
+            << ",\"pid\":" << pid << ",\"tid\":" << ring->tid;
+        if (event.phase == 'C') {
+          out << ",\"args\":{\"value\":" << event.value << '}';
+        } else if (event.phase == 'i') {
+          out << ",\"s\":\"t\"";
+        }
+        out << '}';
+      }
+    }
+  }
+  out << "\n]}\n";
+
+  enabled_.store(was_enabled);
+  return written;
+}
+
+bool TraceRecorder::WriteJsonFile(const std::string& path, size_t* events) {
+  std::ofstream out(path, std::ios::trunc);
+  if (!out.is_open()) {
+    return false;
+  }
+  size_t written = WriteJson(out);
+  if (events) {
+    *events = written;
+  }
+  return out.good();
+}
@@ -0,0 +1,98 @@
+// Copyright (c) 2021 LG Electronics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+
+#ifndef CORE_TRACE_RECORDER_H_
+#define CORE_TRACE_RECORDER_H_
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <string>
+
+// Built-in backend of the PMTRACE macros, usable without LTTng. Every
+// thread records begin, end, instant and counter events into its own ring,
+// which keeps the latest kEventsPerThread events. Names and categories are
+// stored as pointers, so they must be string literals. The rings are
+// written out in the Chrome trace event format, for chrome://tracing or
+// Perfetto. A disabled recorder costs one branch per event.
+class TraceRecorder {
+ public:
+  static constexpr size_t kEventsPerThread = 16384;
+
+  static bool IsEnabled() {
+    return enabled_.load(std::memory_order_relaxed);
+  }
+  // Enabling allocates the ring of the calling thread, other threads
+  // allocate theirs with their first event.
+  static void SetEnabled(bool enabled);
+  // Drops every recorded event.
+  static void Clear();
+
+  static void Begin(const char* name, const char* category = nullptr) {
+    if (IsEnabled()) {
+      Record('B', name, category, 0);
+    }
+  }
+  static void End(const char* name, const char* category = nullptr) {
+    if (IsEnabled()) {
+      Record('E', name, category, 0);
+    }
+  }
+  static void Instant(const char* name, const char* category = nullptr) {
+    if (IsEnabled()) {
+      Record('i', name, category, 0);
+    }
+  }
+  static void Counter(const char* name, int64_t value) {
+    if (IsEnabled()) {
+      Record('C', name, nullptr, value);
+    }
+  }
+
+  // Writes the recorded events as trace event JSON and returns their
+  // number. Recording is paused meanwhile, events that are still being
+  // written are left out.
+  static size_t WriteJson(std::ostream& out);
+  static bool WriteJsonFile(const std::string& path, size_t* events = nullptr);
+
+ private:
+  static void Record(char phase,
+                     const char* name,
+                     const char* category,
+                     int64_t value);
+
+  static inline std::atomic<bool> enabled_{false};
+};
+
+class TraceScope {
+ public:
+  explicit TraceScope(const char* name, const char* category = nullptr)
+      : name_(name), category_(category) {
+    TraceRecorder::Begin(name_, category_);
+  }
+  ~TraceScope() { TraceRecorder::End(name_, category_); }
+
+  TraceScope(const TraceScope&) = delete;
+  TraceScope& operator=(const TraceScope&) = delete;
+
+ private:
+  const char* name_;
+  const char* category_;
+};
+
+#endif  // CORE_TRACE_RECORDER_H_
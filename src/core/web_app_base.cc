@@ -45,6 +45,8 @@ class WebAppBasePrivate {
   std::string app_id_;
   std::string instance_id_;
   std::string url_;
+  Atom app_atom_;
+  Atom instance_atom_;
 };
 
 WebAppBase::WebAppBase()
@@ -99,29 +101,39 @@ bool WebAppBase::IsWindowed() const {
 
 void WebAppBase::SetAppId(const std::string& app_id) {
   app_private_->app_id_ = app_id;
+  app_private_->app_atom_ = Atom(app_id);
 }
 
 void WebAppBase::SetLaunchingAppId(const std::string& app_id) {
   app_private_->launching_app_id_ = app_id;
 }
 
-std::string WebAppBase::AppId() const {
+const std::string& WebAppBase::AppId() const {
   return app_private_->app_id_;
 }
 
 void WebAppBase::SetInstanceId(const std::string& instance_id) {
   app_private_->instance_id_ = instance_id;
+  app_private_->instance_atom_ = Atom(instance_id);
 }
 
-std::string WebAppBase::InstanceId() const {
+const std::string& WebAppBase::InstanceId() const {
   return app_private_->instance_id_;
 }
 
-std::string WebAppBase::Url() const {
+const Atom& WebAppBase::AppAtom() const {
+  return app_private_->app_atom_;
+}
+
+const Atom& WebAppBase::InstanceAtom() const {
+  return app_private_->instance_atom_;
+}
+
+const std::string& WebAppBase::Url() const {
   return app_private_->url_;
 }
 
-std::string WebAppBase::LaunchingAppId() const {
+const std::string& WebAppBase::LaunchingAppId() const {
   return app_private_->launching_app_id_;
 }
 
@@ -289,7 +301,7 @@ void WebAppBase::SetAppDescription(
   app_private_->app_desc_ = std::move(app_desc);
 
   // set appId here from appDesc
-  app_private_->app_id_ = GetAppDescription()->Id();
+  SetAppId(GetAppDescription()->Id());
 }
 
 void WebAppBase::SetAppProperties(const std::string& properties) {
@@ -397,14 +409,51 @@ void WebAppBase::SetPreferredLanguages(const std::string& language) {
   app_private_->page_->SendLocaleChangeEvent(language);
 }
 
-void WebAppBase::HandleWebAppMessage(WebAppManager::WebAppMessageType type,
-                                     const std::string& message) {
-  if (!app_private_->page_) {
+void WebAppBase::SettingsChanged(WebPageBase::Settings settings,
+                                 DeviceInfoSnapshot::Fields device_info) {
+  WebPageBase* page = app_private_->page_;
+  if (!page) {
+    return;
+  }
+
+  page->AddPendingSettings(settings, device_info);
+  if (page->IsSuspended() || page->IsPreload() || GetHiddenWindow()) {
+    LOG_DEBUG("[%s] settings change deferred until the page is shown",
+              AppId().c_str());
+    return;
+  }
+
+  UpdateSettings();
+}
+
+void WebAppBase::UpdateSettings() {
+  WebPageBase* page = app_private_->page_;
+  WebAppManager* manager = WebAppManager::Instance();
+  if (!page || page->SettingsGeneration() == manager->SettingsGeneration()) {
     return;
   }
 
-  if (type == WebAppManager::WebAppMessageType::kDeviceInfoChanged) {
-    app_private_->page_->HandleDeviceInfoChanged(message);
+  // However many changes happened meanwhile, the page is updated only once
+  // with the current values.
+  WebPageBase::PendingSettings pending =
+      page->TakePendingSettings(manager->SettingsGeneration());
+
+  if (pending.settings & WebPageBase::kLanguageSetting) {
+    std::string language;
+    manager->GetSystemLanguage(language);
+    SetPreferredLanguages(language);
+  }
+
+  if (pending.settings & WebPageBase::kAccessibilitySetting) {
+    bool enabled = manager->IsAccessibilityEnabled();
+    // set audio guidance on/off on settings app
+    page->SetAudioGuidanceOn(enabled);
+    SetUseAccessibility(enabled);
+  }
+
+  if (pending.device_info != DeviceInfoSnapshot::kNoField) {
+    page->HandleDeviceInfoChanged(*manager->GetDeviceInfoSnapshot(),
+                                  pending.device_info);
   }
 }
 
@@ -20,6 +20,7 @@
 #include <memory>
 #include <string>
 
+#include "atom.h"
 #include "web_app_manager.h"
 #include "web_page_observer.h"
 
@@ -96,15 +97,22 @@ class WebAppBase : public WebPageObserver {
   void SetForceClose();
   bool ForceClose();
   WebPageBase* Page() const;
-  void HandleWebAppMessage(WebAppManager::WebAppMessageType type,
-                           const std::string& message);
+  // Applies the changed system settings right away if the page is visible.
+  // Hidden and suspended pages only remember the change and catch up in
+  // UpdateSettings() once they are activated again.
+  void SettingsChanged(WebPageBase::Settings settings,
+                       DeviceInfoSnapshot::Fields device_info);
+  void UpdateSettings();
   void SetAppId(const std::string& app_id);
   void SetLaunchingAppId(const std::string& app_id);
-  std::string AppId() const;
-  std::string LaunchingAppId() const;
+  const std::string& AppId() const;
+  const std::string& LaunchingAppId() const;
   void SetInstanceId(const std::string& instance_id);
-  std::string InstanceId() const;
-  std::string Url() const;
+  const std::string& InstanceId() const;
+  // Interned AppId() and InstanceId(), for lookups and maps.
+  const Atom& AppAtom() const;
+  const Atom& InstanceAtom() const;
+  const std::string& Url() const;
 
   ApplicationDescription* GetAppDescription() const;
 
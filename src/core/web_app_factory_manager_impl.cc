@@ -24,6 +24,7 @@
 
 #include "log_manager.h"
 #include "plugin_loader.h"
+#include "startup_profiler.h"
 #include "util/url.h"
 #include "web_app_base.h"
 #include "web_app_manager.h"
@@ -141,6 +142,8 @@ WebAppFactoryInterface* WebAppFactoryManagerImpl::LoadPluggable(
     return nullptr;
   }
 
+  StartupProfiler::Scope scope("LoadPluggable");
+
   WebAppFactoryInterface* interface;
   for (const auto& file : GetFileList(web_app_factory_plugin_path_)) {
     if (!plugin_loader_->Load(file)) {
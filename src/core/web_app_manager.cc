@@ -27,17 +27,25 @@
 #include "webos/application_installation_handler.h"
 #include "webos/public/runtime.h"
 
+#include "app_memory_accounting.h"
 #include "application_description.h"
 #include "device_info.h"
+#include "error_page_resolver.h"
+#include "file_content_cache.h"
+#include "input_latency_tracker.h"
 #include "log_manager.h"
+#include "main_loop_watchdog.h"
+#include "metrics_registry.h"
 #include "network_status_manager.h"
 #include "platform_module_factory.h"
 #include "service_sender.h"
+#include "startup_profiler.h"
 #include "util/url.h"
 #include "utils.h"
 #include "web_app_base.h"
 #include "web_app_factory_manager_impl.h"
 #include "web_app_manager_config.h"
+#include "web_app_manager_metrics.h"
 #include "web_app_manager_service.h"
 #include "web_app_manager_tracer.h"
 #include "web_page_base.h"
@@ -53,9 +61,17 @@ WebAppManager* WebAppManager::Instance() {
 }
 
 WebAppManager::WebAppManager()
-    : network_status_manager_(std::make_unique<NetworkStatusManager>()) {}
+    : network_status_manager_(std::make_unique<NetworkStatusManager>()),
+      app_memory_accounting_(std::make_unique<AppMemoryAccounting>()),
+      input_latency_tracker_(std::make_unique<InputLatencyTracker>()),
+      user_script_cache_(std::make_unique<FileContentCache>()),
+      error_page_resolver_(std::make_unique<ErrorPageResolver>()) {
+  metrics_collector_id_ = MetricsRegistry::Instance().AddCollector(
+      [this] { UpdateAppStateMetrics(); });
+}
 
 WebAppManager::~WebAppManager() {
+  MetricsRegistry::Instance().RemoveCollector(metrics_collector_id_);
   if (device_info_) {
     device_info_->Terminate();
   }
@@ -64,6 +80,26 @@ WebAppManager::~WebAppManager() {
 void WebAppManager::NotifyMemoryPressure(
     webos::WebViewBase::MemoryPressureLevel level) {
   std::list<const WebAppBase*> app_list = RunningApps();
+  if (level != webos::WebViewBase::MEMORY_PRESSURE_NONE) {
+    // Let the apps that cost the most start reclaiming first
+    UpdateAppMemoryUsage();
+    app_list.sort([this](const WebAppBase* a, const WebAppBase* b) {
+      return app_memory_accounting_->AttributedPss(a->InstanceId()) >
+             app_memory_accounting_->AttributedPss(b->InstanceId());
+    });
+
+    const auto& usages = app_memory_accounting_->Usages();
+    if (!usages.empty()) {
+      LOG_INFO(MSGID_NOTIFY_MEMORY_STATE, 4,
+               PMLOGKS("APP_ID", usages.front().app_id.c_str()),
+               PMLOGKS("INSTANCE_ID", usages.front().instance_id.c_str()),
+               PMLOGKFV("PID", "%u", usages.front().pid),
+               PMLOGKFV("PSS", "%llu",
+                        static_cast<unsigned long long>(usages.front().pss_kb)),
+               "Largest memory consumer");
+    }
+  }
+
   for (const WebAppBase* app : app_list) {
     // Skip memory pressure handling on preloaded apps if chromium pressure is
     // critical (when system is on low or critical) because they will be killed
@@ -84,17 +120,17 @@ void WebAppManager::NotifyMemoryPressure(
 
 void WebAppManager::SetPlatformModules(
     std::unique_ptr<PlatformModuleFactory> factory) {
+  StartupProfiler::Scope scope("SetPlatformModules");
   web_app_manager_config_ = factory->GetWebAppManagerConfig();
   service_sender_ = factory->GetServiceSender();
   web_process_manager_ = factory->GetWebProcessManager();
   device_info_ = factory->GetDeviceInfo();
+  device_info_->AddObserver(this);
+  // The locale follows the language from DeviceInfoChanged(), also when
+  // the initial one is read later on the file I/O thread.
   device_info_->Initialize();
 
   LoadEnvironmentVariable();
-  std::string lang;
-  if (device_info_->GetSystemLanguage(lang)) {
-    webos::Runtime::GetInstance()->SetLocale(lang);
-  }
 }
 
 void WebAppManager::SetWebAppFactory(
@@ -119,6 +155,18 @@ void WebAppManager::LoadEnvironmentVariable() {
   max_custom_suspend_delay_ =
       web_app_manager_config_->GetMaxCustomSuspendDelayTime();
   web_app_manager_config_->PostInitConfiguration();
+
+  const int stall_threshold_ms =
+      web_app_manager_config_->GetMainLoopStallThresholdMs();
+  if (stall_threshold_ms > 0 && !main_loop_watchdog_) {
+    MainLoopWatchdog::Options options;
+    options.threshold_ms = stall_threshold_ms;
+    options.interval_ms = std::min(options.interval_ms, stall_threshold_ms);
+    options.capture_backtrace =
+        web_app_manager_config_->IsMainLoopStallBacktraceEnabled();
+    main_loop_watchdog_ = std::make_unique<MainLoopWatchdog>();
+    main_loop_watchdog_->Start(options);
+  }
 }
 
 void WebAppManager::SetUiSize(int width, int height) {
@@ -158,6 +206,16 @@ bool WebAppManager::GetDeviceInfo(const std::string& name, std::string& value) {
   return device_info_->GetDeviceInfo(name, value);
 }
 
+std::shared_ptr<const DeviceInfoSnapshot>
+WebAppManager::GetDeviceInfoSnapshot() {
+  if (!device_info_) {
+    static const std::shared_ptr<const DeviceInfoSnapshot> kEmpty =
+        DeviceInfoSnapshot::Create({}, 0);
+    return kEmpty;
+  }
+  return device_info_->Snapshot();
+}
+
 void WebAppManager::OnRelaunchApp(const std::string& instance_id,
                                   const std::string& app_id,
                                   const std::string& args,
@@ -335,6 +393,10 @@ WebAppBase* WebAppManager::OnLaunchUrl(
   WebPageAdded(page);
 
   app_list_.push_back(app);
+  WebAppManagerMetrics::AppLaunches().WithLabel(app->AppId()).Increment();
+  if (service_sender_) {
+    service_sender_->RunningAppsChanged();
+  }
 
   if (app_version_.contains(app->GetAppDescription()->Id())) {
     if (app_version_[app->GetAppDescription()->Id()] !=
@@ -361,8 +423,8 @@ void WebAppManager::ForceCloseAppInternal(WebAppBase* app) {
 }
 
 void WebAppManager::RemoveClosingAppList(const std::string& instance_id) {
-  while (closing_app_list_.contains(instance_id)) {
-    closing_app_list_.erase(instance_id);
+  if (auto atom = Atom::Find(instance_id)) {
+    closing_app_list_.erase(*atom);
   }
 }
 
@@ -385,11 +447,12 @@ void WebAppManager::CloseAppInternal(WebAppBase* app,
     return;
   }
 
+  WebAppManagerMetrics::AppCloses().WithLabel(app->AppId()).Increment();
   std::string type = app->GetAppDescription()->DefaultWindowType();
   AppDeleted(app);
   WebPageRemoved(app->Page());
   PostRunningAppList();
-  last_crashed_app_ids_ = std::unordered_map<std::string, int>();
+  last_crashed_app_ids_.clear();
 
   // Set m_isClosing flag first, this flag will be checked in web page
   // suspending
@@ -405,7 +468,7 @@ void WebAppManager::CloseAppInternal(WebAppBase* app,
   if (ignore_clean_resource) {
     delete app;
   } else {
-    closing_app_list_.emplace(app->InstanceId(), app);
+    closing_app_list_.emplace(app->InstanceAtom(), app);
 
     if (page->IsRegisteredCloseCallback()) {
       LOG_INFO(MSGID_CLOSE_APP_INTERNAL, 3,
@@ -447,15 +510,13 @@ bool WebAppManager::CloseAllApps(uint32_t pid) {
 }
 
 void WebAppManager::WebPageAdded(WebPageBase* page) {
-  std::string app_id = page->AppId();
-
-  auto found = find_if(app_page_map_.begin(), app_page_map_.end(),
-                       [&](const auto& item) {
-                         return (item.first == app_id) && (item.second == page);
-                       });
+  auto range = app_page_map_.equal_range(page->AppAtom());
+  auto found = std::find_if(range.first, range.second, [&](const auto& item) {
+    return item.second == page;
+  });
 
-  if (found == app_page_map_.end()) {
-    app_page_map_.emplace(app_id, page);
+  if (found == range.second) {
+    app_page_map_.emplace(page->AppAtom(), page);
   }
 }
 
@@ -469,7 +530,7 @@ void WebAppManager::WebPageRemoved(WebPageBase* page) {
     }
   }
 
-  auto range = app_page_map_.equal_range(page->AppId());
+  auto range = app_page_map_.equal_range(page->AppAtom());
   auto it = range.first;
   while (it != range.second) {
     if (it->second == page) {
@@ -481,8 +542,14 @@ void WebAppManager::WebPageRemoved(WebPageBase* page) {
 }
 
 WebAppBase* WebAppManager::FindAppById(const std::string& app_id) {
+  // Ids nobody interned can't belong to a running app.
+  auto atom = Atom::Find(app_id);
+  if (!atom) {
+    return nullptr;
+  }
+
   for (WebAppBase* app : app_list_) {
-    if (app->Page() && app->AppId() == app_id) {
+    if (app->Page() && app->AppAtom() == *atom) {
       return app;
     }
   }
@@ -492,8 +559,13 @@ WebAppBase* WebAppManager::FindAppById(const std::string& app_id) {
 
 std::list<WebAppBase*> WebAppManager::FindAppsById(const std::string& app_id) {
   std::list<WebAppBase*> apps;
+  auto atom = Atom::Find(app_id);
+  if (!atom) {
+    return apps;
+  }
+
   for (WebAppBase* app : app_list_) {
-    if (app->Page() && app->AppId() == app_id) {
+    if (app->Page() && app->AppAtom() == *atom) {
       apps.push_back(app);
     }
   }
@@ -502,8 +574,13 @@ std::list<WebAppBase*> WebAppManager::FindAppsById(const std::string& app_id) {
 }
 
 WebAppBase* WebAppManager::FindAppByInstanceId(const std::string& instance_id) {
+  auto atom = Atom::Find(instance_id);
+  if (!atom) {
+    return nullptr;
+  }
+
   for (WebAppBase* app : app_list_) {
-    if (app->Page() && (app->InstanceId() == instance_id)) {
+    if (app->Page() && (app->InstanceAtom() == *atom)) {
       return app;
     }
   }
@@ -517,6 +594,10 @@ void WebAppManager::AppDeleted(WebAppBase* app) {
   }
 
   app_list_.remove(app);
+  input_latency_tracker_->RemoveInstance(app->InstanceAtom());
+  if (service_sender_) {
+    service_sender_->RunningAppsChanged();
+  }
 }
 
 void WebAppManager::SetSystemLanguage(const std::string& language) {
@@ -524,14 +605,10 @@ void WebAppManager::SetSystemLanguage(const std::string& language) {
     return;
   }
 
+  // The locale and the pages are updated from DeviceInfoChanged() if the
+  // language differs.
   device_info_->SetSystemLanguage(language);
 
-  webos::Runtime::GetInstance()->SetLocale(language);
-
-  for (WebAppBase* app : app_list_) {
-    app->SetPreferredLanguages(language);
-  }
-
   LOG_DEBUG("New system language: %s", language.c_str());
 }
 
@@ -547,15 +624,26 @@ void WebAppManager::SetDeviceInfo(const std::string& name,
   }
 
   device_info_->SetDeviceInfo(name, value);
-  BroadcastWebAppMessage(WebAppMessageType::kDeviceInfoChanged, name);
   LOG_DEBUG("SetDeviceInfo %s; %s to %s", name.c_str(), old_value.c_str(),
             value.c_str());
 }
 
-void WebAppManager::BroadcastWebAppMessage(WebAppMessageType type,
-                                           const std::string& message) {
+void WebAppManager::DeviceInfoChanged(const DeviceInfoSnapshot& snapshot,
+                                      DeviceInfoSnapshot::Fields changed) {
+  WebPageBase::Settings settings = WebPageBase::kNoSetting;
+  if (changed & DeviceInfoSnapshot::kSystemLanguage) {
+    webos::Runtime::GetInstance()->SetLocale(snapshot.SystemLanguage());
+    settings |= WebPageBase::kLanguageSetting;
+    error_page_resolver_->Clear();
+  }
+  SettingsChanged(settings, changed);
+}
+
+void WebAppManager::SettingsChanged(WebPageBase::Settings settings,
+                                    DeviceInfoSnapshot::Fields device_info) {
+  ++settings_generation_;
   for (WebAppBase* app : app_list_) {
-    app->HandleWebAppMessage(type, message);
+    app->SettingsChanged(settings, device_info);
   }
 }
 
@@ -565,24 +653,26 @@ bool WebAppManager::ProcessCrashed(const std::string& app_id,
   if (!app) {
     return false;
   }
+  WebAppManagerMetrics::AppCrashes().WithLabel(app->AppId()).Increment();
 
   if (app->IsWindowed()) {
     if (app->IsActivated()) {
-      last_crashed_app_ids_[app->AppId()]++;
+      last_crashed_app_ids_[app->AppAtom()]++;
       int reloading_limit = app->IsNormal() ? kContinuousReloadingLimit - 1
                                             : kContinuousReloadingLimit;
 
-      if (last_crashed_app_ids_[app->AppId()] >= reloading_limit) {
+      if (last_crashed_app_ids_[app->AppAtom()] >= reloading_limit) {
         LOG_INFO(MSGID_WEBPROC_CRASH, 4, PMLOGKS("APP_ID", app_id.c_str()),
                  PMLOGKS("INSTANCE_ID", instance_id.c_str()),
                  PMLOGKS("InForeground", "true"),
                  PMLOGKS("Reloading limit", "Close app"), "");
         CloseAppInternal(app, true);
       } else {
-        LOG_INFO(MSGID_WEBPROC_CRASH, 4, PMLOGKS("APP_ID", app_id.c_str()),
-                 PMLOGKS("INSTANCE_ID", instance_id.c_str()),
-                 PMLOGKS("InForeground", "true"),
-                 PMLOGKS("Reloading limit", "OK; Reload default page"), "");
+        LOG_INFO_RATE_LIMITED(
+            1, 5, MSGID_WEBPROC_CRASH, 4, PMLOGKS("APP_ID", app_id.c_str()),
+            PMLOGKS("INSTANCE_ID", instance_id.c_str()),
+            PMLOGKS("InForeground", "true"),
+            PMLOGKS("Reloading limit", "OK; Reload default page"), "");
         app->Page()->ReloadDefaultPage();
       }
     } else if (app->IsMinimized()) {
@@ -713,10 +803,14 @@ std::string WebAppManager::Launch(const std::string& app_desc_string,
 }
 
 bool WebAppManager::IsRunningApp(const std::string& id) {
-  std::list<const WebAppBase*> running = RunningApps();
+  auto atom = Atom::Find(id);
+  if (!atom) {
+    return false;
+  }
 
+  std::list<const WebAppBase*> running = RunningApps();
   for (const WebAppBase* app : running) {
-    if (app->InstanceId() == id) {
+    if (app->InstanceAtom() == *atom) {
       return true;
     }
   }
@@ -741,6 +835,71 @@ Json::Value WebAppManager::GetWebProcessProfiling() {
   return web_process_manager_->GetWebProcessProfiling();
 }
 
+WebProcessManager::ProfilingTask WebAppManager::GetWebProcessProfilingTask() {
+  return web_process_manager_->GetWebProcessProfilingTask();
+}
+
+Json::Value WebAppManager::GetAppMemoryUsage(const std::string& app_id) {
+  UpdateAppMemoryUsage();
+  return app_memory_accounting_->ToJson(app_id);
+}
+
+Json::Value WebAppManager::GetInputLatency(const std::string& app_id,
+                                           bool reset) {
+  Json::Value result = input_latency_tracker_->ToJson(app_id);
+  if (reset) {
+    input_latency_tracker_->Reset();
+  }
+  return result;
+}
+
+void WebAppManager::UpdateAppMemoryUsage() {
+  if (!web_process_manager_) {
+    return;
+  }
+
+  std::vector<AppMemoryAccounting::Share> shares;
+  for (const WebAppBase* app : app_list_) {
+    AppMemoryAccounting::Share share;
+    share.app_id = app->AppId();
+    share.instance_id = app->InstanceId();
+    share.pid = web_process_manager_->GetWebProcessPID(app);
+
+    // The engine does not report per-frame memory, so an app is weighted by
+    // the number of pages it keeps in its renderer.
+    auto range = app_page_map_.equal_range(app->AppAtom());
+    size_t pages =
+        std::count_if(range.first, range.second, [&](const auto& item) {
+          return item.second->InstanceAtom() == app->InstanceAtom();
+        });
+    share.weight = std::max<size_t>(pages, 1);
+    shares.push_back(std::move(share));
+  }
+
+  app_memory_accounting_->Update(shares);
+}
+
+void WebAppManager::UpdateAppStateMetrics() {
+  int64_t foreground = 0;
+  int64_t background = 0;
+  int64_t preloaded = 0;
+  for (const WebAppBase* app : app_list_) {
+    if (app->Page()->IsPreload()) {
+      ++preloaded;
+    } else if (app->IsActivated()) {
+      ++foreground;
+    } else {
+      ++background;
+    }
+  }
+
+  GaugeFamily& apps = WebAppManagerMetrics::AppsByState();
+  apps.WithLabel("foreground").Set(foreground);
+  apps.WithLabel("background").Set(background);
+  apps.WithLabel("preloaded").Set(preloaded);
+  apps.WithLabel("closing").Set(closing_app_list_.size());
+}
+
 void WebAppManager::CloseApp(const std::string& app_id) {
   if (service_sender_) {
     service_sender_->CloseApp(app_id);
@@ -752,6 +911,7 @@ void WebAppManager::PostRunningAppList() {
     return;
   }
 
+  service_sender_->RunningAppsChanged();
   std::vector<ApplicationInfo> apps = List(true);
   service_sender_->PostlistRunningApps(apps);
 }
@@ -795,15 +955,9 @@ void WebAppManager::SetAccessibilityEnabled(bool enabled) {
     return;
   }
 
-  for (WebAppBase* app : app_list_) {
-    // set audion guidance on/off on settings app
-    if (app->Page()) {
-      app->Page()->SetAudioGuidanceOn(enabled);
-    }
-    app->SetUseAccessibility(enabled);
-  }
-
   is_accessibility_enabled_ = enabled;
+  SettingsChanged(WebPageBase::kAccessibilitySetting,
+                  DeviceInfoSnapshot::kNoField);
 }
 
 void WebAppManager::SendEventToAllAppsAndAllFrames(
@@ -17,25 +17,32 @@
 #ifndef CORE_WEB_APP_MANAGER_H_
 #define CORE_WEB_APP_MANAGER_H_
 
+#include <cstdint>
 #include <list>
 #include <map>
 #include <memory>
 #include <string>
-#include <unordered_map>
 #include <vector>
 
 #include "webos/webview_base.h"
 
+#include "atom.h"
+#include "device_info.h"
+#include "web_page_base.h"
+#include "web_process_manager.h"
+
+class AppMemoryAccounting;
 class ApplicationDescription;
-class DeviceInfo;
+class ErrorPageResolver;
+class FileContentCache;
+class InputLatencyTracker;
+class MainLoopWatchdog;
 class NetworkStatusManager;
 class PlatformModuleFactory;
 class ServiceSender;
-class WebProcessManager;
 class WebAppFactoryManager;
 class WebAppManagerConfig;
 class WebAppBase;
-class WebPageBase;
 
 namespace Json {
 class Value;
@@ -54,22 +61,19 @@ class ApplicationInfo {
   uint32_t pid_;
 };
 
-class WebAppManager {
+class WebAppManager : public DeviceInfo::Observer {
  public:
-  enum WebAppMessageType { kDeviceInfoChanged = 1 };
-
   static WebAppManager* Instance();
 
   bool GetSystemLanguage(std::string& value);
   bool GetDeviceInfo(const std::string& name, std::string& value);
-  void BroadcastWebAppMessage(WebAppMessageType type,
-                              const std::string& message);
+  std::shared_ptr<const DeviceInfoSnapshot> GetDeviceInfoSnapshot();
 
   WebProcessManager* GetWebProcessManager() {
     return web_process_manager_.get();
   }
 
-  virtual ~WebAppManager();
+  ~WebAppManager() override;
 
   void SetPlatformModules(std::unique_ptr<PlatformModuleFactory> factory);
   void SetWebAppFactory(std::unique_ptr<WebAppFactoryManager> factory);
@@ -91,6 +95,23 @@ class WebAppManager {
   std::vector<ApplicationInfo> List(bool include_system_apps = false);
 
   Json::Value GetWebProcessProfiling();
+  WebProcessManager::ProfilingTask GetWebProcessProfilingTask();
+  Json::Value GetAppMemoryUsage(const std::string& app_id = {});
+  AppMemoryAccounting* GetAppMemoryAccounting() {
+    return app_memory_accounting_.get();
+  }
+  // Returns the input latency histograms, and clears them if |reset| is set.
+  Json::Value GetInputLatency(const std::string& app_id = {},
+                              bool reset = false);
+  InputLatencyTracker* GetInputLatencyTracker() {
+    return input_latency_tracker_.get();
+  }
+  // Content of the user scripts, shared by all pages.
+  FileContentCache* GetUserScriptCache() { return user_script_cache_.get(); }
+  // Localized error page paths, dropped on system language changes.
+  ErrorPageResolver* GetErrorPageResolver() {
+    return error_page_resolver_.get();
+  }
   int CurrentUiWidth();
   int CurrentUiHeight();
   void SetUiSize(int width, int height);
@@ -134,6 +155,9 @@ class WebAppManager {
 
   bool IsAccessibilityEnabled() const { return is_accessibility_enabled_; }
   void SetAccessibilityEnabled(bool enabled);
+  // Bumped whenever the language, the accessibility or the device info
+  // changes. Pages record the generation they have applied.
+  uint64_t SettingsGeneration() const { return settings_generation_; }
   void PostWebProcessCreated(const std::string& app_id,
                              const std::string& instance_id,
                              uint32_t pid);
@@ -161,9 +185,18 @@ class WebAppManager {
   // Set notification permissions recieved from system.
   void SetNotifierEnabled(const std::string& app_id, bool enabled);
 
+  // DeviceInfo::Observer
+  void DeviceInfoChanged(const DeviceInfoSnapshot& snapshot,
+                         DeviceInfoSnapshot::Fields changed) override;
+
  private:
   WebAppFactoryManager* GetWebAppFactory();
   void LoadEnvironmentVariable();
+  void UpdateAppMemoryUsage();
+  // Collector of WebAppManagerMetrics::AppsByState().
+  void UpdateAppStateMetrics();
+  void SettingsChanged(WebPageBase::Settings settings,
+                       DeviceInfoSnapshot::Fields device_info);
 
   WebAppBase* OnLaunchUrl(const std::string& url,
                           const std::string& win_type,
@@ -184,11 +217,11 @@ class WebAppManager {
   typedef std::list<WebPageBase*> PageList;
 
   bool IsRunningApp(const std::string& id);
-  std::unordered_map<std::string, WebAppBase*> closing_app_list_;
+  AtomMap<WebAppBase*> closing_app_list_;
 
   // Mappings
   AppList app_list_;
-  std::unordered_multimap<std::string, WebPageBase*> app_page_map_;
+  AtomMultimap<WebPageBase*> app_page_map_;
 
   PageList pages_to_delete_list_;
   bool deleting_pages_ = false;
@@ -201,8 +234,16 @@ class WebAppManager {
   std::unique_ptr<WebAppManagerConfig> web_app_manager_config_;
   std::unique_ptr<NetworkStatusManager> network_status_manager_;
   std::unique_ptr<WebAppFactoryManager> web_app_factory_;
+  std::unique_ptr<AppMemoryAccounting> app_memory_accounting_;
+  std::unique_ptr<InputLatencyTracker> input_latency_tracker_;
+  std::unique_ptr<FileContentCache> user_script_cache_;
+  std::unique_ptr<ErrorPageResolver> error_page_resolver_;
+  std::unique_ptr<MainLoopWatchdog> main_loop_watchdog_;
+
+  AtomMap<int> last_crashed_app_ids_;
 
-  std::unordered_map<std::string, int> last_crashed_app_ids_;
+  // Updates the app state gauges before every metrics export.
+  int metrics_collector_id_ = 0;
 
   int suspend_delay_ = 0;
   int max_custom_suspend_delay_ = 0;
@@ -210,6 +251,7 @@ class WebAppManager {
   std::map<std::string, std::string> app_version_;
 
   bool is_accessibility_enabled_ = false;
+  uint64_t settings_generation_ = 0;
 };
 
 #endif  // CORE_WEB_APP_MANAGER_H_
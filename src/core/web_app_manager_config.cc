@@ -18,6 +18,7 @@
 
 #include <unistd.h>
 
+#include "startup_profiler.h"
 #include "utils.h"
 
 WebAppManagerConfig::WebAppManagerConfig() {
@@ -29,6 +30,7 @@ std::string WebAppManagerConfig::WamGetEnv(const char* name) {
 }
 
 void WebAppManagerConfig::InitConfiguration() {
+  StartupProfiler::Scope scope("WebAppManagerConfig::InitConfiguration");
   web_app_factory_plugin_types_ = WamGetEnv("WEBAPPFACTORY");
 
   web_app_factory_plugin_path_ = WamGetEnv("WEBAPPFACTORY_PLUGIN_PATH");
@@ -62,15 +64,30 @@ void WebAppManagerConfig::InitConfiguration() {
   launch_optimization_enabled_ =
       WamGetEnv("ENABLE_LAUNCH_OPTIMIZATION").compare("1") == 0;
 
+  main_loop_stall_threshold_ms_ = std::max(
+      util::StrToIntWithDefault(WamGetEnv("WAM_MAIN_LOOP_STALL_MS"), 0), 0);
+  main_loop_stall_backtrace_enabled_ =
+      WamGetEnv("WAM_MAIN_LOOP_STALL_BACKTRACE").compare("1") == 0;
+
   user_script_path_ = WamGetEnv("USER_SCRIPT_PATH");
   if (user_script_path_.empty()) {
     user_script_path_ = "webOSUserScripts/userScript.js";
   }
 
+  trace_path_ = WamGetEnv("WAM_TRACE_PATH");
+  if (trace_path_.empty()) {
+    trace_path_ = "/tmp/wam-trace.json";
+  }
+
+  metrics_export_path_ = WamGetEnv("WAM_METRICS_EXPORT_PATH");
+
   name_ = WamGetEnv("WAM_NAME");
 }
 
 void WebAppManagerConfig::PostInitConfiguration() {
+  StartupProfiler::Scope scope("PostInitConfiguration");
+  // Checked synchronously: it runs once at startup, before the main loop,
+  // and the first launch depends on the flags.
   if (access("/var/luna/preferences/debug_system_apps", F_OK) == 0) {
     inspector_enabled_ = true;
   }
@@ -98,6 +115,8 @@ void WebAppManagerConfig::ResetConfiguration() {
   error_page_url_.clear();
   tellurium_nub_path_.clear();
   user_script_path_.clear();
+  trace_path_.clear();
+  metrics_export_path_.clear();
   name_.clear();
 
   InitConfiguration();
@@ -54,12 +54,26 @@ class WebAppManagerConfig {
     return use_system_app_optimization_;
   }
   virtual std::string GetUserScriptPath() const { return user_script_path_; }
+  // The only file the dumpTrace method writes to.
+  virtual std::string GetTracePath() const { return trace_path_; }
+  // File or UNIX socket getMetrics exports to; empty disables the export.
+  virtual std::string GetMetricsExportPath() const {
+    return metrics_export_path_;
+  }
   virtual std::string GetName() const { return name_; }
 
   virtual bool IsLaunchOptimizationEnabled() const {
     return launch_optimization_enabled_;
   }
 
+  // 0 leaves the main loop unwatched.
+  virtual int GetMainLoopStallThresholdMs() const {
+    return main_loop_stall_threshold_ms_;
+  }
+  virtual bool IsMainLoopStallBacktraceEnabled() const {
+    return main_loop_stall_backtrace_enabled_;
+  }
+
  protected:
   virtual std::string WamGetEnv(const char* name);
   void ResetConfiguration();
@@ -80,7 +94,11 @@ class WebAppManagerConfig {
   bool check_launch_time_enabled_ = false;
   bool use_system_app_optimization_ = false;
   bool launch_optimization_enabled_ = false;
+  int main_loop_stall_threshold_ms_ = 0;
+  bool main_loop_stall_backtrace_enabled_ = false;
   std::string user_script_path_;
+  std::string trace_path_;
+  std::string metrics_export_path_;
   std::string name_;
 };
 
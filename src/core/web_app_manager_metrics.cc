@@ -0,0 +1,59 @@
+// Copyright (c) 2021 LG Electronics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+
+#include "web_app_manager_metrics.h"
+
+namespace {
+
+CounterFamily app_launches("wam_app_launches_total",
+                           "Apps launched",
+                           "app_id");
+CounterFamily app_crashes("wam_app_crashes_total",
+                          "Web process crashes seen by an app",
+                          "app_id");
+CounterFamily app_suspends("wam_app_suspends_total",
+                           "Apps sent to background",
+                           "app_id");
+CounterFamily app_closes("wam_app_closes_total", "Apps closed", "app_id");
+GaugeFamily apps_by_state("wam_apps", "Running apps by state", "state");
+
+}  // namespace
+
+// static
+CounterFamily& WebAppManagerMetrics::AppLaunches() {
+  return app_launches;
+}
+
+// static
+CounterFamily& WebAppManagerMetrics::AppCrashes() {
+  return app_crashes;
+}
+
+// static
+CounterFamily& WebAppManagerMetrics::AppSuspends() {
+  return app_suspends;
+}
+
+// static
+CounterFamily& WebAppManagerMetrics::AppCloses() {
+  return app_closes;
+}
+
+// static
+GaugeFamily& WebAppManagerMetrics::AppsByState() {
+  return apps_by_state;
+}
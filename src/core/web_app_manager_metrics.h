@@ -0,0 +1,35 @@
+// Copyright (c) 2021 LG Electronics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+
+#ifndef CORE_WEB_APP_MANAGER_METRICS_H_
+#define CORE_WEB_APP_MANAGER_METRICS_H_
+
+#include "metrics_registry.h"
+
+// Built-in app lifecycle metrics, registered with MetricsRegistry when the
+// library is loaded. The event counters are labeled with the app id.
+class WebAppManagerMetrics {
+ public:
+  static CounterFamily& AppLaunches();
+  static CounterFamily& AppCrashes();
+  static CounterFamily& AppSuspends();
+  static CounterFamily& AppCloses();
+  // Running apps per state: foreground, background, preloaded and closing.
+  static GaugeFamily& AppsByState();
+};
+
+#endif  // CORE_WEB_APP_MANAGER_METRICS_H_
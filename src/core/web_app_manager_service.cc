@@ -18,8 +18,12 @@
 
 #include <json/value.h>
 
+#include "input_latency_tracker.h"
 #include "log_manager.h"
+#include "metrics_registry.h"
+#include "trace_recorder.h"
 #include "web_app_base.h"
+#include "web_app_manager_config.h"
 #include "web_app_manager_tracer.h"
 
 WebAppManagerService::WebAppManagerService() = default;
@@ -45,14 +49,21 @@ bool WebAppManagerService::OnPauseApp(const std::string& instance_id) {
 }
 
 Json::Value WebAppManagerService::OnLogControl(const std::string& keys,
-                                               const std::string& value) {
-  LogManager::SetLogControl(keys, value);
+                                               const std::string& value,
+                                               const std::string& category) {
+  LogManager::SetLogControl(keys, value, category);
 
   Json::Value reply;
 
   reply["event"] = LogManager::GetDebugEventsEnabled();
   reply["bundleMessage"] = LogManager::GetDebugBundleMessagesEnabled();
   reply["mouseMove"] = LogManager::GetDebugMouseMoveEnabled();
+  reply["level"] = LogManager::LevelName(LogManager::GetDefaultLevel());
+  Json::Value levels(Json::objectValue);
+  for (const auto& entry : LogManager::GetCategoryLevels()) {
+    levels[entry.category] = LogManager::LevelName(entry.level);
+  }
+  reply["categoryLevels"] = std::move(levels);
   reply["returnValue"] = true;
 
   return reply;
@@ -68,6 +79,59 @@ Json::Value WebAppManagerService::GetWebProcessProfiling() {
   return WebAppManager::Instance()->GetWebProcessProfiling();
 }
 
+WebProcessManager::ProfilingTask
+WebAppManagerService::GetWebProcessProfilingTask() {
+  return WebAppManager::Instance()->GetWebProcessProfilingTask();
+}
+
+Json::Value WebAppManagerService::GetAppMemoryUsage(const std::string& app_id) {
+  return WebAppManager::Instance()->GetAppMemoryUsage(app_id);
+}
+
+Json::Value WebAppManagerService::GetInputLatency(const std::string& app_id,
+                                                  bool reset) {
+  return WebAppManager::Instance()->GetInputLatency(app_id, reset);
+}
+
+void WebAppManagerService::SetInputLatencyTracking(
+    std::optional<bool> enabled,
+    uint32_t sample_interval) {
+  InputLatencyTracker* tracker =
+      WebAppManager::Instance()->GetInputLatencyTracker();
+  if (sample_interval) {
+    tracker->SetSampleInterval(sample_interval);
+  }
+  if (enabled) {
+    tracker->SetEnabled(*enabled);
+  }
+}
+
+void WebAppManagerService::SetTracingEnabled(bool enabled) {
+  TraceRecorder::SetEnabled(enabled);
+}
+
+bool WebAppManagerService::DumpTrace(std::string& path, size_t& events) {
+  WebAppManagerConfig* config = WebAppManager::Instance()->Config();
+  if (!config) {
+    return false;
+  }
+  path = config->GetTracePath();
+  return TraceRecorder::WriteJsonFile(path, &events);
+}
+
+std::string WebAppManagerService::GetMetrics() {
+  return MetricsRegistry::Instance().ToPrometheusText();
+}
+
+bool WebAppManagerService::ExportMetrics(std::string& path) {
+  WebAppManagerConfig* config = WebAppManager::Instance()->Config();
+  if (!config) {
+    return false;
+  }
+  path = config->GetMetricsExportPath();
+  return !path.empty() && MetricsRegistry::Instance().Export(path);
+}
+
 void WebAppManagerService::OnClearBrowsingData(
     const int remove_browsing_data_mask) {
   WebAppManager::Instance()->ClearBrowsingData(remove_browsing_data_mask);
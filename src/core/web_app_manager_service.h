@@ -17,7 +17,9 @@
 #ifndef CORE_WEB_APP_MANAGER_SERVICE_H_
 #define CORE_WEB_APP_MANAGER_SERVICE_H_
 
+#include <cstdint>
 #include <list>
+#include <optional>
 #include <string>
 #include <vector>
 
@@ -38,7 +40,9 @@ enum ErrorCode {
   kErrCodeClearDataBrawsingUnknownData = 3002,
   kErrCodeFireNotificationEventMissingParameter = 4000,
   kErrCodeFireNotificationEventUnsupportedType = 4001,
-  kErrCodeInvalidParam = 5000
+  kErrCodeInvalidParam = 5000,
+  kErrCodeDumpTraceFailed = 6000,
+  kErrCodeExportMetricsFailed = 7000
 };
 
 const std::string kErrInvalidParam =
@@ -60,6 +64,10 @@ const std::string kErrFireNotificationEventMissingParameter =
     "Missing parameter(s)";
 const std::string kErrFireNotificationEventUnsupportedType = "Unsupported type";
 
+const std::string kErrDumpTraceFailed = "Failed to write the trace file";
+
+const std::string kErrExportMetricsFailed = "Failed to export the metrics";
+
 class WebAppBase;
 
 class WebAppManagerService {
@@ -78,6 +86,12 @@ class WebAppManagerService {
   virtual Json::Value listRunningApps(const Json::Value& request,
                                       bool subscribed) = 0;
   virtual Json::Value getWebProcessSize(const Json::Value& request) = 0;
+  virtual Json::Value getAppMemoryUsage(const Json::Value& request) = 0;
+  virtual Json::Value getInputLatency(const Json::Value& request) = 0;
+  virtual Json::Value dumpTrace(const Json::Value& request) = 0;
+  virtual Json::Value getServiceMetrics(const Json::Value& request) = 0;
+  virtual Json::Value getMetrics(const Json::Value& request) = 0;
+  virtual Json::Value getStartupProfile(const Json::Value& request) = 0;
   virtual Json::Value clearBrowsingData(const Json::Value& request) = 0;
   virtual Json::Value webProcessCreated(const Json::Value& request,
                                         bool subscribed) = 0;
@@ -94,9 +108,25 @@ class WebAppManagerService {
                  const std::string& instance_id,
                  bool force = false);
   bool OnPauseApp(const std::string& instance_id);
-  Json::Value OnLogControl(const std::string& keys, const std::string& value);
+  Json::Value OnLogControl(const std::string& keys,
+                           const std::string& value,
+                           const std::string& category = {});
   bool OnCloseAllApps(uint32_t pid = 0);
   Json::Value GetWebProcessProfiling();
+  // The process size reads of GetWebProcessProfiling(), for a worker thread.
+  WebProcessManager::ProfilingTask GetWebProcessProfilingTask();
+  Json::Value GetAppMemoryUsage(const std::string& app_id);
+  Json::Value GetInputLatency(const std::string& app_id, bool reset);
+  void SetTracingEnabled(bool enabled);
+  // Writes to the configured trace path, which is returned in |path|.
+  bool DumpTrace(std::string& path, size_t& events);
+  // Metrics in the Prometheus text format.
+  std::string GetMetrics();
+  // Exports to the configured path, which is returned in |path|.
+  bool ExportMetrics(std::string& path);
+  // Unset |enabled| and a |sample_interval| of 0 keep the current values.
+  void SetInputLatencyTracking(std::optional<bool> enabled,
+                               uint32_t sample_interval);
   int MaskForBrowsingDataType(const char* type);
   void OnClearBrowsingData(const int remove_browsing_data_mask);
   void OnAppInstalled(const std::string& app_id);
@@ -17,45 +17,85 @@
 #ifndef CORE_WEB_APP_MANAGER_TRACER_H_
 #define CORE_WEB_APP_MANAGER_TRACER_H_
 
-#ifdef HAS_LTTNG
+#include <cstdio>
+
+#include "trace_recorder.h"
 
+// Every trace point goes to the built-in TraceRecorder, and to LTTng if it
+// is available. Labels must be string literals.
+#ifdef HAS_LTTNG
 #include "pmtrace_provider_lib_wrapper.h"
+#define PMTRACE_LTTNG(call) call
+#else
+#define PMTRACE_LTTNG(call)
+#endif  // HAS_LTTNG
 
 /* PMTRACE_LOG is for free form tracing. Provide a string
    which uniquely identifies your trace point. */
-#define PMTRACE(label) pmtrace::TraceMessage(label)
+#define PMTRACE(label)                           \
+  do {                                           \
+    PMTRACE_LTTNG(pmtrace::TraceMessage(label)); \
+    TraceRecorder::Instant(label);               \
+  } while (0)
 
 /* PMTRACE_BEFORE / AFTER is for tracing a time duration
  * which is not contained within a scope (curly braces) or function,
  * or in C code where there is no mechanism to automatically detect
  * exiting a scope or function.
  */
-#define PMTRACE_BEFORE(label) pmtrace::TraceBefore(label)
-#define PMTRACE_AFTER(label) pmtrace::TraceAfter(label)
+#define PMTRACE_BEFORE(label)                   \
+  do {                                          \
+    PMTRACE_LTTNG(pmtrace::TraceBefore(label)); \
+    TraceRecorder::Begin(label);                \
+  } while (0)
+#define PMTRACE_AFTER(label)                   \
+  do {                                         \
+    PMTRACE_LTTNG(pmtrace::TraceAfter(label)); \
+    TraceRecorder::End(label);                 \
+  } while (0)
 
 /* PMTRACE_SCOPE* is for tracing a the duration of a scope.  In
  * C++ code use PMTRACE_SCOPE only, in C code use the
  * ENTRY/EXIT macros and be careful to catch all exit cases.
  */
-#define PMTRACE_SCOPE_ENTRY(label) pmtrace::TraceScopeEntry(label)
-#define PMTRACE_SCOPE_EXIT(label) pmtrace::TraceScopeExit(label)
+#define PMTRACE_SCOPE_ENTRY(label)                  \
+  do {                                              \
+    PMTRACE_LTTNG(pmtrace::TraceScopeEntry(label)); \
+    TraceRecorder::Begin(label);                    \
+  } while (0)
+#define PMTRACE_SCOPE_EXIT(label)                  \
+  do {                                             \
+    PMTRACE_LTTNG(pmtrace::TraceScopeExit(label)); \
+    TraceRecorder::End(label);                     \
+  } while (0)
 #define PMTRACE_SCOPE(label) PmTraceScope trace_scope(label)
 
 /* PMTRACE_FUNCTION* is for tracing a the duration of a scope.
  * In C++ code use PMTRACE_FUNCTION only, in C code use the
  * ENTRY/EXIT macros and be careful to catch all exit cases.
  */
-#define PMTRACE_FUNCTION_ENTRY(label) pmtrace::TraceFunctionEntry(label)
-#define PMTRACE_FUNCTION_EXIT(label) pmtrace::TraceFunctionExit(label)
+#define PMTRACE_FUNCTION_ENTRY(label)                  \
+  do {                                                 \
+    PMTRACE_LTTNG(pmtrace::TraceFunctionEntry(label)); \
+    TraceRecorder::Begin(label);                       \
+  } while (0)
+#define PMTRACE_FUNCTION_EXIT(label)                  \
+  do {                                                \
+    PMTRACE_LTTNG(pmtrace::TraceFunctionExit(label)); \
+    TraceRecorder::End(label);                        \
+  } while (0)
 #define PMTRACE_FUNCTION PmTraceFunction trace_function(__FILE__, __FUNCTION__)
 
+/* PMTRACE_COUNTER records the value of |label| at this point of time. */
+#define PMTRACE_COUNTER(label, value) TraceRecorder::Counter(label, value)
+
 class PmTraceScope {
  public:
-  explicit PmTraceScope(const std::string& label) : scope_label_(label) {
-    PMTRACE_SCOPE_ENTRY(scope_label_.c_str());
+  explicit PmTraceScope(const char* label) : scope_label_(label) {
+    PMTRACE_SCOPE_ENTRY(scope_label_);
   }
 
-  ~PmTraceScope() { PMTRACE_SCOPE_EXIT(scope_label_.c_str()); }
+  ~PmTraceScope() { PMTRACE_SCOPE_EXIT(scope_label_); }
 
   // Prevent heap allocation
   void operator delete(void*) = delete;
@@ -64,21 +104,26 @@ class PmTraceScope {
   PmTraceScope& operator=(const PmTraceScope&) = delete;
 
  private:
-  std::string scope_label_;
+  const char* scope_label_;
 };
 
 class PmTraceFunction {
  public:
-  explicit PmTraceFunction(const std::string& label) : fn_label_(label) {
-    PMTRACE_FUNCTION_ENTRY(fn_label_.c_str());
+  explicit PmTraceFunction(const char* label) : name_(label), file_(nullptr) {
+    Enter();
   }
 
-  PmTraceFunction(const std::string& file, const std::string& name)
-      : fn_label_(file + "::" + name) {
-    PMTRACE_FUNCTION_ENTRY(fn_label_.c_str());
+  // The built-in recorder gets |name| with |file| as category, LTTng gets
+  // "file::name".
+  PmTraceFunction(const char* file, const char* name)
+      : name_(name), file_(file) {
+    Enter();
   }
 
-  ~PmTraceFunction() { PMTRACE_FUNCTION_EXIT(fn_label_.c_str()); }
+  ~PmTraceFunction() {
+    PMTRACE_LTTNG(pmtrace::TraceFunctionExit(lttng_label_));
+    TraceRecorder::End(name_, file_);
+  }
 
   // Prevent heap allocation
   void operator delete(void*) = delete;
@@ -87,21 +132,23 @@ class PmTraceFunction {
   PmTraceFunction& operator=(const PmTraceFunction&) = delete;
 
  private:
-  std::string fn_label_;
-};
-
-#else  // HAS_LTNG
-
-#define PMTRACE(label)
-#define PMTRACE_BEFORE(label)
-#define PMTRACE_AFTER(label)
-#define PMTRACE_SCOPE_ENTRY(label)
-#define PMTRACE_SCOPE_EXIT(label)
-#define PMTRACE_SCOPE(label)
-#define PMTRACE_FUNCTION_ENTRY(label)
-#define PMTRACE_FUNCTION_EXIT(label)
-#define PMTRACE_FUNCTION
+  void Enter() {
+#ifdef HAS_LTTNG
+    if (file_) {
+      snprintf(lttng_label_, sizeof(lttng_label_), "%s::%s", file_, name_);
+    } else {
+      snprintf(lttng_label_, sizeof(lttng_label_), "%s", name_);
+    }
+    pmtrace::TraceFunctionEntry(lttng_label_);
+#endif  // HAS_LTTNG
+    TraceRecorder::Begin(name_, file_);
+  }
 
+  const char* name_;
+  const char* file_;
+#ifdef HAS_LTTNG
+  char lttng_label_[256];
 #endif  // HAS_LTTNG
+};
 
 #endif  // CORE_WEB_APP_MANAGER_TRACER_H_
@@ -19,6 +19,8 @@
 #include <filesystem>
 #include <memory>
 #include <sstream>
+#include <system_error>
+#include <utility>
 
 #include <json/value.h>
 
@@ -43,11 +45,14 @@ WebPageBase::WebPageBase(const wam::Url& url,
                          const std::string& params)
     : app_desc_(desc),
       app_id_(desc.Id()),
+      app_atom_(app_id_),
       default_url_(url),
-      launch_params_(params) {
+      launch_params_(params),
+      // The page reads the current settings when it is initialized.
+      settings_generation_(WebAppManager::Instance()->SettingsGeneration()) {
   Json::Value json = util::StringToJson(params);
   if (json.isObject()) {
-    instance_id_ = json["instanceId"].asString();
+    SetInstanceId(json["instanceId"].asString());
   } else {
     LOG_WARNING(MSGID_TYPE_ERROR, 0,
                 "[%s] failed get instanceId from params '%s'", app_id_.c_str(),
@@ -77,6 +82,10 @@ std::string WebPageBase::GetIdentifier() const {
 }
 
 void WebPageBase::Load() {
+  if (DeferLoadUntilUserScriptsRead([this] { Load(); })) {
+    return;
+  }
+
   LOG_INFO(MSGID_WEBPAGE_LOAD, 3, PMLOGKS("APP_ID", AppId().c_str()),
            PMLOGKS("INSTANCE_ID", InstanceId().c_str()),
            PMLOGKFV("PID", "%d", GetWebProcessPID()), "launch_params_:%s",
@@ -110,11 +119,8 @@ void WebPageBase::SetupLaunchEvent() {
 }
 
 void WebPageBase::SendLocaleChangeEvent(const std::string& /*language*/) {
-  // TODO(luc2.tran): This should be probably run only when
-  // |enable_background_run_| is set to 'true' or the web app is not suspended.
-  // The other case (app is suspended), I think we're better not to run the
-  // script instead of using a timeout. Using the timeout could make unexpected
-  // behavior when the app is unsuspended and then all timers will be executed.
+  // Suspended pages do not get here: WebAppBase defers the locale change
+  // until the page is resumed, so no timers pile up in the background.
   EvaluateJavaScript(
       "setTimeout(function () {"
       "    var localeEvent=new CustomEvent('webOSLocaleChange');"
@@ -122,6 +128,20 @@ void WebPageBase::SendLocaleChangeEvent(const std::string& /*language*/) {
       "}, 1);");
 }
 
+void WebPageBase::AddPendingSettings(Settings settings,
+                                     DeviceInfoSnapshot::Fields device_info) {
+  pending_settings_.settings |= settings;
+  pending_settings_.device_info |= device_info;
+}
+
+WebPageBase::PendingSettings WebPageBase::TakePendingSettings(
+    uint64_t generation) {
+  PendingSettings pending = pending_settings_;
+  pending_settings_ = PendingSettings();
+  settings_generation_ = generation;
+  return pending;
+}
+
 void WebPageBase::CleanResources() {
   SetCleaningResources(true);
 }
@@ -312,6 +332,11 @@ bool WebPageBase::GetDeviceInfo(const std::string& name, std::string& value) {
   return WebAppManager::Instance()->GetDeviceInfo(name, value);
 }
 
+std::shared_ptr<const DeviceInfoSnapshot>
+WebPageBase::GetDeviceInfoSnapshot() {
+  return WebAppManager::Instance()->GetDeviceInfoSnapshot();
+}
+
 int WebPageBase::CurrentUiWidth() {
   return WebAppManager::Instance()->CurrentUiWidth();
 }
@@ -324,6 +349,63 @@ WebProcessManager* WebPageBase::GetWebProcessManager() {
   return WebAppManager::Instance()->GetWebProcessManager();
 }
 
+FileContentCache* WebPageBase::GetUserScriptCache() {
+  return WebAppManager::Instance()->GetUserScriptCache();
+}
+
+void WebPageBase::ReadUserScript(
+    const std::string& path,
+    std::function<void(FileContentCache::Content)> reply) {
+  FileContentCache* cache = GetUserScriptCache();
+  FileIoService::Instance()
+      ->PostTaskAndReplyWithResult<FileContentCache::Content>(
+          [cache, path]() -> FileContentCache::Content {
+            // Only regular files: reading a FIFO or a device could block
+            // the worker indefinitely.
+            std::error_code error;
+            if (!fs::is_regular_file(path, error)) {
+              return nullptr;
+            }
+            return cache->Get(path);
+          },
+          [this, reply = std::move(reply)](FileContentCache::Content content) {
+            reply(std::move(content));
+            LoadIfUserScriptsRead();
+          },
+          &user_script_reads_);
+}
+
+void WebPageBase::CancelUserScriptReads() {
+  user_script_reads_.Cancel();
+  if (load_after_user_scripts_) {
+    // The dropped replies would have resumed the deferred load. This one
+    // comes after the reads posted so far, and a later read resumes it if
+    // there is one.
+    FileIoService::Instance()->PostTaskAndReply(
+        [] {}, [this] { LoadIfUserScriptsRead(); }, &user_script_reads_);
+  }
+}
+
+bool WebPageBase::DeferLoadUntilUserScriptsRead(std::function<void()> load) {
+  if (!user_script_reads_.Pending()) {
+    return false;
+  }
+  load_after_user_scripts_ = std::move(load);
+  return true;
+}
+
+void WebPageBase::LoadIfUserScriptsRead() {
+  if (load_after_user_scripts_ && !user_script_reads_.Pending()) {
+    std::function<void()> load = std::move(load_after_user_scripts_);
+    load_after_user_scripts_ = nullptr;
+    load();
+  }
+}
+
+ErrorPageResolver* WebPageBase::GetErrorPageResolver() {
+  return WebAppManager::Instance()->GetErrorPageResolver();
+}
+
 WebAppManagerConfig* WebPageBase::GetWebAppManagerConfig() {
   return WebAppManager::Instance()->Config();
 }
@@ -420,10 +502,10 @@ void WebPageBase::SetBackgroundColorOfBody(const std::string& color) {
 
 std::string WebPageBase::DefaultFont() {
   std::string default_font = "LG Display-Regular";
-  std::string language;
-  std::string country;
-  GetSystemLanguage(language);
-  GetDeviceInfo("LocalCountry", country);
+  std::shared_ptr<const DeviceInfoSnapshot> device_info =
+      GetDeviceInfoSnapshot();
+  const std::string& language = device_info->SystemLanguage();
+  const std::string& country = device_info->LocalCountry();
 
   // for the model
   if (country == "JPN") {
@@ -477,19 +559,24 @@ void WebPageBase::SetCustomUserScript() {
   auto user_script_file_path = fs::path(app_desc_.FolderPath()) /
                                GetWebAppManagerConfig()->GetUserScriptPath();
 
-  if (!fs::exists(user_script_file_path) ||
-      !fs::is_regular_file(fs::status(user_script_file_path))) {
-    LOG_WARNING(MSGID_FILE_ERROR, 0,
-                "[%s] script not exist on file system '%s'", app_id_.c_str(),
-                user_script_file_path.c_str());
-    return;
-  }
-
-  LOG_INFO(MSGID_WAM_DEBUG, 3, PMLOGKS("APP_ID", AppId().c_str()),
-           PMLOGKS("INSTANCE_ID", InstanceId().c_str()),
-           PMLOGKFV("PID", "%d", GetWebProcessPID()),
-           "User Scripts exists : %s", user_script_file_path.c_str());
-  AddUserScriptUrl(wam::Url::FromLocalFile(user_script_file_path.native()));
+  ReadUserScript(
+      user_script_file_path.native(),
+      [this, user_script_file_path](FileContentCache::Content content) {
+        if (!content) {
+          LOG_WARNING(MSGID_FILE_ERROR, 0,
+                      "[%s] script not exist on file system '%s'",
+                      app_id_.c_str(), user_script_file_path.c_str());
+          return;
+        }
+
+        LOG_INFO(MSGID_WAM_DEBUG, 3, PMLOGKS("APP_ID", AppId().c_str()),
+                 PMLOGKS("INSTANCE_ID", InstanceId().c_str()),
+                 PMLOGKFV("PID", "%d", GetWebProcessPID()),
+                 "User Scripts exists : %s", user_script_file_path.c_str());
+        if (!content->empty()) {
+          AddUserScript(*content);
+        }
+      });
 }
 
 void WebPageBase::AddObserver(WebPageObserver* observer) {
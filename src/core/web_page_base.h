@@ -17,15 +17,22 @@
 #ifndef CORE_WEB_PAGE_BASE_H_
 #define CORE_WEB_PAGE_BASE_H_
 
+#include <cstdint>
+#include <functional>
 #include <memory>
 #include <string>
 
 #include "webos/webview_base.h"
 
+#include "atom.h"
+#include "device_info_snapshot.h"
+#include "file_content_cache.h"
+#include "file_io_service.h"
 #include "observer_list.h"
 #include "util/url.h"
 
 class ApplicationDescription;
+class ErrorPageResolver;
 class WebAppBase;
 class WebAppManagerConfig;
 class WebPageObserver;
@@ -48,6 +55,22 @@ class WebPageBase {
     kWebPageVisibilityStateLast = kWebPageVisibilityStatePrerender
   };
 
+  // System settings which are propagated lazily, see
+  // WebAppBase::SettingsChanged().
+  enum Setting : uint32_t {
+    kNoSetting = 0,
+    kLanguageSetting = 1u << 0,
+    kAccessibilitySetting = 1u << 1,
+  };
+  // Bit mask of Setting values.
+  using Settings = uint32_t;
+
+  // Changes the page has not applied yet because it was hidden or suspended.
+  struct PendingSettings {
+    Settings settings = kNoSetting;
+    DeviceInfoSnapshot::Fields device_info = DeviceInfoSnapshot::kNoField;
+  };
+
   WebPageBase(const wam::Url& url,
               const ApplicationDescription& desc,
               const std::string& params);
@@ -81,7 +104,8 @@ class WebPageBase {
   virtual bool CanGoBack() = 0;
   virtual void CloseVkb() = 0;
   virtual void KeyboardVisibilityChanged(bool /*visible*/) {}
-  virtual void HandleDeviceInfoChanged(const std::string& device_info) = 0;
+  virtual void HandleDeviceInfoChanged(const DeviceInfoSnapshot& snapshot,
+                                       DeviceInfoSnapshot::Fields changed) = 0;
   virtual bool Relaunch(const std::string& args,
                         const std::string& launching_app_id);
   virtual void EvaluateJavaScript(const std::string& js_code) = 0;
@@ -114,6 +138,7 @@ class WebPageBase {
   virtual void ForwardEvent(void* event) = 0;
   virtual void SetAudioGuidanceOn(bool /*on*/) {}
   virtual bool IsInputMethodActive() const { return false; }
+  virtual bool IsSuspended() const { return false; }
 
   std::string LaunchParams() const;
   void Load();
@@ -125,12 +150,18 @@ class WebPageBase {
   bool CleaningResources() const { return cleaning_resources_; }
   bool DoHostedWebAppRelaunch(const std::string& launch_params);
   void SendRelaunchEvent();
-  void SetAppId(const std::string& app_id) { app_id_ = app_id; }
+  void SetAppId(const std::string& app_id) {
+    app_id_ = app_id;
+    app_atom_ = Atom(app_id);
+  }
   const std::string& AppId() const { return app_id_; }
+  const Atom& AppAtom() const { return app_atom_; }
   void SetInstanceId(const std::string& instance_id) {
     instance_id_ = instance_id;
+    instance_atom_ = Atom(instance_id);
   }
   const std::string& InstanceId() const { return instance_id_; }
+  const Atom& InstanceAtom() const { return instance_atom_; }
   const ApplicationDescription& GetAppDescription() { return app_desc_; }
 
   void SetClosing(bool status) { is_closing_ = status; }
@@ -139,6 +170,14 @@ class WebPageBase {
   void SetIsPreload(bool is_preload) { is_preload_ = is_preload; }
   bool IsPreload() const { return is_preload_; }
 
+  // Generation of WebAppManager::SettingsGeneration() the page has applied.
+  uint64_t SettingsGeneration() const { return settings_generation_; }
+  void AddPendingSettings(Settings settings,
+                          DeviceInfoSnapshot::Fields device_info);
+  // Returns the changes to apply and marks the page as up to date with
+  // |generation|.
+  PendingSettings TakePendingSettings(uint64_t generation);
+
   void AddObserver(WebPageObserver* observer);
   void RemoveObserver(WebPageObserver* observer);
 
@@ -167,10 +206,27 @@ class WebPageBase {
   void HandleLoadFinished();
   void HandleLoadFailed(int error_code);
   bool GetDeviceInfo(const std::string& name, std::string& value);
+  std::shared_ptr<const DeviceInfoSnapshot> GetDeviceInfoSnapshot();
   bool GetSystemLanguage(std::string& value);
   int CurrentUiWidth();
   int CurrentUiHeight();
   WebProcessManager* GetWebProcessManager();
+  FileContentCache* GetUserScriptCache();
+  // Reads |path| through the user script cache on the file I/O thread. The
+  // reply gets null if |path| is missing or not a regular file.
+  // Load() and the reloads wait for the pending reads, so the scripts are
+  // added before the document; the replies are dropped with the page.
+  void ReadUserScript(
+      const std::string& path,
+      std::function<void(FileContentCache::Content)> reply);
+  // Drops the replies of the pending reads; a load waiting for them still
+  // happens once the reads posted after the cancellation are done.
+  void CancelUserScriptReads();
+  // Keeps |load| until the pending user script reads are done, so that the
+  // scripts are added before the document, and returns true. Returns false
+  // if nothing is being read. A later load replaces one still waiting.
+  bool DeferLoadUntilUserScriptsRead(std::function<void()> load);
+  ErrorPageResolver* GetErrorPageResolver();
   WebAppManagerConfig* GetWebAppManagerConfig();
   bool ProcessCrashed();
 
@@ -188,6 +244,8 @@ class WebPageBase {
   const ApplicationDescription& app_desc_;
   std::string app_id_;
   std::string instance_id_;
+  Atom app_atom_;
+  Atom instance_atom_;
   bool suspend_at_load_ = false;
   bool is_closing_ = false;
   bool is_load_error_page_finish_ = false;
@@ -202,9 +260,14 @@ class WebPageBase {
  private:
   void SetBackgroundColorOfBody(const std::string& color);
   void SetupLaunchEvent();
+  void LoadIfUserScriptsRead();
 
   bool cleaning_resources_ = false;
   bool is_preload_ = false;
+  uint64_t settings_generation_ = 0;
+  PendingSettings pending_settings_;
+  std::function<void()> load_after_user_scripts_;
+  FileIoService::TaskGroup user_script_reads_;
 };
 
 #endif  // CORE_WEB_PAGE_BASE_H_
@@ -18,6 +18,7 @@
 #define CORE_WEB_PROCESS_MANAGER_H_
 
 #include <cstdint>
+#include <functional>
 #include <list>
 #include <string>
 
@@ -34,7 +35,13 @@ class WebProcessManager {
 
   virtual std::string GetWebProcessMemSize(uint32_t pid) const;
 
+  using ProfilingTask = std::function<Json::Value()>;
+
   virtual Json::Value GetWebProcessProfiling() = 0;
+  // Takes the running apps by web process on the calling thread and returns
+  // the rest of GetWebProcessProfiling(), the process size reads, which may
+  // run on another thread as long as the manager lives.
+  virtual ProfilingTask GetWebProcessProfilingTask() = 0;
   virtual uint32_t GetWebProcessPID(const WebAppBase* app) const = 0;
   virtual void ClearBrowsingData(const int remove_browsing_data_mask) = 0;
   virtual int MaskForBrowsingDataType(const char* type) = 0;
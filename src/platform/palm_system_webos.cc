@@ -52,7 +52,13 @@ bool PalmSystemWebOS::IsKeyboardVisible() const {
 }
 
 bool PalmSystemWebOS::IsMinimal() const {
-  return util::DoesPathExist("/var/luna/preferences/ran-firstuse");
+  // The file appears once the first use app finishes and stays, so only its
+  // absence needs to be checked again.
+  static bool ran_first_use = false;
+  if (!ran_first_use) {
+    ran_first_use = util::DoesPathExist("/var/luna/preferences/ran-firstuse");
+  }
+  return ran_first_use;
 }
 
 int PalmSystemWebOS::ActivityId() const {
@@ -101,14 +107,18 @@ void PalmSystemWebOS::Hide() {
 
 void PalmSystemWebOS::SetInputRegion(const std::string& params) {
   // this function is not related to windowGroup anymore
-  Json::Value json_doc;
-  const bool result = util::StringToJson(params, json_doc);
-  if (result) {
-    app_->SetInputRegion(json_doc);
-  } else {
-    LOG_ERROR(MSGID_TYPE_ERROR, 0, "[%s] setInputRegion failed, params='%s'",
-              app_->AppId().c_str(), params.c_str());
+  if (params != input_region_params_ || input_region_params_.empty()) {
+    Json::Value json_doc;
+    const bool result = util::StringToJson(params, json_doc);
+    if (!result) {
+      LOG_ERROR(MSGID_TYPE_ERROR, 0, "[%s] setInputRegion failed, params='%s'",
+                app_->AppId().c_str(), params.c_str());
+      return;
+    }
+    input_region_ = WebAppWayland::InputRegionFromJson(json_doc);
+    input_region_params_ = params;
   }
+  app_->SetInputRegion(input_region_);
 }
 
 void PalmSystemWebOS::SetGroupClientEnvironment(GroupClientCallKey call_key,
@@ -120,15 +130,19 @@ void PalmSystemWebOS::SetGroupClientEnvironment(GroupClientCallKey call_key,
     if (!group_info.name.empty() && !group_info.is_owner) {
       switch (call_key) {
         case kKeyMask: {
-          Json::Value json_doc;
-          const bool result = util::StringToJson(params, json_doc);
-          if (result) {
-            app_->SetKeyMask(json_doc);
-          } else {
-            LOG_ERROR(MSGID_TYPE_ERROR, 0,
-                      "[%s] failed to get key mask from params='%s'",
-                      app_->AppId().c_str(), params.c_str());
+          if (params != key_mask_params_ || key_mask_params_.empty()) {
+            Json::Value json_doc;
+            const bool result = util::StringToJson(params, json_doc);
+            if (!result) {
+              LOG_ERROR(MSGID_TYPE_ERROR, 0,
+                        "[%s] failed to get key mask from params='%s'",
+                        app_->AppId().c_str(), params.c_str());
+              break;
+            }
+            key_mask_ = WebAppWayland::KeyMaskFromJson(json_doc);
+            key_mask_params_ = params;
           }
+          app_->SetKeyMask(key_mask_);
         } break;
         case kFocusOwner:
           app_->FocusOwner();
@@ -18,6 +18,10 @@
 #define PLATFORM_PALM_SYSTEM_WEBOS_H_
 
 #include <string>
+#include <vector>
+
+#include "webos/common/webos_constants.h"
+#include "webos/webapp_window_base.h"
 
 #include "palm_system_base.h"
 
@@ -72,6 +76,14 @@ class PalmSystemWebOS : public PalmSystemBase {
 
   WebAppWayland* app_;
   std::string launch_params_;
+
+ private:
+  // Arguments of the last setInputRegion() and setKeyMask() calls and their
+  // parsed values, as apps tend to send the same ones on every frame.
+  std::string input_region_params_;
+  std::vector<gfx::Rect> input_region_;
+  std::string key_mask_params_;
+  webos::WebOSKeyMask key_mask_ = static_cast<webos::WebOSKeyMask>(0);
 };
 
 #endif  // PLATFORM_PALM_SYSTEM_WEBOS_H_
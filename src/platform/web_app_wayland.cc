@@ -24,8 +24,11 @@
 #include "webos/window_group_configuration.h"
 
 #include "application_description.h"
+#include "input_latency_tracker.h"
 #include "log_manager.h"
 #include "utils.h"
+#include "web_app_manager.h"
+#include "web_app_manager_metrics.h"
 #include "web_app_wayland_window.h"
 #include "web_app_window_impl.h"
 #include "web_page_base.h"
@@ -35,6 +38,7 @@
 namespace {
 
 static int kLaunchFinishAssureTimeoutMs = 5000;
+constexpr int kWindowUpdateFrameMs = 16;
 
 const std::unordered_map<std::string, webos::WebOSKeyMask>& GetKeyMaskTable() {
   static const std::unordered_map<std::string, webos::WebOSKeyMask> map_table{
@@ -298,6 +302,9 @@ void WebAppWayland::OnStageActivated() {
   Page()->SetVisibilityState(
       WebPageBase::WebPageVisibilityState::kWebPageVisibilityStateVisible);
 
+  // Catch up with the settings changed while the page was in background
+  UpdateSettings();
+
   SetActiveInstanceId(InstanceId());
 
   app_window_->Show();
@@ -314,6 +321,7 @@ void WebAppWayland::OnStageDeactivated() {
       WebPageBase::WebPageVisibilityState::kWebPageVisibilityStateHidden);
   Page()->SuspendWebPageAll();
   SetHiddenWindow(true);
+  WebAppManagerMetrics::AppSuspends().WithLabel(AppId()).Increment();
 
   LOG_INFO(MSGID_WEBAPP_STAGE_DEACITVATED, 3,
            PMLOGKS("APP_ID", AppId().c_str()),
@@ -395,6 +403,8 @@ bool WebAppWayland::IsKeyboardVisible() {
 }
 
 void WebAppWayland::SetKeyMask(webos::WebOSKeyMask key_mask, bool value) {
+  // The window no longer has the mask set last as a whole.
+  key_mask_update_.Invalidate();
   app_window_->SetKeyMask(key_mask, value);
 }
 
@@ -406,19 +416,71 @@ void WebAppWayland::ApplyInputRegion() {
 }
 
 void WebAppWayland::SetInputRegion(const Json::Value& value) {
-  input_region_.clear();
+  SetInputRegion(InputRegionFromJson(value));
+}
+
+void WebAppWayland::SetInputRegion(const std::vector<gfx::Rect>& region) {
+  std::vector<gfx::Rect> scaled_region;
+  scaled_region.reserve(region.size());
+  for (const auto& rect : region) {
+    scaled_region.emplace_back(
+        gfx::Rect(rect.x() * scale_factor_, rect.y() * scale_factor_,
+                  rect.width() * scale_factor_, rect.height() * scale_factor_));
+  }
+
+  if (input_region_update_.Update(std::move(scaled_region))) {
+    SendInputRegion();
+  }
+}
+
+void WebAppWayland::SendInputRegion() {
+  input_region_ = input_region_update_.Sent();
+  app_window_->SetInputRegion(input_region_);
+  if (!window_update_timer_.IsRunning()) {
+    window_update_timer_.StartWithReceiver(kWindowUpdateFrameMs, this,
+                                           &WebAppWayland::FlushWindowUpdates);
+  }
+}
 
+void WebAppWayland::SendKeyMask() {
+  app_window_->SetKeyMask(key_mask_update_.Sent());
+  if (!window_update_timer_.IsRunning()) {
+    window_update_timer_.StartWithReceiver(kWindowUpdateFrameMs, this,
+                                           &WebAppWayland::FlushWindowUpdates);
+  }
+}
+
+void WebAppWayland::FlushWindowUpdates() {
+  window_update_timer_.Stop();
+  if (input_region_update_.NextFrame()) {
+    SendInputRegion();
+  }
+  if (key_mask_update_.NextFrame()) {
+    SendKeyMask();
+  }
+}
+
+std::vector<gfx::Rect> WebAppWayland::InputRegionFromJson(
+    const Json::Value& value) {
+  std::vector<gfx::Rect> region;
   if (value.isArray()) {
-    for (const auto& region : value) {
-      input_region_.emplace_back(
-          gfx::Rect(region["x"].asInt() * scale_factor_,
-                    region["y"].asInt() * scale_factor_,
-                    region["width"].asInt() * scale_factor_,
-                    region["height"].asInt() * scale_factor_));
+    region.reserve(value.size());
+    for (const auto& rect : value) {
+      region.emplace_back(rect["x"].asInt(), rect["y"].asInt(),
+                          rect["width"].asInt(), rect["height"].asInt());
     }
   }
+  return region;
+}
 
-  app_window_->SetInputRegion(input_region_);
+webos::WebOSKeyMask WebAppWayland::KeyMaskFromJson(const Json::Value& value) {
+  unsigned int key_mask = 0;
+  if (value.isArray()) {
+    for (const auto& child : value) {
+      key_mask |= GetKeyMask(child.asString());
+    }
+  }
+  return static_cast<webos::WebOSKeyMask>(key_mask);
 }
 
 void WebAppWayland::SetWindowProperty(const std::string& name,
@@ -447,18 +509,13 @@ void WebAppWayland::SetCursor(const std::string& cursor_arg,
 }
 
 void WebAppWayland::SetKeyMask(const Json::Value& value) {
-  unsigned int key_mask = 0;
-  if (value.isArray()) {
-    for (const auto& child : value) {
-      key_mask |= GetKeyMask(child.asString());
-    }
-  }
-
-  app_window_->SetKeyMask(static_cast<webos::WebOSKeyMask>(key_mask));
+  SetKeyMask(KeyMaskFromJson(value));
 }
 
 void WebAppWayland::SetKeyMask(webos::WebOSKeyMask key_mask) {
-  app_window_->SetKeyMask(key_mask);
+  if (key_mask_update_.Update(key_mask)) {
+    SendKeyMask();
+  }
 }
 
 void WebAppWayland::FocusOwner() {
@@ -555,6 +612,7 @@ void WebAppWayland::Raise() {
     Page()->ResumeWebPageAll();
     Page()->SetVisibilityState(
         WebPageBase::WebPageVisibilityState::kWebPageVisibilityStateVisible);
+    UpdateSettings();
   }
 }
 
@@ -744,6 +802,9 @@ void WebAppWayland::WebViewRecreated() {
 }
 
 void WebAppWayland::DidSwapPageCompositorFrame() {
+  FlushWindowUpdates();
+  WebAppManager::Instance()->GetInputLatencyTracker()->OnFrameSwapped(
+      InstanceAtom());
   if (!did_activate_stage_ && !GetHiddenWindow() &&
       preload_state_ == kNonePreload) {
     LOG_INFO(MSGID_WAM_DEBUG, 2, PMLOGKS("APP_ID", AppId().c_str()),
@@ -826,6 +887,8 @@ void WebAppWayland::MoveInputRegion(int height) {
   }
   input_region_.clear();
   input_region_ = std::move(new_region);
+  // The window no longer has the region set last by the page.
+  input_region_update_.Invalidate();
   app_window_->SetInputRegion(input_region_);
 }
 
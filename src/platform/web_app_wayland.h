@@ -20,12 +20,14 @@
 #include <memory>
 #include <optional>
 #include <string>
+#include <vector>
 
 #include "webos/common/webos_constants.h"
 #include "webos/common/webos_event.h"
 #include "webos/webos_platform.h"
 
 #include "display_id.h"
+#include "frame_coalesced_value.h"
 #include "timer.h"
 #include "web_app_base.h"
 #include "web_app_window.h"
@@ -118,6 +120,9 @@ class WebAppWayland : public WebAppBase, WebPageBlinkObserver {
   void SetDisplayFirstActivateTimeoutMs(uint32_t timeout) override;
 
   // WebAppWayland
+  // |region| is in page coordinates. Like SetKeyMask(), unchanged values are
+  // not sent to the window and updates are sent at most once per frame.
+  void SetInputRegion(const std::vector<gfx::Rect>& region);
   virtual void SetKeyMask(webos::WebOSKeyMask key_mask, bool value);
   virtual void SetKeyMask(webos::WebOSKeyMask key_mask);
   virtual void FocusOwner();
@@ -128,6 +133,9 @@ class WebAppWayland : public WebAppBase, WebPageBlinkObserver {
   void FirstFrameVisuallyCommitted() override;
   void NavigationHistoryChanged() override;
 
+  static std::vector<gfx::Rect> InputRegionFromJson(const Json::Value& value);
+  static webos::WebOSKeyMask KeyMaskFromJson(const Json::Value& value);
+
   std::string GetWindowType() const { return window_type_; }
   bool CursorVisibility() {
     return InputManager::Instance()->GlobalCursorVisibility();
@@ -139,6 +147,8 @@ class WebAppWayland : public WebAppBase, WebPageBlinkObserver {
   void OnLaunchTimeout();
 
   void ApplyInputRegion();
+  // Sends the input region and key mask updates held back in the last frame.
+  void FlushWindowUpdates();
   void ForwardWebOSEvent(WebOSEvent* event) const;
   void StateAboutToChange(webos::NativeWindowState will_be);
   void StateChanged(webos::NativeWindowState new_state);
@@ -163,6 +173,8 @@ class WebAppWayland : public WebAppBase, WebPageBlinkObserver {
 
  private:
   void Init(std::optional<int> width, std::optional<int> height);
+  void SendInputRegion();
+  void SendKeyMask();
 
   std::unique_ptr<WebAppWindow> app_window_;
   std::string window_type_;
@@ -171,6 +183,10 @@ class WebAppWayland : public WebAppBase, WebPageBlinkObserver {
 
   std::vector<gfx::Rect> input_region_;
   bool enable_input_region_ = false;
+  FrameCoalescedValue<std::vector<gfx::Rect>> input_region_update_;
+  FrameCoalescedValue<webos::WebOSKeyMask> key_mask_update_;
+  // Ends the frame of the window updates if no compositor frame is swapped.
+  OneShotTimer<WebAppWayland> window_update_timer_;
 
   bool is_focused_ = false;
   float vkb_height_ = 0;
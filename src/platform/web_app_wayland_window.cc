@@ -16,10 +16,18 @@
 
 #include "web_app_wayland_window.h"
 #include "application_description.h"
+#include "input_latency_tracker.h"
 #include "log_manager.h"
 #include "utils.h"
+#include "web_app_manager.h"
 #include "web_app_wayland.h"
 
+namespace {
+
+constexpr int kPointerFrameMs = 16;
+
+}  // namespace
+
 WebAppWaylandWindow* WebAppWaylandWindow::instance_ = nullptr;
 
 WebAppWaylandWindow* WebAppWaylandWindow::Take() {
@@ -117,12 +125,59 @@ void WebAppWaylandWindow::AttachWebContentsToWindow(void* web_contents) {
   WebAppWindowBase::AttachWebContents(web_contents);
 }
 
+void WebAppWaylandWindow::TrackInputLatency(WebOSEvent* event) {
+  InputLatencyTracker* tracker =
+      WebAppManager::Instance()->GetInputLatencyTracker();
+  if (!tracker->IsEnabled()) {
+    return;
+  }
+
+  InputLatencyTracker::EventType type;
+  switch (event->GetType()) {
+    case WebOSEvent::KeyPress:
+    case WebOSEvent::KeyRelease:
+      type = InputLatencyTracker::EventType::kKey;
+      break;
+    case WebOSEvent::MouseButtonPress:
+    case WebOSEvent::MouseButtonRelease:
+      type = InputLatencyTracker::EventType::kMouseButton;
+      break;
+    case WebOSEvent::MouseMove:
+      type = InputLatencyTracker::EventType::kMouseMove;
+      break;
+    case WebOSEvent::Wheel:
+      type = InputLatencyTracker::EventType::kWheel;
+      break;
+    default:
+      return;
+  }
+  tracker->OnInput(web_app_->AppAtom(), web_app_->InstanceAtom(), type);
+}
+
 bool WebAppWaylandWindow::HandleWebOSEvent(WebOSEvent* event) {
   if (!web_app_) {
     return true;
   }
 
-  LogEventDebugging(event);
+  // Before the coalescing, so merged moves are measured from their arrival.
+  TrackInputLatency(event);
+
+  if (event->GetType() == WebOSEvent::MouseMove) {
+    if (CoalesceMouseMove(static_cast<WebOSMouseEvent*>(event))) {
+      return true;
+    }
+  } else if (event->GetType() == WebOSEvent::Swap) {
+    EndPointerFrame();
+  } else {
+    FlushMouseMove();
+  }
+
+  // Keeps the log arguments of every event from being evaluated unless one
+  // of the event debug logs is on.
+  if (LogManager::GetDebugEventsEnabled() ||
+      LogManager::GetDebugMouseMoveEnabled()) {
+    LogEventDebugging(event);
+  }
 
   switch (event->GetType()) {
     case WebOSEvent::Close:
@@ -238,22 +293,78 @@ bool WebAppWaylandWindow::OnCursorVisibileChangeEvent(WebOSEvent* /*e*/) {
   return false;
 }
 
-unsigned int WebAppWaylandWindow::CheckKeyFilterTable(unsigned keycode,
-                                                      unsigned* modifier) {
-  auto table = web_app_->GetAppDescription()->KeyFilterTable();
+bool WebAppWaylandWindow::CoalesceMouseMove(WebOSMouseEvent* event) {
+  // Without the cursor, moves are dropped anyway.
+  if (!cursor_enabled_ ||
+      !web_app_->GetAppDescription()->CoalescePointerEvents()) {
+    return false;
+  }
 
-  if (table.empty()) {
-    return 0;
+  ++pointer_move_stats_.moves;
+  if (!move_forwarded_in_frame_) {
+    ++pointer_move_stats_.forwarded;
+    forwarded_move_x_ = event->GetX();
+    forwarded_move_y_ = event->GetY();
+    StartPointerFrame();
+    return false;
+  }
+
+  ++pointer_move_stats_.coalesced;
+  pending_move_ = *event;
+  return true;
+}
+
+void WebAppWaylandWindow::FlushMouseMove() {
+  if (!pending_move_) {
+    return;
+  }
+  if (!web_app_ || !web_app_->Page()) {
+    pending_move_.reset();
+    return;
   }
 
-  auto found = table.find(keycode);
-  if (found == table.end()) {
+  if (LogManager::GetDebugMouseMoveEnabled()) {
+    LOG_DEBUG("[%s] Forward merged mouse move; dx: %.f, dy: %.f",
+              web_app_->AppId().c_str(),
+              pending_move_->GetX() - forwarded_move_x_,
+              pending_move_->GetY() - forwarded_move_y_);
+  }
+  ++pointer_move_stats_.forwarded;
+  forwarded_move_x_ = pending_move_->GetX();
+  forwarded_move_y_ = pending_move_->GetY();
+  WebOSMouseEvent move = *pending_move_;
+  pending_move_.reset();
+  web_app_->ForwardWebOSEvent(&move);
+}
+
+void WebAppWaylandWindow::StartPointerFrame() {
+  move_forwarded_in_frame_ = true;
+  if (!pointer_frame_timer_.IsRunning()) {
+    pointer_frame_timer_.StartWithReceiver(
+        kPointerFrameMs, this, &WebAppWaylandWindow::EndPointerFrame);
+  }
+}
+
+void WebAppWaylandWindow::EndPointerFrame() {
+  pointer_frame_timer_.Stop();
+  move_forwarded_in_frame_ = false;
+  if (pending_move_) {
+    FlushMouseMove();
+    StartPointerFrame();
+  }
+}
+
+unsigned int WebAppWaylandWindow::CheckKeyFilterTable(unsigned keycode,
+                                                      unsigned* modifier) {
+  const KeyFilter::Entry* entry =
+      web_app_->GetAppDescription()->GetKeyFilter().Find(keycode);
+  if (!entry) {
     return 0;
   }
 
-  *modifier = found->second.second;
+  *modifier = entry->modifier;
 
-  return found->second.first;
+  return entry->to;
 }
 
 void WebAppWaylandWindow::LogEventDebugging(WebOSEvent* event) {
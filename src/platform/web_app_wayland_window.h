@@ -17,8 +17,13 @@
 #ifndef PLATFORM_WEB_APP_WAYLAND_WINDOW_H_
 #define PLATFORM_WEB_APP_WAYLAND_WINDOW_H_
 
+#include <cstdint>
+#include <optional>
+
 #include "webos/webapp_window_base.h"
 
+#include "timer.h"
+
 class WebAppWayland;
 
 class WebAppWaylandWindow : public webos::WebAppWindowBase {
@@ -45,6 +50,15 @@ class WebAppWaylandWindow : public webos::WebAppWindowBase {
 
   void DidSwapPageCompositorFrame();
 
+  struct PointerMoveStats {
+    uint64_t moves = 0;
+    uint64_t forwarded = 0;
+    uint64_t coalesced = 0;
+  };
+  const PointerMoveStats& GetPointerMoveStats() const {
+    return pointer_move_stats_;
+  }
+
   // webos::WebAppWindowBase
   bool HandleWebOSEvent(WebOSEvent* event) override;
   unsigned int CheckKeyFilterTable(unsigned key_code,
@@ -61,6 +75,17 @@ class WebAppWaylandWindow : public webos::WebAppWindowBase {
   bool OnCursorVisibileChangeEvent(WebOSEvent* e);
   static WebAppWaylandWindow* CreateWindow();
   void LogEventDebugging(WebOSEvent* event);
+  // Timestamps input events for the input to frame latency histograms.
+  void TrackInputLatency(WebOSEvent* event);
+
+  // Mouse moves are forwarded at most once per frame: the first move of a
+  // frame goes to the engine at once, later ones are merged and the last
+  // position is forwarded when the frame is swapped. Any other event
+  // forwards the merged move first, so the event order is kept.
+  bool CoalesceMouseMove(WebOSMouseEvent* event);
+  void FlushMouseMove();
+  void StartPointerFrame();
+  void EndPointerFrame();
 
   static WebAppWaylandWindow* instance_;
 
@@ -71,6 +96,15 @@ class WebAppWaylandWindow : public webos::WebAppWindowBase {
   bool xinput_activated_ = false;
 
   WebOSMouseEvent last_mouse_event_{WebOSEvent::None, -1., -1.};
+
+  std::optional<WebOSMouseEvent> pending_move_;
+  // Position of the last move the engine got, to log the merged distance.
+  float forwarded_move_x_ = 0;
+  float forwarded_move_y_ = 0;
+  bool move_forwarded_in_frame_ = false;
+  // Ends the frame if no frame is swapped, e.g. when the page is static.
+  OneShotTimer<WebAppWaylandWindow> pointer_frame_timer_;
+  PointerMoveStats pointer_move_stats_;
 };
 
 #endif  // PLATFORM_WEB_APP_WAYLAND_WINDOW_H_
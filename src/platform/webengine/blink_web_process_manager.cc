@@ -14,8 +14,11 @@
 //
 // SPDX-License-Identifier: Apache-2.0
 
-#include <set>
-#include <unordered_map>
+#include <list>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
 
 #include <json/json.h>
 
@@ -33,42 +36,48 @@ uint32_t BlinkWebProcessManager::GetWebProcessPID(const WebAppBase* app) const {
 }
 
 Json::Value BlinkWebProcessManager::GetWebProcessProfiling() {
-  Json::Value reply;
-  Json::Value process_array(Json::arrayValue);
-  Json::Value process_object;
+  return GetWebProcessProfilingTask()();
+}
 
-  std::set<uint32_t> process_id_list;
-  std::unordered_multimap<uint32_t, WebAppBase*> running_app_list;
+WebProcessManager::ProfilingTask
+BlinkWebProcessManager::GetWebProcessProfilingTask() {
+  // Instance and app ids of the running apps by web process.
+  using AppIds = std::vector<std::pair<std::string, std::string>>;
+  std::map<uint32_t, AppIds> processes;
 
   const std::list<const WebAppBase*>& running = RunningApps();
 
   for (const auto& elem : running) {
     WebAppBase* app = FindAppByInstanceId((elem)->InstanceId());
     const uint32_t pid = GetWebProcessPID(app);
-    process_id_list.insert(pid);
-    running_app_list.emplace(pid, app);
+    processes[pid].emplace_back(app->AppId(), app->InstanceId());
   }
 
-  for (uint32_t pid : process_id_list) {
-    Json::Value app_object;
-    Json::Value app_array(Json::arrayValue);
+  return [this, processes = std::move(processes)] {
+    Json::Value reply;
+    Json::Value process_array(Json::arrayValue);
+    Json::Value process_object;
+
+    for (const auto& [pid, apps] : processes) {
+      Json::Value app_object;
+      Json::Value app_array(Json::arrayValue);
 
-    process_object["pid"] = std::to_string(pid);
-    process_object["webProcessSize"] = GetWebProcessMemSize(pid);
-    process_object["tileSize"] = 0;
-    auto processes = running_app_list.equal_range(pid);
-    for (auto app = processes.first; app != processes.second; app++) {
-      app_object["id"] = app->second->AppId();
-      app_object["instanceId"] = app->second->InstanceId();
-      app_array.append(app_object);
+      process_object["pid"] = std::to_string(pid);
+      process_object["webProcessSize"] = GetWebProcessMemSize(pid);
+      process_object["tileSize"] = 0;
+      for (const auto& [app_id, instance_id] : apps) {
+        app_object["id"] = app_id;
+        app_object["instanceId"] = instance_id;
+        app_array.append(app_object);
+      }
+      process_object["runningApps"] = std::move(app_array);
+      process_array.append(process_object);
     }
-    process_object["runningApps"] = std::move(app_array);
-    process_array.append(process_object);
-  }
 
-  reply["WebProcesses"] = std::move(process_array);
-  reply["returnValue"] = true;
-  return reply;
+    reply["WebProcesses"] = std::move(process_array);
+    reply["returnValue"] = true;
+    return reply;
+  };
 }
 
 void BlinkWebProcessManager::ClearBrowsingData(
@@ -31,6 +31,7 @@ class BlinkWebProcessManager : public WebProcessManager {
  public:
   // WebProcessManager
   Json::Value GetWebProcessProfiling() override;
+  ProfilingTask GetWebProcessProfilingTask() override;
   uint32_t GetWebProcessPID(const WebAppBase* app) const override;
   void ClearBrowsingData(const int remove_browsing_data_mask) override;
   int MaskForBrowsingDataType(const char* type) override;
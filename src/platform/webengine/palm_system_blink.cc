@@ -14,10 +14,17 @@
 //
 // SPDX-License-Identifier: Apache-2.0
 
+#include <array>
+#include <iterator>
+#include <memory>
+#include <string_view>
+
 #include "json/json.h"
 
 #include "application_description.h"
+#include "device_info_snapshot.h"
 #include "log_manager.h"
+#include "metrics_registry.h"
 #include "palm_system_blink.h"
 #include "utils.h"
 #include "web_app_base.h"
@@ -26,155 +33,416 @@
 
 namespace {
 
+CounterFamily command_calls("wam_palmsystem_commands_total",
+                            "webOSSystem commands called by pages",
+                            "command");
+CounterFamily unknown_command_calls(
+    "wam_palmsystem_unknown_commands_total",
+    "webOSSystem calls of commands that do not exist");
+
 const char* toStr(const bool value) {
   return value ? "true" : "false";
 }
 
+struct SharedPayload {
+  // Snapshot the payload was built from, null if it was never built.
+  std::shared_ptr<const DeviceInfoSnapshot> device_info;
+  Json::Value data;
+  PalmSystemBlink::InitializePayloadStats stats;
+};
+
+SharedPayload& GetSharedPayload() {
+  static SharedPayload payload;
+  return payload;
+}
+
+// Slots of the command lookup table; a power of two a few times larger than
+// the number of commands, so a collision free seed is found quickly.
+constexpr size_t kCommandSlots = 128;
+constexpr uint8_t kNoCommand = 0xff;
+
+// FNV-1a, with |seed| mixed into the offset basis.
+constexpr uint32_t CommandHash(std::string_view name, uint32_t seed) {
+  uint32_t hash = 2166136261u ^ seed;
+  for (char c : name) {
+    hash ^= static_cast<uint8_t>(c);
+    hash *= 16777619u;
+  }
+  return hash;
+}
+
+// Perfect hash of a fixed set of names, built at compile time: a seed is
+// searched for which every name gets its own slot, so a lookup is one hash
+// and one string compare.
+template <size_t N>
+class CommandIndex {
+ public:
+  static_assert(N < kNoCommand, "Too many commands");
+
+  template <typename Entry>
+  constexpr explicit CommandIndex(const Entry (&entries)[N]) {
+    for (size_t i = 0; i < N; ++i) {
+      names_[i] = entries[i].name;
+    }
+    while (!TrySeed()) {
+      ++seed_;
+    }
+  }
+
+  // Returns the index of |name|, N if it isn't one of the names.
+  constexpr size_t Find(std::string_view name) const {
+    const uint8_t index = slots_[CommandHash(name, seed_) % kCommandSlots];
+    return index != kNoCommand && names_[index] == name ? index : N;
+  }
+
+ private:
+  constexpr bool TrySeed() {
+    for (auto& slot : slots_) {
+      slot = kNoCommand;
+    }
+    for (size_t i = 0; i < N; ++i) {
+      uint8_t& slot = slots_[CommandHash(names_[i], seed_) % kCommandSlots];
+      if (slot != kNoCommand) {
+        return false;
+      }
+      slot = static_cast<uint8_t>(i);
+    }
+    return true;
+  }
+
+  uint32_t seed_ = 0;
+  std::string_view names_[N] = {};
+  uint8_t slots_[kCommandSlots] = {};
+};
+
 }  // namespace
 
-PalmSystemBlink::PalmSystemBlink(WebAppBase* app) : PalmSystemWebOS(app) {}
+struct PalmSystemBlink::Commands {
+  using Arguments = std::vector<std::string>;
+  using Handler = std::string (*)(PalmSystemBlink* self,
+                                  const Arguments& arguments);
 
-std::string PalmSystemBlink::HandleBrowserControlMessage(
-    const std::string& command,
-    const std::vector<std::string>& arguments) {
-  if (command == "initialize") {
-    return util::JsonToString(Initialize());
-  } else if (command == "country") {
-    return Country();
-  } else if (command == "locale") {
-    return Locale();
-  } else if (command == "localeRegion") {
-    return LocaleRegion();
-  } else if (command == "isMinimal") {
-    return toStr(IsMinimal());
-  } else if (command == "identifier") {
-    return Identifier();
-  } else if (command == "screenOrientation") {
-    return ScreenOrientation();
-  } else if (command == "currentCountryGroup") {
-    return GetDeviceInfo("CountryGroup");
-  } else if (command == "stageReady") {
-    StageReady();
-  } else if (command == "activate") {
-    LOG_INFO(MSGID_PALMSYSTEM, 3, PMLOGKS("APP_ID", app_->AppId().c_str()),
-             PMLOGKS("INSTANCE_ID", app_->InstanceId().c_str()),
-             PMLOGKFV("PID", "%d", app_->Page()->GetWebProcessPID()),
+  struct Entry {
+    std::string_view name;
+    Handler handler;
+  };
+
+  static std::string Initialize(PalmSystemBlink* self, const Arguments&) {
+    return util::JsonToString(self->Initialize());
+  }
+
+  static std::string Country(PalmSystemBlink* self, const Arguments&) {
+    return self->SharedInitializePayload()["country"].asString();
+  }
+
+  static std::string Locale(PalmSystemBlink* self, const Arguments&) {
+    return self->SharedInitializePayload()["locale"].asString();
+  }
+
+  static std::string LocaleRegion(PalmSystemBlink* self, const Arguments&) {
+    return self->SharedInitializePayload()["localeRegion"].asString();
+  }
+
+  static std::string IsMinimal(PalmSystemBlink* self, const Arguments&) {
+    return toStr(self->IsMinimal());
+  }
+
+  static std::string Identifier(PalmSystemBlink* self, const Arguments&) {
+    return self->Identifier();
+  }
+
+  static std::string ScreenOrientation(PalmSystemBlink* self,
+                                       const Arguments&) {
+    return self->SharedInitializePayload()["screenOrientation"].asString();
+  }
+
+  static std::string CurrentCountryGroup(PalmSystemBlink* self,
+                                         const Arguments&) {
+    return self->SharedInitializePayload()["currentCountryGroup"].asString();
+  }
+
+  static std::string StageReady(PalmSystemBlink* self, const Arguments&) {
+    self->StageReady();
+    return std::string();
+  }
+
+  static std::string Activate(PalmSystemBlink* self, const Arguments&) {
+    WebAppBase* app = self->app_;
+    LOG_INFO(MSGID_PALMSYSTEM, 3, PMLOGKS("APP_ID", app->AppId().c_str()),
+             PMLOGKS("INSTANCE_ID", app->InstanceId().c_str()),
+             PMLOGKFV("PID", "%d", app->Page()->GetWebProcessPID()),
              "webOSSystem.activate()");
-    Activate();
-  } else if (command == "deactivate") {
-    LOG_INFO(MSGID_PALMSYSTEM, 3, PMLOGKS("APP_ID", app_->AppId().c_str()),
-             PMLOGKS("INSTANCE_ID", app_->InstanceId().c_str()),
-             PMLOGKFV("PID", "%d", app_->Page()->GetWebProcessPID()),
+    self->Activate();
+    return std::string();
+  }
+
+  static std::string Deactivate(PalmSystemBlink* self, const Arguments&) {
+    WebAppBase* app = self->app_;
+    LOG_INFO(MSGID_PALMSYSTEM, 3, PMLOGKS("APP_ID", app->AppId().c_str()),
+             PMLOGKS("INSTANCE_ID", app->InstanceId().c_str()),
+             PMLOGKFV("PID", "%d", app->Page()->GetWebProcessPID()),
              "webOSSystem.deactivate()");
-    Deactivate();
-  } else if (command == "isActivated") {
-    return toStr(IsActivated());
-  } else if (command == "isKeyboardVisible") {
-    return toStr(IsKeyboardVisible());
-  } else if (command == "getIdentifier" || command == "identifier") {
-    return Identifier();
-  } else if (command == "launchParams") {
-    LOG_INFO(MSGID_PALMSYSTEM, 3, PMLOGKS("APP_ID", app_->AppId().c_str()),
-             PMLOGKS("INSTANCE_ID", app_->InstanceId().c_str()),
-             PMLOGKFV("PID", "%d", app_->Page()->GetWebProcessPID()),
+    self->Deactivate();
+    return std::string();
+  }
+
+  static std::string IsActivated(PalmSystemBlink* self, const Arguments&) {
+    return toStr(self->IsActivated());
+  }
+
+  static std::string IsKeyboardVisible(PalmSystemBlink* self,
+                                       const Arguments&) {
+    return toStr(self->IsKeyboardVisible());
+  }
+
+  static std::string LaunchParams(PalmSystemBlink* self,
+                                  const Arguments& arguments) {
+    WebAppBase* app = self->app_;
+    LOG_INFO(MSGID_PALMSYSTEM, 3, PMLOGKS("APP_ID", app->AppId().c_str()),
+             PMLOGKS("INSTANCE_ID", app->InstanceId().c_str()),
+             PMLOGKFV("PID", "%d", app->Page()->GetWebProcessPID()),
              "webOSSystem.launchParams Updated by app; %s",
              arguments[0].c_str());
-    UpdateLaunchParams(arguments[0]);
-  } else if (command == "screenOrientation") {
-    return ScreenOrientation();
-  } else if (command == "keepAlive") {
+    self->UpdateLaunchParams(arguments[0]);
+    return std::string();
+  }
+
+  static std::string KeepAlive(PalmSystemBlink* self,
+                               const Arguments& arguments) {
     if (arguments.size() > 0) {
-      SetKeepAlive(arguments[0] == "true");
+      self->SetKeepAlive(arguments[0] == "true");
     }
-  } else if (command == "PmLogInfoWithClock") {
+    return std::string();
+  }
+
+  static std::string PmLogInfoWithClock(PalmSystemBlink* self,
+                                        const Arguments& arguments) {
     if (arguments.size() == 3) {
-      LogMsgWithClock(arguments[0], arguments[1], arguments[2]);
+      self->LogMsgWithClock(arguments[0], arguments[1], arguments[2]);
     }
-  } else if (command == "PmLogString") {
+    return std::string();
+  }
+
+  static std::string PmLogString(PalmSystemBlink* self,
+                                 const Arguments& arguments) {
     if (arguments.size() > 3) {
       int32_t v1;
       if (util::StrToInt(arguments[0], v1)) {
-        LogMsgString(v1, arguments[1], arguments[2], arguments[3]);
+        self->LogMsgString(v1, arguments[1], arguments[2], arguments[3]);
       }
     }
-  } else if (command == "setWindowProperty") {
+    return std::string();
+  }
+
+  static std::string SetWindowProperty(PalmSystemBlink* self,
+                                       const Arguments& arguments) {
     if (arguments.size() > 1) {
-      LOG_INFO(MSGID_PALMSYSTEM, 3, PMLOGKS("APP_ID", app_->AppId().c_str()),
-               PMLOGKS("INSTANCE_ID", app_->InstanceId().c_str()),
-               PMLOGKFV("PID", "%d", app_->Page()->GetWebProcessPID()),
+      WebAppBase* app = self->app_;
+      LOG_INFO(MSGID_PALMSYSTEM, 3, PMLOGKS("APP_ID", app->AppId().c_str()),
+               PMLOGKS("INSTANCE_ID", app->InstanceId().c_str()),
+               PMLOGKFV("PID", "%d", app->Page()->GetWebProcessPID()),
                "webOSSystem.window.setProperty('%s', '%s')",
                arguments[0].c_str(), arguments[1].c_str());
-      app_->SetWindowProperty(arguments[0], arguments[1]);
+      app->SetWindowProperty(arguments[0], arguments[1]);
     }
-  } else if (command == "platformBack") {
-    LOG_INFO(MSGID_PALMSYSTEM, 3, PMLOGKS("APP_ID", app_->AppId().c_str()),
-             PMLOGKS("INSTANCE_ID", app_->InstanceId().c_str()),
-             PMLOGKFV("PID", "%d", app_->Page()->GetWebProcessPID()),
+    return std::string();
+  }
+
+  static std::string PlatformBack(PalmSystemBlink* self, const Arguments&) {
+    WebAppBase* app = self->app_;
+    LOG_INFO(MSGID_PALMSYSTEM, 3, PMLOGKS("APP_ID", app->AppId().c_str()),
+             PMLOGKS("INSTANCE_ID", app->InstanceId().c_str()),
+             PMLOGKFV("PID", "%d", app->Page()->GetWebProcessPID()),
              "webOSSystem.platformBack()");
-    app_->PlatformBack();
-  } else if (command == "setCursor") {
+    app->PlatformBack();
+    return std::string();
+  }
+
+  static std::string SetCursor(PalmSystemBlink* self,
+                               const Arguments& arguments) {
     if (arguments.size() == 3) {
       std::string v1 = arguments[0];
       int32_t v2, v3;
       const bool v2_conversion = util::StrToInt(arguments[1], v2);
       const bool v3_conversion = util::StrToInt(arguments[2], v3);
       if (v2_conversion && v3_conversion) {
-        app_->SetCursor(v1, v2, v3);
+        self->app_->SetCursor(v1, v2, v3);
       }
     }
-  } else if (command == "setInputRegion") {
+    return std::string();
+  }
+
+  static std::string SetInputRegion(PalmSystemBlink* self,
+                                    const Arguments& arguments) {
     std::string data;
     for (const auto& argument : arguments) {
       data.append(argument);
     }
-    SetInputRegion(data);
-  } else if (command == "setKeyMask") {
+    self->SetInputRegion(data);
+    return std::string();
+  }
+
+  static std::string SetKeyMask(PalmSystemBlink* self,
+                                const Arguments& arguments) {
     std::string data;
     for (const auto& argument : arguments) {
       data.append(argument);
     }
-    SetGroupClientEnvironment(kKeyMask, data);
-  } else if (command == "focusOwner") {
-    SetGroupClientEnvironment(kFocusOwner, std::string());
-  } else if (command == "focusLayer") {
-    SetGroupClientEnvironment(kFocusLayer, std::string());
-  } else if (command == "hide") {
-    Hide();
-  } else if (command == "setLoadErrorPolicy") {
+    self->SetGroupClientEnvironment(kKeyMask, data);
+    return std::string();
+  }
+
+  static std::string FocusOwner(PalmSystemBlink* self, const Arguments&) {
+    self->SetGroupClientEnvironment(kFocusOwner, std::string());
+    return std::string();
+  }
+
+  static std::string FocusLayer(PalmSystemBlink* self, const Arguments&) {
+    self->SetGroupClientEnvironment(kFocusLayer, std::string());
+    return std::string();
+  }
+
+  static std::string Hide(PalmSystemBlink* self, const Arguments&) {
+    self->Hide();
+    return std::string();
+  }
+
+  static std::string SetLoadErrorPolicy(PalmSystemBlink* self,
+                                        const Arguments& arguments) {
     if (arguments.size() > 0) {
-      LOG_INFO(MSGID_PALMSYSTEM, 3, PMLOGKS("APP_ID", app_->AppId().c_str()),
-               PMLOGKS("INSTANCE_ID", app_->InstanceId().c_str()),
-               PMLOGKFV("PID", "%d", app_->Page()->GetWebProcessPID()),
+      WebAppBase* app = self->app_;
+      LOG_INFO(MSGID_PALMSYSTEM, 3, PMLOGKS("APP_ID", app->AppId().c_str()),
+               PMLOGKS("INSTANCE_ID", app->InstanceId().c_str()),
+               PMLOGKFV("PID", "%d", app->Page()->GetWebProcessPID()),
                "webOSSystem.setLoadErrorPolicy(%s)", arguments[0].c_str());
-      SetLoadErrorPolicy(arguments[0]);
+      self->SetLoadErrorPolicy(arguments[0]);
     }
-  } else if (command == "onCloseNotify") {
+    return std::string();
+  }
+
+  static std::string OnCloseNotify(PalmSystemBlink* self,
+                                   const Arguments& arguments) {
     if (arguments.size() > 0) {
-      LOG_INFO(MSGID_PALMSYSTEM, 3, PMLOGKS("APP_ID", app_->AppId().c_str()),
-               PMLOGKS("INSTANCE_ID", app_->InstanceId().c_str()),
-               PMLOGKFV("PID", "%d", app_->Page()->GetWebProcessPID()),
+      WebAppBase* app = self->app_;
+      LOG_INFO(MSGID_PALMSYSTEM, 3, PMLOGKS("APP_ID", app->AppId().c_str()),
+               PMLOGKS("INSTANCE_ID", app->InstanceId().c_str()),
+               PMLOGKFV("PID", "%d", app->Page()->GetWebProcessPID()),
                "webOSSystem.onCloseNotify(%s)", arguments[0].c_str());
-      OnCloseNotify(arguments[0]);
+      self->OnCloseNotify(arguments[0]);
     }
-  } else if (command == "cursorVisibility") {
-    return toStr(CursorVisibility());
-  } else if (command == "serviceCall") {
-    if (app_->Page()->IsClosing()) {
-      LOG_INFO(MSGID_PALMSYSTEM, 3, PMLOGKS("APP_ID", app_->AppId().c_str()),
-               PMLOGKS("INSTANCE_ID", app_->InstanceId().c_str()),
-               PMLOGKFV("PID", "%d", app_->Page()->GetWebProcessPID()),
+    return std::string();
+  }
+
+  static std::string CursorVisibility(PalmSystemBlink* self,
+                                      const Arguments&) {
+    return toStr(self->CursorVisibility());
+  }
+
+  static std::string ServiceCall(PalmSystemBlink* self,
+                                 const Arguments& arguments) {
+    WebAppBase* app = self->app_;
+    if (app->Page()->IsClosing()) {
+      LOG_INFO(MSGID_PALMSYSTEM, 3, PMLOGKS("APP_ID", app->AppId().c_str()),
+               PMLOGKS("INSTANCE_ID", app->InstanceId().c_str()),
+               PMLOGKFV("PID", "%d", app->Page()->GetWebProcessPID()),
                "webOSSystem.serviceCall(%s, %s)", arguments[0].c_str(),
                arguments[1].c_str());
-      app_->ServiceCall(arguments[0], arguments[1], app_->AppId());
+      app->ServiceCall(arguments[0], arguments[1], app->AppId());
     } else {
       LOG_WARNING(
-          MSGID_SERVICE_CALL_FAIL, 3, PMLOGKS("APP_ID", app_->AppId().c_str()),
-          PMLOGKS("INSTANCE_ID", app_->InstanceId().c_str()),
+          MSGID_SERVICE_CALL_FAIL, 3, PMLOGKS("APP_ID", app->AppId().c_str()),
+          PMLOGKS("INSTANCE_ID", app->InstanceId().c_str()),
           PMLOGKS("URL", arguments[0].c_str()), "Page is NOT in closing");
     }
+    return std::string();
+  }
+
+  static constexpr Entry kTable[] = {
+      {"initialize", &Initialize},
+      {"country", &Country},
+      {"locale", &Locale},
+      {"localeRegion", &LocaleRegion},
+      {"isMinimal", &IsMinimal},
+      {"identifier", &Identifier},
+      {"getIdentifier", &Identifier},
+      {"screenOrientation", &ScreenOrientation},
+      {"currentCountryGroup", &CurrentCountryGroup},
+      {"stageReady", &StageReady},
+      {"activate", &Activate},
+      {"deactivate", &Deactivate},
+      {"isActivated", &IsActivated},
+      {"isKeyboardVisible", &IsKeyboardVisible},
+      {"launchParams", &LaunchParams},
+      {"keepAlive", &KeepAlive},
+      {"PmLogInfoWithClock", &PmLogInfoWithClock},
+      {"PmLogString", &PmLogString},
+      {"setWindowProperty", &SetWindowProperty},
+      {"platformBack", &PlatformBack},
+      {"setCursor", &SetCursor},
+      {"setInputRegion", &SetInputRegion},
+      {"setKeyMask", &SetKeyMask},
+      {"focusOwner", &FocusOwner},
+      {"focusLayer", &FocusLayer},
+      {"hide", &Hide},
+      {"setLoadErrorPolicy", &SetLoadErrorPolicy},
+      {"onCloseNotify", &OnCloseNotify},
+      {"cursorVisibility", &CursorVisibility},
+      {"serviceCall", &ServiceCall},
+  };
+  static constexpr size_t kCount = std::size(kTable);
+  static constexpr CommandIndex<kCount> kIndex{kTable};
+
+  // Counter of every command, the last one counts the unknown ones. They
+  // are looked up once so dispatching does not take the registry lock.
+  static MetricCounter& CallCounter(size_t index) {
+    static const std::array<MetricCounter*, kCount + 1> counters = [] {
+      std::array<MetricCounter*, kCount + 1> result;
+      for (size_t i = 0; i < kCount; ++i) {
+        result[i] = &command_calls.WithLabel(kTable[i].name);
+      }
+      result[kCount] = &unknown_command_calls.Get();
+      return result;
+    }();
+    return *counters[index];
   }
+};
 
-  return std::string();
+PalmSystemBlink::PalmSystemBlink(WebAppBase* app) : PalmSystemWebOS(app) {}
+
+std::string PalmSystemBlink::HandleBrowserControlMessage(
+    const std::string& command,
+    const std::vector<std::string>& arguments) {
+  const size_t index = Commands::kIndex.Find(command);
+  Commands::CallCounter(index).Increment();
+  if (index == Commands::kCount) {
+    LOG_WARNING_RATE_LIMITED(1, 10, MSGID_PALMSYSTEM, 2,
+                             PMLOGKS("APP_ID", app_->AppId().c_str()),
+                             PMLOGKS("INSTANCE_ID", app_->InstanceId().c_str()),
+                             "Unknown webOSSystem command '%s'",
+                             command.c_str());
+    return std::string();
+  }
+
+  return Commands::kTable[index].handler(this, arguments);
+}
+
+std::vector<std::string_view> PalmSystemBlink::CommandNames() {
+  std::vector<std::string_view> names;
+  names.reserve(Commands::kCount);
+  for (const auto& entry : Commands::kTable) {
+    names.push_back(entry.name);
+  }
+  return names;
+}
+
+uint64_t PalmSystemBlink::CommandCount(std::string_view command) {
+  const size_t index = Commands::kIndex.Find(command);
+  return index == Commands::kCount ? 0
+                                   : Commands::CallCounter(index).Value();
+}
+
+uint64_t PalmSystemBlink::UnknownCommandCount() {
+  return Commands::CallCounter(Commands::kCount).Value();
 }
 
 void PalmSystemBlink::SetCountry() {
@@ -226,22 +494,44 @@ double PalmSystemBlink::DevicePixelRatio() {
 Json::Value PalmSystemBlink::Initialize() {
   initialized_ = true;
 
-  Json::Value data;
-  data["launchParams"] = LaunchParams();
-  data["country"] = Country();
-  data["tvSystemName"] = GetDeviceInfo("TvSystemName");
-  data["currentCountryGroup"] = GetDeviceInfo("CountryGroup");
-  data["locale"] = Locale();
-  data["localeRegion"] = LocaleRegion();
+  Json::Value data = SharedInitializePayload();
   data["isMinimal"] = IsMinimal();
+  data["launchParams"] = LaunchParams();
   data["identifier"] = Identifier();
-  data["screenOrientation"] = ScreenOrientation();
-  data["deviceInfo"] = GetDeviceInfo("TvDeviceInfo");
   data["activityId"] = static_cast<double>(ActivityId());
-  data["phoneRegion"] = PhoneRegion();
   data["folderPath"] = app_->GetAppDescription()->FolderPath();
 
   data["devicePixelRatio"] = DevicePixelRatio();
   data["trustLevel"] = TrustLevel();
   return data;
 }
+
+const Json::Value& PalmSystemBlink::SharedInitializePayload() const {
+  SharedPayload& payload = GetSharedPayload();
+  std::shared_ptr<const DeviceInfoSnapshot> device_info =
+      GetDeviceInfoSnapshot();
+  if (payload.device_info == device_info) {
+    ++payload.stats.hits;
+    return payload.data;
+  }
+
+  ++payload.stats.builds;
+  Json::Value data(Json::objectValue);
+  data["country"] = Country();
+  data["tvSystemName"] = device_info->TvSystemName();
+  data["currentCountryGroup"] = device_info->CountryGroup();
+  data["locale"] = Locale();
+  data["localeRegion"] = LocaleRegion();
+  data["screenOrientation"] = ScreenOrientation();
+  data["deviceInfo"] = device_info->TvDeviceInfo();
+  data["phoneRegion"] = PhoneRegion();
+
+  payload.device_info = std::move(device_info);
+  payload.data = std::move(data);
+  return payload.data;
+}
+
+const PalmSystemBlink::InitializePayloadStats&
+PalmSystemBlink::GetInitializePayloadStats() {
+  return GetSharedPayload().stats;
+}
@@ -17,7 +17,9 @@
 #ifndef PLATFORM_WEBENGINE_PALM_SYSTEM_BLINK_H_
 #define PLATFORM_WEBENGINE_PALM_SYSTEM_BLINK_H_
 
+#include <cstdint>
 #include <string>
+#include <string_view>
 #include <vector>
 
 #include "palm_system_webos.h"
@@ -34,6 +36,24 @@ class PalmSystemBlink : public PalmSystemWebOS {
       const std::string& command,
       const std::vector<std::string>& arguments);
 
+  // Names of the commands HandleBrowserControlMessage() handles.
+  static std::vector<std::string_view> CommandNames();
+  // Number of calls of |command| from all pages, exported as the
+  // wam_palmsystem_commands_total metric. Calls of unknown commands are
+  // counted together in UnknownCommandCount().
+  static uint64_t CommandCount(std::string_view command);
+  static uint64_t UnknownCommandCount();
+
+  struct InitializePayloadStats {
+    uint64_t hits = 0;
+    uint64_t builds = 0;
+  };
+  // The page independent part of the initialize() payload is built once and
+  // shared by all pages until the device info, which holds the locale and
+  // the country, changes. isMinimal is not part of it, it changes when the
+  // first use app finishes.
+  static const InitializePayloadStats& GetInitializePayloadStats();
+
   // PalmSystemWebOS
   void SetCountry() override;
   void SetLaunchParams(const std::string& params) override;
@@ -53,6 +73,11 @@ class PalmSystemBlink : public PalmSystemWebOS {
   virtual void OnCloseNotify(const std::string& params);
 
  private:
+  // Handlers of the HandleBrowserControlMessage() commands.
+  struct Commands;
+
+  const Json::Value& SharedInitializePayload() const;
+
   bool initialized_ = false;
 };
 
@@ -26,6 +26,8 @@
 #include "application_description.h"
 #include "blink_web_process_manager.h"
 #include "blink_web_view.h"
+#include "error_page_resolver.h"
+#include "file_content_cache.h"
 #include "log_manager.h"
 #include "palm_system_blink.h"
 #include "url.h"
@@ -35,6 +37,7 @@
 #include "web_app_manager_utils.h"
 #include "web_page_blink_observer.h"
 #include "web_page_observer.h"
+#include "web_preference_profile.h"
 #include "web_view.h"
 #include "web_view_factory.h"
 #include "web_view_impl.h"
@@ -80,6 +83,8 @@ WebPageBlink::~WebPageBlink() {
 
 void WebPageBlink::Init() {
   page_private_->page_view_ = std::unique_ptr<WebView>(CreatePageView());
+  // A new view starts from the engine defaults.
+  preference_profile_.reset();
   page_private_->page_view_->SetDelegate(this);
   page_private_->page_view_->Initialize(
       app_desc_.Id() + std::to_string(app_desc_.GetDisplayAffinity()),
@@ -99,24 +104,16 @@ void WebPageBlink::Init() {
     page_private_->page_view_->AddAvailablePluginDir(privileged_plugin_path);
   }
 
-  page_private_->page_view_->SetAllowFakeBoldText(false);
-
-  // FIXME: It should be permitted for backward compatibility for a limited list
-  // of legacy applications only.
-  page_private_->page_view_->SetAllowRunningInsecureContent(true);
-  page_private_->page_view_->SetAllowScriptsToCloseWindows(true);
-  page_private_->page_view_->SetAllowUniversalAccessFromFileUrls(true);
-  page_private_->page_view_->SetSuppressesIncrementalRendering(true);
-  page_private_->page_view_->SetDisallowScrollbarsInMainFrame(true);
-  page_private_->page_view_->SetDisallowScrollingInMainFrame(true);
-  page_private_->page_view_->SetDoNotTrack(app_desc_.DoNotTrack());
-  page_private_->page_view_->SetJavascriptCanOpenWindows(true);
-  page_private_->page_view_->SetSupportsMultipleWindows(false);
-  page_private_->page_view_->SetCSSNavigationEnabled(true);
-  page_private_->page_view_->SetV8DateUseSystemLocaloffset(false);
-  page_private_->page_view_->SetLocalStorageEnabled(true);
-  page_private_->page_view_->SetShouldSuppressDialogs(true);
-  SetDisallowScrolling(app_desc_.DisallowScrollingInMainFrame());
+  // All pages of the same trust level and description flags share one
+  // profile; the individual values are committed with the single
+  // UpdatePreferences() call at the end of Init().
+  ApplyPreferenceProfile(
+      WebPreferenceProfile::Get(WebPreferenceProfile::KeyFor(app_desc_)));
+  if (preference_profile_->Has(
+          WebPreferenceProfile::Preference::kAllowLocalResourceLoad)) {
+    LOG_DEBUG("[%s] trustLevel : trusted; allow load local Resources",
+              AppId().c_str());
+  }
 
   if (app_desc_.NetworkStableTimeout().has_value() &&
       (app_desc_.NetworkStableTimeout().value() >= 0.0)) {
@@ -124,24 +121,6 @@ void WebPageBlink::Init() {
         app_desc_.NetworkStableTimeout().value());
   }
 
-  switch (app_desc_.GetThirdPartyCookiesPolicy()) {
-    case ApplicationDescription::ThirdPartyCookiesPolicy::kAllow:
-      page_private_->page_view_->SetAllowThirdPartyCookies(true);
-      break;
-    case ApplicationDescription::ThirdPartyCookiesPolicy::kDeny:
-      page_private_->page_view_->SetAllowThirdPartyCookies(false);
-      break;
-    default:
-      page_private_->page_view_->SetAllowThirdPartyCookies(
-          !(util::GetEnvVar("WAM_DEFAULT_ALLOW_THIRD_PARTY_COOKIES") == "0"));
-  }
-
-  if (app_desc_.TrustLevel() == "trusted") {
-    LOG_DEBUG("[%s] trustLevel : trusted; allow load local Resources",
-              AppId().c_str());
-    page_private_->page_view_->SetAllowLocalResourceLoad(true);
-  }
-
   if (app_desc_.CustomSuspendDOMTime().has_value() &&
       app_desc_.CustomSuspendDOMTime().value() > SuspendDelay()) {
     if (app_desc_.CustomSuspendDOMTime().value() > MaxCustomSuspendDelay()) {
@@ -161,13 +140,15 @@ void WebPageBlink::Init() {
 
   std::string language;
   GetSystemLanguage(language);
-  SetPreferredLanguages(language);
+  ApplyPreferredLanguages(language);
   page_private_->page_view_->SetAppId(
       AppId() + std::to_string(app_desc_.GetDisplayAffinity()));
   page_private_->page_view_->SetSecurityOrigin(
       GetIdentifierForSecurityOrigin());
-  UpdateHardwareResolution();
-  UpdateBoardType();
+  std::shared_ptr<const DeviceInfoSnapshot> device_info =
+      GetDeviceInfoSnapshot();
+  UpdateHardwareResolution(*device_info);
+  UpdateBoardType(*device_info);
   UpdateDatabaseIdentifier();
   SetupStaticUserScripts();
   SetCustomPluginIfNeeded();
@@ -243,6 +224,13 @@ wam::Url WebPageBlink::Url() const {
 }
 
 void WebPageBlink::SetPreferredLanguages(const std::string& language) {
+  ApplyPreferredLanguages(language);
+#ifndef TARGET_DESKTOP
+  page_private_->page_view_->UpdatePreferences();
+#endif
+}
+
+void WebPageBlink::ApplyPreferredLanguages(const std::string& language) {
   if (page_private_->palm_system_) {
     page_private_->palm_system_->SetLocale(language);
   }
@@ -252,7 +240,6 @@ void WebPageBlink::SetPreferredLanguages(const std::string& language) {
   // navigator.language, navigator.languages even window.languagechange event
   // too
   page_private_->page_view_->SetAcceptLanguages(language);
-  page_private_->page_view_->UpdatePreferences();
 #endif
 }
 
@@ -271,26 +258,19 @@ void WebPageBlink::ReloadDefaultPage() {
   // need to set WebProcess setting (especially the options not using Setting or
   // preference)
 
-  LoadDefaultUrl();
-}
-
-std::vector<std::string> WebPageBlink::GetErrorPagePath(
-    const std::string& error_page) {
-  const std::string& filepath = util::UriToLocal(error_page);
-  if (filepath.empty()) {
-    return std::vector<std::string>();
+  // The view recreated after the crash reads its user scripts again.
+  if (DeferLoadUntilUserScriptsRead([this] { ReloadDefaultPage(); })) {
+    return;
   }
-  std::string language;
-  GetSystemLanguage(language);
 
-  return util::GetErrorPagePaths(filepath, language);
+  LoadDefaultUrl();
 }
 
 void WebPageBlink::ReloadFailedUrl() {
   LOG_INFO(MSGID_WAM_DEBUG, 2, PMLOGKS("APP_ID", AppId().c_str()),
            PMLOGKS("INSTANCE_ID", InstanceId().c_str()),
            "ReloadFailedUrl: '%s'", load_failed_url_.c_str());
-  page_private_->page_view_->LoadUrl(load_failed_url_);
+  LoadUrl(load_failed_url_);
 }
 
 void WebPageBlink::LoadErrorPage(int error_code) {
@@ -320,18 +300,19 @@ void WebPageBlink::LoadErrorPage(int error_code) {
     // es-ES fr-CA, pt-PT has its own localization folder and
     // QLocale::bcp47Name() returns well
 
-    const auto& paths = GetErrorPagePath(errorpage);
-    auto found =
-        std::find_if(std::cbegin(paths), std::cend(paths), util::DoesPathExist);
+    std::string language;
+    GetSystemLanguage(language);
+    const std::string found = GetErrorPageResolver()->Resolve(
+        util::UriToLocal(errorpage), language);
 
     // finally found something!
-    if (found != paths.end()) {
+    if (!found.empty()) {
       // re-create it as a proper URL, so WebKit can understand it
       is_load_error_page_start_ = true;
-      wam::Url error_url = wam::Url::FromLocalFile(*found);
+      wam::Url error_url = wam::Url::FromLocalFile(found);
       if (error_url.ToString().empty()) {
         LOG_ERROR(MSGID_ERROR_ERROR, 1, PMLOGKS("PATH", errorpage.c_str()),
-                  "Error during conversion %s to URI", found->c_str());
+                  "Error during conversion %s to URI", found.c_str());
         return;
       }
       wam::Url::UrlQuery query;
@@ -357,6 +338,9 @@ void WebPageBlink::Reload() {
 }
 
 void WebPageBlink::LoadUrl(const std::string& url) {
+  if (DeferLoadUntilUserScriptsRead([this, url] { LoadUrl(url); })) {
+    return;
+  }
   page_private_->page_view_->LoadUrl(url);
 }
 
@@ -601,12 +585,24 @@ void WebPageBlink::UpdateExtensionData(const std::string& key,
   EvaluateJavaScript(event_js);
 }
 
-void WebPageBlink::HandleDeviceInfoChanged(const std::string& device_info) {
+void WebPageBlink::HandleDeviceInfoChanged(
+    const DeviceInfoSnapshot& snapshot,
+    DeviceInfoSnapshot::Fields changed) {
+  if (changed & (DeviceInfoSnapshot::kHardwareScreenWidth |
+                 DeviceInfoSnapshot::kHardwareScreenHeight)) {
+    UpdateHardwareResolution(snapshot);
+  }
+
+  if (changed & DeviceInfoSnapshot::kBoardType) {
+    UpdateBoardType(snapshot);
+  }
+
   if (!page_private_->palm_system_) {
     return;
   }
 
-  if (device_info == "LocalCountry" || device_info == "SmartServiceCountry") {
+  if (changed & (DeviceInfoSnapshot::kLocalCountry |
+                 DeviceInfoSnapshot::kSmartServiceCountry)) {
     page_private_->palm_system_->SetCountry();
   }
 }
@@ -711,11 +707,12 @@ void WebPageBlink::LoadProgressChanged(double progress) {
   if (!(loading_url_.empty() && process_ten_percent)) {
     // loading_url_ is empty then net didStartNavigation yet, default(initial)
     // progress : 0.1 so loading_url_ shouldn't be empty and greater than 0.1
-    LOG_INFO(MSGID_LOAD, 3, PMLOGKS("APP_ID", AppId().c_str()),
-             PMLOGKS("INSTANCE_ID", InstanceId().c_str()),
-             PMLOGKFV("PID", "%d", GetWebProcessPID()), "[...%3d%%]%s",
-             static_cast<int>(progress * 100.0),
-             WebAppManagerUtils::TruncateURL(loading_url_).c_str());
+    LOG_INFO_RATE_LIMITED(
+        10, 20, MSGID_LOAD, 3, PMLOGKS("APP_ID", AppId().c_str()),
+        PMLOGKS("INSTANCE_ID", InstanceId().c_str()),
+        PMLOGKFV("PID", "%d", GetWebProcessPID()), "[...%3d%%]%s",
+        static_cast<int>(progress * 100.0),
+        WebAppManagerUtils::TruncateURL(loading_url_).c_str());
   }
 }
 
@@ -727,10 +724,11 @@ void WebPageBlink::LoadAborted(const std::string& url) {
 }
 
 void WebPageBlink::LoadFailed(const std::string& url, int err_code) {
-  LOG_INFO(MSGID_LOAD, 3, PMLOGKS("APP_ID", AppId().c_str()),
-           PMLOGKS("INSTANCE_ID", InstanceId().c_str()),
-           PMLOGKFV("PID", "%d", GetWebProcessPID()), "[FAILED ][%d]%s",
-           err_code, WebAppManagerUtils::TruncateURL(url).c_str());
+  LOG_INFO_RATE_LIMITED(
+      2, 10, MSGID_LOAD, 3, PMLOGKS("APP_ID", AppId().c_str()),
+      PMLOGKS("INSTANCE_ID", InstanceId().c_str()),
+      PMLOGKFV("PID", "%d", GetWebProcessPID()), "[FAILED ][%d]%s", err_code,
+      WebAppManagerUtils::TruncateURL(url).c_str());
 
   FOR_EACH_OBSERVER(WebPageObserver, observers_, WebPageLoadFailed(err_code));
 
@@ -818,10 +816,11 @@ void WebPageBlink::NotifyMemoryPressure(
 }
 
 void WebPageBlink::RenderProcessCrashed() {
-  LOG_INFO(MSGID_WEBPROC_CRASH, 3, PMLOGKS("APP_ID", AppId().c_str()),
-           PMLOGKS("INSTANCE_ID", InstanceId().c_str()),
-           PMLOGKFV("PID", "%d", GetWebProcessPID()), "is_suspended_ : %s",
-           is_suspended_ ? "true" : "false");
+  LOG_INFO_RATE_LIMITED(
+      1, 5, MSGID_WEBPROC_CRASH, 3, PMLOGKS("APP_ID", AppId().c_str()),
+      PMLOGKS("INSTANCE_ID", InstanceId().c_str()),
+      PMLOGKFV("PID", "%d", GetWebProcessPID()), "is_suspended_ : %s",
+      is_suspended_ ? "true" : "false");
   if (IsClosing()) {
     LOG_INFO(MSGID_WEBPROC_CRASH, 3, PMLOGKS("APP_ID", AppId().c_str()),
              PMLOGKS("INSTANCE_ID", InstanceId().c_str()),
@@ -898,18 +897,19 @@ void WebPageBlink::AddUserScriptUrl(const wam::Url& url) {
   }
 
   const std::string& path = url.ToLocalFile();
-  const std::string& file_content = util::ReadFile(path);
-
-  if (file_content.empty()) {
-    LOG_DEBUG(
-        "WebPageBlink: Couldn't open '%s' as user script due to error '%s'.",
-        path.c_str(), strerror(errno));
-    return;
-  }
-  page_private_->page_view_->AddUserScript(file_content);
+  ReadUserScript(path, [this, path](FileContentCache::Content file_content) {
+    if (!file_content || file_content->empty()) {
+      LOG_DEBUG("WebPageBlink: Couldn't open '%s' as user script.",
+                path.c_str());
+      return;
+    }
+    page_private_->page_view_->AddUserScript(*file_content);
+  });
 }
 
 void WebPageBlink::SetupStaticUserScripts() {
+  // Scripts still read for a previous view would follow the cleared ones.
+  CancelUserScriptReads();
   page_private_->page_view_->ClearUserScripts();
 
   // Load Tellurium test framework if available, as a UserScript
@@ -992,9 +992,17 @@ void WebPageBlink::SetCustomPluginIfNeeded() {
   page_private_->page_view_->AddAvailablePluginDir(custom_plugin_path_);
 }
 
-void WebPageBlink::SetDisallowScrolling(bool disallow) {
-  page_private_->page_view_->SetDisallowScrollbarsInMainFrame(disallow);
-  page_private_->page_view_->SetDisallowScrollingInMainFrame(disallow);
+bool WebPageBlink::ApplyPreferenceProfile(
+    std::shared_ptr<const WebPreferenceProfile> profile) {
+  WebPreferenceProfile::Changes changes =
+      profile->Diff(preference_profile_.get());
+  preference_profile_ = std::move(profile);
+  if (changes.empty()) {
+    return false;
+  }
+
+  page_private_->page_view_->SetPreferences(changes);
+  return true;
 }
 
 int WebPageBlink::RenderProcessPid() const {
@@ -1043,19 +1051,15 @@ void WebPageBlink::SetAdditionalContentsScale(float scale_x, float scale_y) {
   page_private_->page_view_->SetAdditionalContentsScale(scale_x, scale_y);
 }
 
-void WebPageBlink::UpdateHardwareResolution() {
-  std::string hardware_width, hardware_height;
-  GetDeviceInfo("HardwareScreenWidth", hardware_width);
-  GetDeviceInfo("HardwareScreenHeight", hardware_height);
-  int width = util::StrToIntWithDefault(hardware_width, 0);
-  int height = util::StrToIntWithDefault(hardware_height, 0);
-  page_private_->page_view_->SetHardwareResolution(width, height);
+void WebPageBlink::UpdateHardwareResolution(
+    const DeviceInfoSnapshot& device_info) {
+  page_private_->page_view_->SetHardwareResolution(
+      device_info.HardwareScreenWidth().value_or(0),
+      device_info.HardwareScreenHeight().value_or(0));
 }
 
-void WebPageBlink::UpdateBoardType() {
-  std::string board_type;
-  GetDeviceInfo("boardType", board_type);
-  page_private_->page_view_->SetBoardType(board_type);
+void WebPageBlink::UpdateBoardType(const DeviceInfoSnapshot& device_info) {
+  page_private_->page_view_->SetBoardType(device_info.BoardType());
 }
 
 double WebPageBlink::DevicePixelRatio() {
@@ -1079,11 +1083,11 @@ double WebPageBlink::DevicePixelRatio() {
 
   int device_width = 0;
   int device_height = 0;
-  std::string hardware_width, hardware_height;
-  if (GetDeviceInfo("HardwareScreenWidth", hardware_width) &&
-      GetDeviceInfo("HardwareScreenHeight", hardware_height)) {
-    device_width = util::StrToIntWithDefault(hardware_width, 0);
-    device_height = util::StrToIntWithDefault(hardware_height, 0);
+  std::shared_ptr<const DeviceInfoSnapshot> device_info =
+      GetDeviceInfoSnapshot();
+  if (device_info->HasHardwareResolution()) {
+    device_width = *device_info->HardwareScreenWidth();
+    device_height = *device_info->HardwareScreenHeight();
   } else {
     device_width = CurrentUiWidth();
     device_height = CurrentUiHeight();
@@ -35,6 +35,7 @@ class WebAppBase;
 class WebView;
 class WebPageBlinkPrivate;
 class WebPageBlinkObserver;
+class WebPreferenceProfile;
 class WebViewFactory;
 
 class WebPageBlink : public WebPageBase, public WebPageBlinkDelegate {
@@ -73,8 +74,10 @@ class WebPageBlink : public WebPageBase, public WebPageBlinkDelegate {
   bool CanGoBack() override;
   void CloseVkb() override;
   bool IsInputMethodActive() const override;
+  bool IsSuspended() const override { return is_suspended_; }
   void KeyboardVisibilityChanged(bool visible) override;
-  void HandleDeviceInfoChanged(const std::string& device_info) override;
+  void HandleDeviceInfoChanged(const DeviceInfoSnapshot& snapshot,
+                               DeviceInfoSnapshot::Fields changed) override;
   void EvaluateJavaScript(const std::string& js_code) override;
   void EvaluateJavaScriptInAllFrames(const std::string& js_code,
                                      const char* method = {}) override;
@@ -146,10 +149,10 @@ class WebPageBlink : public WebPageBase, public WebPageBlinkDelegate {
   std::string EscapeData(const std::string& value);
   int RenderProcessPid() const;
   static void SetFileAccessBlocked(bool blocked);
-  void UpdateBoardType();
+  void UpdateBoardType(const DeviceInfoSnapshot& device_info);
   double DevicePixelRatio();
   void SetAdditionalContentsScale(float scale_x, float scale_y);
-  void UpdateHardwareResolution();
+  void UpdateHardwareResolution(const DeviceInfoSnapshot& device_info);
 
   // Timer callback
   void TimeoutCloseCallback();
@@ -188,8 +191,12 @@ class WebPageBlink : public WebPageBase, public WebPageBlinkDelegate {
 
  private:
   void SetCustomPluginIfNeeded();
-  void SetDisallowScrolling(bool disallow);
-  std::vector<std::string> GetErrorPagePath(const std::string& error_page);
+  // Sets the preferences which differ from the current profile. Returns
+  // false if nothing had to be changed. The caller commits the changes with
+  // UpdatePreferences().
+  bool ApplyPreferenceProfile(
+      std::shared_ptr<const WebPreferenceProfile> profile);
+  void ApplyPreferredLanguages(const std::string& language);
   void ReloadFailedUrl();
 
   std::unique_ptr<WebPageBlinkPrivate> page_private_;
@@ -203,6 +210,7 @@ class WebPageBlink : public WebPageBase, public WebPageBlinkDelegate {
   bool has_close_callback_ = false;
   OneShotTimer<WebPageBlink> close_callback_timer_;
   std::string trust_level_;
+  std::shared_ptr<const WebPreferenceProfile> preference_profile_;
   std::string load_failed_url_;
   std::string loading_url_;
   int custom_suspend_dom_time_ = 0;
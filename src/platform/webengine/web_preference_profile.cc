@@ -0,0 +1,134 @@
+// Copyright (c) 2021 LG Electronics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#include "web_preference_profile.h"
+
+#include <map>
+
+#include "application_description.h"
+#include "utils.h"
+
+namespace {
+
+size_t Index(WebPreferenceProfile::Preference preference) {
+  return static_cast<size_t>(preference);
+}
+
+}  // namespace
+
+WebPreferenceProfile::Key WebPreferenceProfile::KeyFor(
+    const ApplicationDescription& desc) {
+  Key key;
+  key.trust_level = desc.TrustLevel();
+  key.do_not_track = desc.DoNotTrack();
+  key.disallow_scrolling = desc.DisallowScrollingInMainFrame();
+
+  switch (desc.GetThirdPartyCookiesPolicy()) {
+    case ApplicationDescription::ThirdPartyCookiesPolicy::kAllow:
+      key.allow_third_party_cookies = true;
+      break;
+    case ApplicationDescription::ThirdPartyCookiesPolicy::kDeny:
+      key.allow_third_party_cookies = false;
+      break;
+    default:
+      key.allow_third_party_cookies =
+          !(util::GetEnvVar("WAM_DEFAULT_ALLOW_THIRD_PARTY_COOKIES") == "0");
+  }
+
+  return key;
+}
+
+std::shared_ptr<const WebPreferenceProfile> WebPreferenceProfile::Get(
+    const Key& key) {
+  // Only a handful of combinations exist on a device, so the profiles are
+  // never evicted.
+  static std::map<Key, std::shared_ptr<const WebPreferenceProfile>> profiles;
+
+  auto found = profiles.find(key);
+  if (found != profiles.end()) {
+    return found->second;
+  }
+
+  std::shared_ptr<const WebPreferenceProfile> profile = Create(key);
+  profiles.emplace(key, profile);
+  return profile;
+}
+
+std::shared_ptr<const WebPreferenceProfile> WebPreferenceProfile::Create(
+    const Key& key) {
+  return std::shared_ptr<const WebPreferenceProfile>(
+      new WebPreferenceProfile(key));
+}
+
+WebPreferenceProfile::WebPreferenceProfile(const Key& key) : key_(key) {
+  Set(Preference::kAllowFakeBoldText, false);
+
+  // FIXME: It should be permitted for backward compatibility for a limited list
+  // of legacy applications only.
+  Set(Preference::kAllowRunningInsecureContent, true);
+  Set(Preference::kAllowScriptsToCloseWindows, true);
+  Set(Preference::kAllowUniversalAccessFromFileUrls, true);
+  Set(Preference::kSuppressesIncrementalRendering, true);
+  Set(Preference::kDoNotTrack, key.do_not_track);
+  Set(Preference::kJavascriptCanOpenWindows, true);
+  Set(Preference::kSupportsMultipleWindows, false);
+  Set(Preference::kCSSNavigationEnabled, true);
+  Set(Preference::kV8DateUseSystemLocaloffset, false);
+  Set(Preference::kLocalStorageEnabled, true);
+  Set(Preference::kShouldSuppressDialogs, true);
+  Set(Preference::kDisallowScrollbarsInMainFrame, key.disallow_scrolling);
+  Set(Preference::kDisallowScrollingInMainFrame, key.disallow_scrolling);
+  Set(Preference::kAllowThirdPartyCookies, key.allow_third_party_cookies);
+
+  if (key.trust_level == "trusted") {
+    Set(Preference::kAllowLocalResourceLoad, true);
+  }
+
+  for (size_t i = 0; i < kPreferenceCount; ++i) {
+    if (mask_.test(i)) {
+      entries_.push_back({static_cast<Preference>(i), values_.test(i)});
+    }
+  }
+}
+
+void WebPreferenceProfile::Set(Preference preference, bool value) {
+  mask_.set(Index(preference));
+  values_.set(Index(preference), value);
+}
+
+bool WebPreferenceProfile::Has(Preference preference) const {
+  return mask_.test(Index(preference));
+}
+
+bool WebPreferenceProfile::Value(Preference preference) const {
+  return values_.test(Index(preference));
+}
+
+WebPreferenceProfile::Changes WebPreferenceProfile::Diff(
+    const WebPreferenceProfile* from) const {
+  if (!from) {
+    return entries_;
+  }
+
+  Changes changes;
+  for (const Change& entry : entries_) {
+    size_t i = Index(entry.preference);
+    if (!from->mask_.test(i) || from->values_.test(i) != entry.value) {
+      changes.push_back(entry);
+    }
+  }
+  return changes;
+}
@@ -0,0 +1,103 @@
+// Copyright (c) 2021 LG Electronics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef PLATFORM_WEBENGINE_WEB_PREFERENCE_PROFILE_H_
+#define PLATFORM_WEBENGINE_WEB_PREFERENCE_PROFILE_H_
+
+#include <bitset>
+#include <compare>
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <vector>
+
+class ApplicationDescription;
+
+// Immutable set of the web preferences every page gets on creation. The
+// values only depend on the trust level and a few app description flags, so
+// one profile is built per combination and shared by all pages using it.
+class WebPreferenceProfile {
+ public:
+  enum class Preference {
+    kAllowFakeBoldText,
+    kAllowRunningInsecureContent,
+    kAllowScriptsToCloseWindows,
+    kAllowUniversalAccessFromFileUrls,
+    kSuppressesIncrementalRendering,
+    kDisallowScrollbarsInMainFrame,
+    kDisallowScrollingInMainFrame,
+    kDoNotTrack,
+    kJavascriptCanOpenWindows,
+    kSupportsMultipleWindows,
+    kCSSNavigationEnabled,
+    kV8DateUseSystemLocaloffset,
+    kLocalStorageEnabled,
+    kShouldSuppressDialogs,
+    kAllowThirdPartyCookies,
+    kAllowLocalResourceLoad,
+    kLast = kAllowLocalResourceLoad
+  };
+  static constexpr size_t kPreferenceCount =
+      static_cast<size_t>(Preference::kLast) + 1;
+
+  struct Change {
+    Preference preference;
+    bool value;
+  };
+  using Changes = std::vector<Change>;
+
+  // The parts of the app description the profile depends on.
+  struct Key {
+    std::string trust_level;
+    bool do_not_track = false;
+    bool disallow_scrolling = false;
+    bool allow_third_party_cookies = true;
+
+    auto operator<=>(const Key&) const = default;
+  };
+
+  static Key KeyFor(const ApplicationDescription& desc);
+
+  // Returns the shared profile for |key|, building it on first use.
+  static std::shared_ptr<const WebPreferenceProfile> Get(const Key& key);
+  static std::shared_ptr<const WebPreferenceProfile> Create(const Key& key);
+
+  WebPreferenceProfile(const WebPreferenceProfile&) = delete;
+  WebPreferenceProfile& operator=(const WebPreferenceProfile&) = delete;
+
+  const Key& GetKey() const { return key_; }
+  bool Has(Preference preference) const;
+  bool Value(Preference preference) const;
+
+  // Every preference the profile sets, in declaration order.
+  const Changes& Entries() const { return entries_; }
+  // Preferences to apply on a view configured with |from| to get this
+  // profile. Everything is returned if |from| is null. Preferences only
+  // |from| sets are left as they are; the engine keeps its own defaults.
+  Changes Diff(const WebPreferenceProfile* from) const;
+
+ private:
+  explicit WebPreferenceProfile(const Key& key);
+
+  void Set(Preference preference, bool value);
+
+  const Key key_;
+  std::bitset<kPreferenceCount> mask_;
+  std::bitset<kPreferenceCount> values_;
+  Changes entries_;
+};
+
+#endif  // PLATFORM_WEBENGINE_WEB_PREFERENCE_PROFILE_H_
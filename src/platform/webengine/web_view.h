@@ -21,6 +21,8 @@
 
 #include "webos/webview_base.h"
 
+#include "web_preference_profile.h"
+
 namespace content {
 class WebContents;
 }
@@ -103,6 +105,10 @@ class WebView {
   virtual void DeactivateRendererCompositor() = 0;
   virtual const std::string& GetUrl() = 0;
   virtual void UpdatePreferences() = 0;
+  // Applies a batch of preferences. UpdatePreferences() still has to be
+  // called to commit them.
+  virtual void SetPreferences(
+      const WebPreferenceProfile::Changes& changes) = 0;
   virtual void ResetStateToMarkNextPaint() = 0;
   virtual void SetAllowRunningInsecureContent(bool enable) = 0;
   virtual void SetAllowScriptsToCloseWindows(bool enable) = 0;
@@ -372,6 +372,67 @@ void WebViewImpl::UpdatePreferences() {
   }
 }
 
+void WebViewImpl::SetPreferences(
+    const WebPreferenceProfile::Changes& changes) {
+  if (!web_view_) {
+    return;
+  }
+
+  using Preference = WebPreferenceProfile::Preference;
+  for (const WebPreferenceProfile::Change& change : changes) {
+    switch (change.preference) {
+      case Preference::kAllowFakeBoldText:
+        web_view_->SetAllowFakeBoldText(change.value);
+        break;
+      case Preference::kAllowRunningInsecureContent:
+        web_view_->SetAllowRunningInsecureContent(change.value);
+        break;
+      case Preference::kAllowScriptsToCloseWindows:
+        web_view_->SetAllowScriptsToCloseWindows(change.value);
+        break;
+      case Preference::kAllowUniversalAccessFromFileUrls:
+        web_view_->SetAllowUniversalAccessFromFileUrls(change.value);
+        break;
+      case Preference::kSuppressesIncrementalRendering:
+        web_view_->SetSuppressesIncrementalRendering(change.value);
+        break;
+      case Preference::kDisallowScrollbarsInMainFrame:
+        web_view_->SetDisallowScrollbarsInMainFrame(change.value);
+        break;
+      case Preference::kDisallowScrollingInMainFrame:
+        web_view_->SetDisallowScrollingInMainFrame(change.value);
+        break;
+      case Preference::kDoNotTrack:
+        web_view_->SetDoNotTrack(change.value);
+        break;
+      case Preference::kJavascriptCanOpenWindows:
+        web_view_->SetJavascriptCanOpenWindows(change.value);
+        break;
+      case Preference::kSupportsMultipleWindows:
+        web_view_->SetSupportsMultipleWindows(change.value);
+        break;
+      case Preference::kCSSNavigationEnabled:
+        web_view_->SetCSSNavigationEnabled(change.value);
+        break;
+      case Preference::kV8DateUseSystemLocaloffset:
+        web_view_->SetV8DateUseSystemLocaloffset(change.value);
+        break;
+      case Preference::kLocalStorageEnabled:
+        web_view_->SetLocalStorageEnabled(change.value);
+        break;
+      case Preference::kShouldSuppressDialogs:
+        web_view_->SetShouldSuppressDialogs(change.value);
+        break;
+      case Preference::kAllowThirdPartyCookies:
+        web_view_->SetAllowThirdPartyCookies(change.value);
+        break;
+      case Preference::kAllowLocalResourceLoad:
+        web_view_->SetAllowLocalResourceLoad(change.value);
+        break;
+    }
+  }
+}
+
 void WebViewImpl::ResetStateToMarkNextPaint() {
   if (web_view_) {
     web_view_->ResetStateToMarkNextPaint();
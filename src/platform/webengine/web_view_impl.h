@@ -100,6 +100,7 @@ class WebViewImpl : public WebView {
   void DeactivateRendererCompositor() override;
   const std::string& GetUrl() override;
   void UpdatePreferences() override;
+  void SetPreferences(const WebPreferenceProfile::Changes& changes) override;
   void ResetStateToMarkNextPaint() override;
   void SetAllowRunningInsecureContent(bool enable) override;
   void SetAllowScriptsToCloseWindows(bool enable) override;
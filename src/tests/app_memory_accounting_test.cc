@@ -0,0 +1,238 @@
+// Copyright (c) 2021 LG Electronics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include <json/json.h>
+
+#include "app_memory_accounting.h"
+#include "base_mock_initializer.h"
+#include "blink_web_process_manager_mock.h"
+#include "platform_module_factory_impl_mock.h"
+#include "utils.h"
+#include "web_app_manager.h"
+#include "web_app_manager_service_luna.h"
+
+namespace fs = std::filesystem;
+
+namespace {
+
+constexpr uint32_t kSharedPid = 4100;
+constexpr uint32_t kSinglePid = 4200;
+constexpr uint32_t kRssOnlyPid = 4300;
+constexpr uint32_t kGonePid = 4400;
+
+constexpr char kLaunchAppJsonBody[] = R"({
+  "appDesc": {
+    "defaultWindowType": "card",
+    "id": "bareapp",
+    "trustLevel": "default",
+    "title": "Bare App",
+    "folderPath": "/usr/palm/applications/bareapp",
+    "main": "index.html",
+    "type": "web"
+  },
+  "appId": "bareapp",
+  "parameters": {
+    "displayAffinity": 0
+  },
+  "instanceId": "3d1a50a4-5d32-4a6c-a1b4-3b5d0e5c1f3a"
+})";
+
+class FakeProcfs {
+ public:
+  FakeProcfs() {
+    std::string pattern =
+        (fs::temp_directory_path() / "wam-procfs-XXXXXX").string();
+    root_ = mkdtemp(pattern.data());
+  }
+  ~FakeProcfs() { fs::remove_all(root_); }
+
+  void AddProcess(uint32_t pid,
+                  const std::string& file,
+                  const std::string& content) {
+    fs::path dir = fs::path(root_) / std::to_string(pid);
+    fs::create_directories(dir);
+    std::ofstream(dir / file) << content;
+  }
+
+  void SetPss(uint32_t pid, uint64_t kb) {
+    AddProcess(pid, "smaps_rollup",
+               "00400000-7fff0000 ---p 00000000 00:00 0 [rollup]\n"
+               "Rss:             " +
+                   std::to_string(kb * 2) +
+                   " kB\n"
+                   "Pss:             " +
+                   std::to_string(kb) + " kB\n");
+  }
+
+  const std::string& Root() const { return root_; }
+
+ private:
+  std::string root_;
+};
+
+AppMemoryAccounting::Share MakeShare(const std::string& app_id,
+                                     const std::string& instance_id,
+                                     uint32_t pid,
+                                     double weight = 1.0) {
+  AppMemoryAccounting::Share share;
+  share.app_id = app_id;
+  share.instance_id = instance_id;
+  share.pid = pid;
+  share.weight = weight;
+  return share;
+}
+
+}  // namespace
+
+TEST(AppMemoryAccountingTest, ReadProcessPss) {
+  FakeProcfs procfs;
+  procfs.SetPss(kSinglePid, 51200);
+  procfs.AddProcess(kRssOnlyPid, "status",
+                    "Name:\twebos-renderer\nVmRSS:\t   20480 kB\n");
+
+  AppMemoryAccounting accounting(procfs.Root());
+  EXPECT_EQ(accounting.ReadProcessPss(kSinglePid), 51200u);
+  EXPECT_EQ(accounting.ReadProcessPss(kRssOnlyPid), 20480u);
+  EXPECT_EQ(accounting.ReadProcessPss(kGonePid), 0u);
+  EXPECT_EQ(accounting.ReadProcessPss(0), 0u);
+}
+
+TEST(AppMemoryAccountingTest, SplitSharedProcessByWeight) {
+  FakeProcfs procfs;
+  procfs.SetPss(kSharedPid, 90000);
+  procfs.SetPss(kSinglePid, 40000);
+
+  AppMemoryAccounting accounting(procfs.Root());
+  const auto& usages = accounting.Update({
+      MakeShare("com.app.a", "a-1", kSharedPid, 2),
+      MakeShare("com.app.b", "b-1", kSharedPid, 1),
+      MakeShare("com.app.c", "c-1", kSinglePid, 1),
+  });
+
+  ASSERT_EQ(usages.size(), 3u);
+  EXPECT_EQ(usages[0].instance_id, "a-1");
+  EXPECT_EQ(usages[0].pss_kb, 60000u);
+  EXPECT_EQ(usages[0].process_pss_kb, 90000u);
+  EXPECT_EQ(usages[0].sharing_apps, 2u);
+  EXPECT_EQ(usages[1].instance_id, "c-1");
+  EXPECT_EQ(usages[1].pss_kb, 40000u);
+  EXPECT_EQ(usages[1].sharing_apps, 1u);
+  EXPECT_EQ(usages[2].instance_id, "b-1");
+  EXPECT_EQ(usages[2].pss_kb, 30000u);
+
+  EXPECT_EQ(accounting.AttributedPss("b-1"), 30000u);
+  EXPECT_EQ(accounting.AttributedPss("unknown"), 0u);
+}
+
+TEST(AppMemoryAccountingTest, SplitEvenlyWithoutWeights) {
+  FakeProcfs procfs;
+  procfs.SetPss(kSharedPid, 30000);
+
+  AppMemoryAccounting accounting(procfs.Root());
+  accounting.Update({
+      MakeShare("com.app.a", "a-1", kSharedPid, 0),
+      MakeShare("com.app.b", "b-1", kSharedPid, 0),
+      MakeShare("com.app.c", "c-1", kSharedPid, 0),
+  });
+
+  EXPECT_EQ(accounting.AttributedPss("a-1"), 10000u);
+  EXPECT_EQ(accounting.AttributedPss("b-1"), 10000u);
+  EXPECT_EQ(accounting.AttributedPss("c-1"), 10000u);
+}
+
+TEST(AppMemoryAccountingTest, HistoryPerAppId) {
+  FakeProcfs procfs;
+  AppMemoryAccounting accounting(procfs.Root(), 3);
+
+  // Two instances of the same app are summed into one history sample.
+  for (uint64_t kb : {1000, 2000, 3000, 4000}) {
+    procfs.SetPss(kSharedPid, kb);
+    procfs.SetPss(kSinglePid, kb);
+    accounting.Update({
+        MakeShare("com.app.a", "a-1", kSharedPid),
+        MakeShare("com.app.a", "a-2", kSinglePid),
+    });
+  }
+
+  const std::deque<uint64_t>* history = accounting.History("com.app.a");
+  ASSERT_NE(history, nullptr);
+  EXPECT_THAT(*history, testing::ElementsAre(4000, 6000, 8000));
+  EXPECT_EQ(accounting.History("com.app.b"), nullptr);
+
+  // History survives the app being closed.
+  accounting.Update({});
+  EXPECT_TRUE(accounting.Usages().empty());
+  ASSERT_NE(accounting.History("com.app.a"), nullptr);
+
+  Json::Value json = accounting.ToJson("com.app.a");
+  ASSERT_TRUE(json["apps"].isArray());
+  EXPECT_EQ(json["apps"].size(), 0u);
+  ASSERT_TRUE(json["history"]["com.app.a"].isArray());
+  EXPECT_EQ(json["history"]["com.app.a"].size(), 3u);
+}
+
+TEST(AppMemoryAccountingTest, GetAppMemoryUsage) {
+  BaseMockInitializer<NiceWebViewMock, NiceWebAppWindowMock,
+                      PlatformModuleFactoryImplMock>
+      mock_initializer;
+
+  FakeProcfs procfs;
+  procfs.SetPss(kSharedPid, 73400);
+  AppMemoryAccounting* accounting =
+      WebAppManager::Instance()->GetAppMemoryAccounting();
+  const std::string proc_root = accounting->ProcRoot();
+  accounting->SetProcRoot(procfs.Root());
+
+  Json::Value request_launch;
+  ASSERT_TRUE(util::StringToJson(kLaunchAppJsonBody, request_launch));
+  WebAppManagerServiceLuna* luna_service = WebAppManagerServiceLuna::Instance();
+  const auto response_launch = luna_service->launchApp(request_launch);
+  ASSERT_TRUE(response_launch["returnValue"].asBool());
+
+  BlinkWebProcessManagerMock* process_manager =
+      static_cast<BlinkWebProcessManagerMock*>(
+          WebAppManager::Instance()->GetWebProcessManager());
+  EXPECT_CALL(*process_manager, GetWebProcessPIDMock())
+      .WillRepeatedly(testing::Return(kSharedPid));
+
+  Json::Value request(Json::objectValue);
+  request["appId"] = "bareapp";
+  const auto reply = luna_service->getAppMemoryUsage(request);
+
+  ASSERT_TRUE(reply["returnValue"].asBool());
+  ASSERT_TRUE(reply["apps"].isArray());
+  ASSERT_EQ(reply["apps"].size(), 1u);
+  EXPECT_EQ(reply["apps"][0]["id"].asString(), "bareapp");
+  EXPECT_EQ(reply["apps"][0]["pid"].asUInt(), kSharedPid);
+  EXPECT_EQ(reply["apps"][0]["pss"].asUInt64(), 73400u);
+  EXPECT_EQ(reply["apps"][0]["processPss"].asUInt64(), 73400u);
+  ASSERT_TRUE(reply["history"]["bareapp"].isArray());
+
+  request["appId"] = 1;
+  const auto invalid_reply = luna_service->getAppMemoryUsage(request);
+  EXPECT_FALSE(invalid_reply["returnValue"].asBool());
+  EXPECT_EQ(invalid_reply["errorCode"].asInt(), kErrCodeInvalidParam);
+
+  accounting->SetProcRoot(proc_root);
+}
@@ -43,6 +43,7 @@ const char* kApplicationDescriptionJson = R"({
         "usePrerendering":true,
         "disallowScrollingInMainFrame":false,
         "useUnlimitedMediaPolicy":true,
+        "coalescePointerEvents":false,
         "useNativeScroll":true,
         "trustLevel":"default",
         "subType":"default",
@@ -189,6 +190,14 @@ TEST_F(ApplicationDescriptionTest, checkGetUseUnlimitedMediaPolicy) {
   EXPECT_TRUE(application_description_->UseUnlimitedMediaPolicy());
 }
 
+TEST_F(ApplicationDescriptionTest, checkGetCoalescePointerEvents) {
+  EXPECT_FALSE(application_description_->CoalescePointerEvents());
+
+  auto defaults = ApplicationDescription::FromJsonString(R"({"id": "app"})");
+  ASSERT_TRUE(defaults);
+  EXPECT_TRUE(defaults->CoalescePointerEvents());
+}
+
 TEST_F(ApplicationDescriptionTest, checkGetUseNativeScroll) {
   EXPECT_TRUE(application_description_->UseNativeScroll());
 }
@@ -339,3 +348,14 @@ TEST_F(ApplicationDescriptionTest, checkGetKeyFilterTable) {
 
   EXPECT_EQ(expected_table, actual_table);
 }
+
+TEST_F(ApplicationDescriptionTest, checkGetKeyFilter) {
+  const KeyFilter& filter = application_description_->GetKeyFilter();
+  ASSERT_EQ(filter.Entries().size(), 3u);
+
+  const KeyFilter::Entry* entry = filter.Find(4);
+  ASSERT_NE(entry, nullptr);
+  EXPECT_EQ(entry->to, 5);
+  EXPECT_EQ(entry->modifier, 6);
+  EXPECT_EQ(filter.Find(2), nullptr);
+}
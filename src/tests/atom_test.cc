@@ -0,0 +1,82 @@
+// Copyright (c) 2021 LG Electronics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#include <string>
+#include <utility>
+
+#include <gtest/gtest.h>
+
+#include "atom.h"
+
+TEST(AtomTest, EqualStringsShareId) {
+  const size_t size = Atom::TableSize();
+  Atom first("com.webos.app.atom.first");
+  Atom same(std::string("com.webos.app.atom.first"));
+  Atom second("com.webos.app.atom.second");
+
+  EXPECT_EQ(first, same);
+  EXPECT_EQ(first.Id(), same.Id());
+  EXPECT_FALSE(first == second);
+  EXPECT_EQ(first.String(), "com.webos.app.atom.first");
+  EXPECT_EQ(Atom::TableSize(), size + 2);
+
+  Atom empty("");
+  EXPECT_TRUE(empty.IsEmpty());
+  EXPECT_EQ(empty, Atom());
+  EXPECT_EQ(empty.String(), "");
+}
+
+TEST(AtomTest, ReleasedWithLastReference) {
+  const size_t size = Atom::TableSize();
+  EXPECT_FALSE(Atom::Find("com.webos.app.atom.released"));
+  {
+    Atom atom("com.webos.app.atom.released");
+    Atom copy = atom;
+    Atom moved = std::move(atom);
+    ASSERT_TRUE(Atom::Find("com.webos.app.atom.released"));
+    EXPECT_EQ(*Atom::Find("com.webos.app.atom.released"), copy);
+    EXPECT_EQ(Atom::TableSize(), size + 1);
+
+    copy = Atom("com.webos.app.atom.other");
+    EXPECT_TRUE(Atom::Find("com.webos.app.atom.released"));
+  }
+  EXPECT_FALSE(Atom::Find("com.webos.app.atom.released"));
+  EXPECT_FALSE(Atom::Find("com.webos.app.atom.other"));
+  EXPECT_EQ(Atom::TableSize(), size);
+
+  // Finding doesn't intern, the empty string is always there.
+  ASSERT_TRUE(Atom::Find(""));
+  EXPECT_TRUE(Atom::Find("")->IsEmpty());
+  EXPECT_EQ(Atom::TableSize(), size);
+}
+
+TEST(AtomTest, AtomKeyedMaps) {
+  AtomMap<int> crashes;
+  crashes[Atom("com.webos.app.atom.crash")]++;
+  crashes[Atom("com.webos.app.atom.crash")]++;
+  EXPECT_EQ(crashes.size(), 1u);
+  EXPECT_EQ(crashes[*Atom::Find("com.webos.app.atom.crash")], 2);
+
+  // The map keeps the string interned.
+  crashes.clear();
+  EXPECT_FALSE(Atom::Find("com.webos.app.atom.crash"));
+
+  AtomMultimap<int> pages;
+  const Atom app("com.webos.app.atom.pages");
+  pages.emplace(app, 1);
+  pages.emplace(app, 2);
+  EXPECT_EQ(pages.count(app), 2u);
+}
@@ -0,0 +1,247 @@
+// Copyright (c) 2021 LG Electronics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <glib.h>
+#include <gtest/gtest.h>
+#include <json/json.h>
+
+#include "deferred_replies.h"
+
+namespace {
+
+// Stands for an LS2 message: counts its references and keeps the replies.
+struct FakeMessage {
+  int refs = 1;
+  std::vector<std::string> replies;
+};
+
+FakeMessage* FromLs(LSMessage* message) {
+  return reinterpret_cast<FakeMessage*>(message);
+}
+
+LSMessage* ToLs(FakeMessage* message) {
+  return reinterpret_cast<LSMessage*>(message);
+}
+
+DeferredReplies::Bus FakeBus() {
+  DeferredReplies::Bus bus;
+  bus.ref = [](LSMessage* message) { ++FromLs(message)->refs; };
+  bus.unref = [](LSMessage* message) { --FromLs(message)->refs; };
+  bus.reply = [](LSHandle*, LSMessage* message, const std::string& payload) {
+    FromLs(message)->replies.push_back(payload);
+    return true;
+  };
+  return bus;
+}
+
+Json::Value Succeeded(int value) {
+  Json::Value reply;
+  reply["returnValue"] = true;
+  reply["value"] = value;
+  return reply;
+}
+
+class DeferredRepliesTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    // The test thread runs the context, so the work is asynchronous.
+    context_ = g_main_context_new();
+    ASSERT_TRUE(g_main_context_acquire(context_));
+  }
+
+  void TearDown() override {
+    g_main_context_release(context_);
+    g_main_context_unref(context_);
+  }
+
+  bool RunUntil(const std::function<bool()>& done) {
+    const auto deadline =
+        std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while (!done()) {
+      if (std::chrono::steady_clock::now() > deadline) {
+        return false;
+      }
+      g_main_context_iteration(context_, FALSE);
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    return true;
+  }
+
+  GMainContext* context_ = nullptr;
+  LSHandle* const handle_ = nullptr;
+};
+
+}  // namespace
+
+TEST_F(DeferredRepliesTest, InFlightLimit) {
+  DeferredReplies replies(context_, FakeBus());
+  replies.SetMaxInFlight(2);
+  FakeMessage first;
+  FakeMessage second;
+  FakeMessage third;
+
+  auto first_reply = replies.Defer(handle_, ToLs(&first));
+  auto second_reply = replies.Defer(handle_, ToLs(&second));
+  ASSERT_TRUE(first_reply);
+  ASSERT_TRUE(second_reply);
+  EXPECT_FALSE(replies.Defer(handle_, ToLs(&third)));
+  EXPECT_EQ(replies.InFlight(), 2u);
+  // A rejected message is left to the caller.
+  EXPECT_EQ(third.refs, 1);
+
+  EXPECT_TRUE(first_reply->Send(Succeeded(1)));
+  EXPECT_EQ(replies.InFlight(), 1u);
+  auto third_reply = replies.Defer(handle_, ToLs(&third));
+  ASSERT_TRUE(third_reply);
+  EXPECT_EQ(replies.InFlight(), 2u);
+
+  EXPECT_TRUE(second_reply->Send(Succeeded(2)));
+  EXPECT_TRUE(third_reply->Send(Succeeded(3)));
+  EXPECT_EQ(replies.InFlight(), 0u);
+}
+
+TEST_F(DeferredRepliesTest, MessageKeptUntilReplied) {
+  DeferredReplies replies(context_, FakeBus());
+  FakeMessage message;
+
+  auto reply = replies.Defer(handle_, ToLs(&message));
+  ASSERT_TRUE(reply);
+  EXPECT_EQ(message.refs, 2);
+  // The bus drops its reference once the handler returns.
+  --message.refs;
+
+  DeferredReplies::Reply copy = *reply;
+  EXPECT_TRUE(copy.Send(Succeeded(1)));
+  EXPECT_EQ(message.refs, 0);
+  ASSERT_EQ(message.replies.size(), 1u);
+  EXPECT_NE(message.replies[0].find("\"value\":1"), std::string::npos);
+
+  // Answered once only.
+  EXPECT_FALSE(reply->Send(Succeeded(2)));
+  EXPECT_EQ(message.replies.size(), 1u);
+  EXPECT_EQ(message.refs, 0);
+}
+
+TEST_F(DeferredRepliesTest, TimeoutReply) {
+  DeferredReplies replies(context_, FakeBus());
+  replies.SetTimeout(20);
+  FakeMessage message;
+
+  auto reply = replies.Defer(handle_, ToLs(&message));
+  ASSERT_TRUE(reply);
+  --message.refs;
+  ASSERT_TRUE(RunUntil([&message] { return !message.replies.empty(); }));
+  EXPECT_EQ(message.replies[0], DeferredReplies::kTimeoutReply);
+  EXPECT_EQ(message.refs, 0);
+  EXPECT_EQ(replies.InFlight(), 0u);
+
+  // The late result is dropped.
+  EXPECT_FALSE(reply->Send(Succeeded(1)));
+  EXPECT_EQ(message.replies.size(), 1u);
+}
+
+TEST_F(DeferredRepliesTest, ComputeOnWorker) {
+  DeferredReplies replies(context_, FakeBus());
+  FakeMessage first;
+  FakeMessage second;
+  std::thread::id work_thread;
+
+  auto first_reply = replies.Defer(handle_, ToLs(&first));
+  auto second_reply = replies.Defer(handle_, ToLs(&second));
+  ASSERT_TRUE(first_reply && second_reply);
+  first_reply->Compute([&work_thread] {
+    work_thread = std::this_thread::get_id();
+    return Succeeded(1);
+  });
+  second_reply->Compute([] { return Succeeded(2); });
+  // Nothing is sent from the worker thread.
+  EXPECT_TRUE(first.replies.empty());
+
+  ASSERT_TRUE(RunUntil([&second] { return !second.replies.empty(); }));
+  ASSERT_EQ(first.replies.size(), 1u);
+  EXPECT_NE(first.replies[0].find("\"value\":1"), std::string::npos);
+  EXPECT_NE(second.replies[0].find("\"value\":2"), std::string::npos);
+  EXPECT_NE(work_thread, std::this_thread::get_id());
+  EXPECT_EQ(first.refs, 1);
+  EXPECT_EQ(replies.InFlight(), 0u);
+}
+
+TEST_F(DeferredRepliesTest, DestroyAnswersPending) {
+  FakeMessage message;
+  DeferredReplies::Reply reply;
+  {
+    DeferredReplies replies(context_, FakeBus());
+    auto deferred = replies.Defer(handle_, ToLs(&message));
+    ASSERT_TRUE(deferred);
+    reply = *deferred;
+  }
+  EXPECT_EQ(message.refs, 1);
+  ASSERT_EQ(message.replies.size(), 1u);
+  EXPECT_EQ(message.replies[0], DeferredReplies::kTimeoutReply);
+  EXPECT_FALSE(reply.Send(Succeeded(1)));
+}
+
+TEST_F(DeferredRepliesTest, TimedOutWorkIsSkipped) {
+  DeferredReplies replies(context_, FakeBus());
+  FakeMessage blocking;
+  std::atomic<bool> release{false};
+  auto blocking_reply = replies.Defer(handle_, ToLs(&blocking));
+  ASSERT_TRUE(blocking_reply);
+  blocking_reply->Compute([&release] {
+    while (!release) {
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    return Succeeded(1);
+  });
+
+  // Clients retrying after their timeouts while the worker is blocked.
+  replies.SetTimeout(20);
+  std::atomic<int> stale_runs{0};
+  FakeMessage retries[8];
+  for (FakeMessage& retry : retries) {
+    auto reply = replies.Defer(handle_, ToLs(&retry));
+    ASSERT_TRUE(reply);
+    reply->Compute([&stale_runs] {
+      ++stale_runs;
+      return Succeeded(2);
+    });
+    ASSERT_TRUE(RunUntil([&retry] { return !retry.replies.empty(); }));
+    EXPECT_EQ(retry.replies[0], DeferredReplies::kTimeoutReply);
+  }
+  EXPECT_EQ(replies.InFlight(), 1u);
+
+  release = true;
+  ASSERT_TRUE(RunUntil([&blocking] { return !blocking.replies.empty(); }));
+  EXPECT_NE(blocking.replies[0].find("\"value\":1"), std::string::npos);
+
+  // Work posted after the timed out one runs once the worker got past it.
+  replies.SetTimeout(DeferredReplies::kDefaultTimeoutMs);
+  FakeMessage last;
+  auto last_reply = replies.Defer(handle_, ToLs(&last));
+  ASSERT_TRUE(last_reply);
+  last_reply->Compute([] { return Succeeded(3); });
+  ASSERT_TRUE(RunUntil([&last] { return !last.replies.empty(); }));
+  EXPECT_NE(last.replies[0].find("\"value\":3"), std::string::npos);
+  EXPECT_EQ(stale_runs, 0);
+}
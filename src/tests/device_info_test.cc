@@ -14,9 +14,30 @@
 //
 // SPDX-License-Identifier: Apache-2.0
 
+#include <string>
+#include <thread>
+#include <vector>
+
 #include <gtest/gtest.h>
 
 #include "device_info.h"
+#include "utils.h"
+
+namespace {
+
+class DeviceInfoObserverStub : public DeviceInfo::Observer {
+ public:
+  void DeviceInfoChanged(const DeviceInfoSnapshot& snapshot,
+                         DeviceInfoSnapshot::Fields changed) override {
+    generations_.push_back(snapshot.Generation());
+    changes_.push_back(changed);
+  }
+
+  std::vector<uint64_t> generations_;
+  std::vector<DeviceInfoSnapshot::Fields> changes_;
+};
+
+}  // namespace
 
 class DeviceInfoTest : public ::testing::Test {
  public:
@@ -95,3 +116,96 @@ TEST_F(DeviceInfoTest, checkDisplayHeight) {
   ASSERT_TRUE(device_info_.GetDisplayHeight(actual_value));
   EXPECT_EQ(expected_value2, actual_value);
 }
+
+TEST_F(DeviceInfoTest, checkTypedSnapshot) {
+  device_info_.SetDeviceInfo("HardwareScreenWidth", "3840");
+  device_info_.SetDeviceInfo("HardwareScreenHeight", "2160");
+  device_info_.SetDeviceInfo("ScreenRotation", "90");
+  device_info_.SetDeviceInfo("LocalCountry", "KOR");
+  device_info_.SetDeviceInfo("CustomKey", "CustomValue");
+
+  auto snapshot = device_info_.Snapshot();
+  ASSERT_TRUE(snapshot->HasHardwareResolution());
+  EXPECT_EQ(*snapshot->HardwareScreenWidth(), 3840);
+  EXPECT_EQ(*snapshot->HardwareScreenHeight(), 2160);
+  EXPECT_EQ(snapshot->Rotation(), DeviceInfoSnapshot::ScreenRotation::k90);
+  EXPECT_EQ(snapshot->LocalCountry(), "KOR");
+  EXPECT_EQ(snapshot->Value("CustomKey"), "CustomValue");
+  EXPECT_FALSE(snapshot->DisplayWidth().has_value());
+  EXPECT_TRUE(snapshot->SmartServiceCountry().empty());
+
+  // A snapshot held by a reader is never modified by later updates.
+  device_info_.SetDeviceInfo("LocalCountry", "USA");
+  EXPECT_EQ(snapshot->LocalCountry(), "KOR");
+  EXPECT_EQ(device_info_.Snapshot()->LocalCountry(), "USA");
+  EXPECT_GT(device_info_.Snapshot()->Generation(), snapshot->Generation());
+}
+
+TEST_F(DeviceInfoTest, checkObserverGetsChangedFieldsOnly) {
+  DeviceInfoObserverStub observer;
+  device_info_.AddObserver(&observer);
+
+  device_info_.SetDeviceInfo("LocalCountry", "KOR");
+  device_info_.SetDeviceInfo("LocalCountry", "KOR");
+  device_info_.SetDisplayWidth(1920);
+  device_info_.SetDeviceInfo("CustomKey", "CustomValue");
+  device_info_.SetSystemLanguage("ko-KR");
+
+  ASSERT_EQ(observer.changes_.size(), 4u);
+  EXPECT_EQ(observer.changes_[0], DeviceInfoSnapshot::kLocalCountry);
+  EXPECT_EQ(observer.changes_[1], DeviceInfoSnapshot::kDisplayWidth);
+  EXPECT_EQ(observer.changes_[2], DeviceInfoSnapshot::kOtherField);
+  EXPECT_EQ(observer.changes_[3], DeviceInfoSnapshot::kSystemLanguage);
+  EXPECT_LT(observer.generations_[0], observer.generations_[3]);
+
+  device_info_.RemoveObserver(&observer);
+  device_info_.SetDeviceInfo("LocalCountry", "USA");
+  EXPECT_EQ(observer.changes_.size(), 4u);
+}
+
+// The reads done while a page is initialized give the same values through
+// the snapshot as through the string lookups.
+TEST_F(DeviceInfoTest, checkSnapshotMatchesStringLookups) {
+  device_info_.SetDeviceInfo("HardwareScreenWidth", "3840");
+  device_info_.SetDeviceInfo("HardwareScreenHeight", "2160");
+  device_info_.SetDeviceInfo("boardType", "O20");
+  device_info_.SetDeviceInfo("LocalCountry", "KOR");
+  device_info_.SetDeviceInfo("SmartServiceCountry", "KOR");
+  device_info_.SetSystemLanguage("ko-KR");
+
+  std::string width, height, board_type, country, smart_country, language;
+  device_info_.GetDeviceInfo("HardwareScreenWidth", width);
+  device_info_.GetDeviceInfo("HardwareScreenHeight", height);
+  device_info_.GetDeviceInfo("boardType", board_type);
+  device_info_.GetDeviceInfo("LocalCountry", country);
+  device_info_.GetDeviceInfo("SmartServiceCountry", smart_country);
+  device_info_.GetSystemLanguage(language);
+
+  auto snapshot = device_info_.Snapshot();
+  EXPECT_EQ(snapshot->HardwareScreenWidth(),
+            util::StrToIntWithDefault(width, 0));
+  EXPECT_EQ(snapshot->HardwareScreenHeight(),
+            util::StrToIntWithDefault(height, 0));
+  EXPECT_EQ(snapshot->BoardType(), board_type);
+  EXPECT_EQ(snapshot->LocalCountry(), country);
+  EXPECT_EQ(snapshot->SmartServiceCountry(), smart_country);
+  EXPECT_EQ(snapshot->SystemLanguage(), language);
+}
+
+TEST_F(DeviceInfoTest, checkConcurrentUpdatesAreKept) {
+  constexpr int kUpdates = 1000;
+  auto set_all = [this](const std::string& name) {
+    for (int i = 1; i <= kUpdates; ++i) {
+      device_info_.SetDeviceInfo(name, std::to_string(i));
+    }
+  };
+  std::thread country([&] { set_all("LocalCountry"); });
+  std::thread board_type([&] { set_all("boardType"); });
+  country.join();
+  board_type.join();
+
+  auto snapshot = device_info_.Snapshot();
+  EXPECT_EQ(snapshot->LocalCountry(), std::to_string(kUpdates));
+  EXPECT_EQ(snapshot->BoardType(), std::to_string(kUpdates));
+  EXPECT_EQ(snapshot->Generation(), 2u * kUpdates);
+}
@@ -0,0 +1,156 @@
+// Copyright (c) 2021 LG Electronics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#include <fcntl.h>
+#include <sys/stat.h>
+
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <string>
+
+#include <gtest/gtest.h>
+
+#include "error_page_resolver.h"
+
+namespace fs = std::filesystem;
+
+namespace {
+
+constexpr char kFileName[] = "loaderror.html";
+
+class ErrorPageResolverTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    std::string pattern =
+        (fs::temp_directory_path() / "wam-error-page-XXXXXX").string();
+    ASSERT_NE(mkdtemp(pattern.data()), nullptr);
+    root_ = pattern;
+    error_page_ = (root_ / kFileName).string();
+
+    Add("");
+    Add("resources/html");
+    Add("resources/ko/html");
+    Add("resources/zh/Hant/TW/html");
+
+    // Backdate the tree, so later changes get a distinct modification time
+    // even with a coarse file system clock.
+    struct timespec times[2] = {{0, UTIME_OMIT}, {12345, 0}};
+    ASSERT_EQ(utimensat(AT_FDCWD, root_.c_str(), times, 0), 0);
+    for (const auto& entry : fs::recursive_directory_iterator(root_)) {
+      ASSERT_EQ(utimensat(AT_FDCWD, entry.path().c_str(), times, 0), 0);
+    }
+  }
+
+  void TearDown() override { fs::remove_all(root_); }
+
+  // Creates the error page in |dir|, relative to the search path.
+  std::string Add(const std::string& dir) {
+    fs::path path = root_ / dir;
+    fs::create_directories(path);
+    path /= kFileName;
+    std::ofstream(path) << "<html></html>";
+    return path.string();
+  }
+
+  std::string PathOf(const std::string& dir) const {
+    return (root_ / dir / kFileName).string();
+  }
+
+  fs::path root_;
+  std::string error_page_;
+};
+
+}  // namespace
+
+TEST_F(ErrorPageResolverTest, LocalizedVariants) {
+  ErrorPageResolver resolver;
+  EXPECT_EQ(resolver.Resolve(error_page_, "ko-KR"),
+            PathOf("resources/ko/html"));
+  EXPECT_EQ(resolver.Resolve(error_page_, "zh-Hant-TW"),
+            PathOf("resources/zh/Hant/TW/html"));
+  EXPECT_EQ(resolver.Resolve(error_page_, "en-US"), PathOf("resources/html"));
+  EXPECT_EQ(resolver.Resolve(error_page_, ""), PathOf("resources/html"));
+  EXPECT_TRUE(resolver.Resolve("", "en-US").empty());
+  EXPECT_TRUE(
+      resolver.Resolve((root_ / "missing" / kFileName).string(), "ko").empty());
+  EXPECT_EQ(resolver.GetStats().misses, 6u);
+  EXPECT_EQ(resolver.GetStats().hits, 0u);
+}
+
+TEST_F(ErrorPageResolverTest, CachedPerLanguage) {
+  ErrorPageResolver resolver;
+  const std::string korean = resolver.Resolve(error_page_, "ko-KR");
+  const std::string english = resolver.Resolve(error_page_, "en-US");
+  EXPECT_EQ(resolver.Resolve(error_page_, "ko-KR"), korean);
+  EXPECT_EQ(resolver.Resolve(error_page_, "en-US"), english);
+  EXPECT_EQ(resolver.GetStats().misses, 2u);
+  EXPECT_EQ(resolver.GetStats().hits, 2u);
+  EXPECT_EQ(resolver.GetStats().entries, 2u);
+
+  resolver.Clear();
+  EXPECT_EQ(resolver.GetStats().entries, 0u);
+  EXPECT_EQ(resolver.Resolve(error_page_, "ko-KR"), korean);
+  EXPECT_EQ(resolver.GetStats().misses, 3u);
+}
+
+TEST_F(ErrorPageResolverTest, ResultOutlivesCache) {
+  ErrorPageResolver resolver;
+  const std::string korean = resolver.Resolve(error_page_, "ko-KR");
+  // Fills the cache up, it starts over and drops the Korean entry.
+  for (size_t i = 0; i < ErrorPageResolver::kMaxEntries; ++i) {
+    resolver.Resolve(error_page_, "xx-" + std::to_string(i));
+  }
+  EXPECT_EQ(resolver.GetStats().entries, 1u);
+  EXPECT_EQ(korean, PathOf("resources/ko/html"));
+}
+
+TEST_F(ErrorPageResolverTest, VariantAdded) {
+  ErrorPageResolver resolver;
+  EXPECT_EQ(resolver.Resolve(error_page_, "ko-KR"),
+            PathOf("resources/ko/html"));
+  EXPECT_EQ(resolver.Resolve(error_page_, "fr-CA"), PathOf("resources/html"));
+
+  // Neither resources/ko/KR nor resources/fr exist yet.
+  EXPECT_EQ(resolver.Resolve(error_page_, "ko-KR"),
+            PathOf("resources/ko/html"));
+  const std::string korean = Add("resources/ko/KR/html");
+  const std::string french = Add("resources/fr/html");
+  EXPECT_EQ(resolver.Resolve(error_page_, "ko-KR"), korean);
+  EXPECT_EQ(resolver.Resolve(error_page_, "fr-CA"), french);
+  EXPECT_EQ(resolver.GetStats().hits, 1u);
+  EXPECT_EQ(resolver.GetStats().misses, 4u);
+
+  EXPECT_EQ(resolver.Resolve(error_page_, "fr-CA"), french);
+  EXPECT_EQ(resolver.GetStats().hits, 2u);
+}
+
+TEST_F(ErrorPageResolverTest, VariantRemoved) {
+  ErrorPageResolver resolver;
+  EXPECT_EQ(resolver.Resolve(error_page_, "zh-Hant-TW"),
+            PathOf("resources/zh/Hant/TW/html"));
+
+  fs::remove_all(root_ / "resources/zh");
+  EXPECT_EQ(resolver.Resolve(error_page_, "zh-Hant-TW"),
+            PathOf("resources/html"));
+
+  fs::remove_all(root_ / "resources");
+  EXPECT_EQ(resolver.Resolve(error_page_, "zh-Hant-TW"), error_page_);
+
+  fs::remove(error_page_);
+  EXPECT_TRUE(resolver.Resolve(error_page_, "zh-Hant-TW").empty());
+  EXPECT_EQ(resolver.GetStats().hits, 0u);
+}
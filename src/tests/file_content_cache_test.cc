@@ -0,0 +1,155 @@
+// Copyright (c) 2021 LG Electronics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#include <fcntl.h>
+#include <sys/stat.h>
+
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <string>
+
+#include <gtest/gtest.h>
+
+#include "file_content_cache.h"
+
+namespace fs = std::filesystem;
+
+namespace {
+
+class FileContentCacheTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    std::string pattern =
+        (fs::temp_directory_path() / "wam-script-cache-XXXXXX").string();
+    ASSERT_NE(mkdtemp(pattern.data()), nullptr);
+    dir_ = pattern;
+  }
+
+  void TearDown() override { fs::remove_all(dir_); }
+
+  std::string Write(const std::string& name, const std::string& content) {
+    fs::path path = dir_ / name;
+    std::ofstream(path, std::ios::trunc) << content;
+    return path.string();
+  }
+
+  fs::path dir_;
+};
+
+}  // namespace
+
+TEST_F(FileContentCacheTest, SharedBufferOnHit) {
+  FileContentCache cache;
+  const std::string path = Write("user.js", "console.log('one');");
+
+  FileContentCache::Content first = cache.Get(path);
+  FileContentCache::Content second = cache.Get(path);
+  ASSERT_TRUE(first);
+  EXPECT_EQ(*first, "console.log('one');");
+  EXPECT_EQ(first.get(), second.get());
+  EXPECT_EQ(cache.GetStats().misses, 1u);
+  EXPECT_EQ(cache.GetStats().hits, 1u);
+  EXPECT_EQ(cache.GetStats().entries, 1u);
+  EXPECT_EQ(cache.GetStats().bytes, first->size());
+}
+
+TEST_F(FileContentCacheTest, RevalidateModifiedFile) {
+  FileContentCache cache;
+  const std::string path = Write("user.js", "var a = 1;");
+  FileContentCache::Content before = cache.Get(path);
+  ASSERT_TRUE(before);
+
+  Write("user.js", "var a = 1; var b = 2;");
+  FileContentCache::Content after = cache.Get(path);
+  ASSERT_TRUE(after);
+  EXPECT_EQ(*after, "var a = 1; var b = 2;");
+  // Pages holding the old buffer keep it unchanged.
+  EXPECT_EQ(*before, "var a = 1;");
+  EXPECT_EQ(cache.GetStats().misses, 2u);
+  EXPECT_EQ(cache.GetStats().entries, 1u);
+
+  // Same size, but a new modification time.
+  Write("user.js", "var a = 3; var b = 4;");
+  struct timespec times[2] = {{0, UTIME_OMIT}, {12345, 0}};
+  ASSERT_EQ(utimensat(AT_FDCWD, path.c_str(), times, 0), 0);
+  EXPECT_EQ(*cache.Get(path), "var a = 3; var b = 4;");
+  EXPECT_EQ(cache.GetStats().misses, 3u);
+}
+
+TEST_F(FileContentCacheTest, RevalidateReplacedFile) {
+  FileContentCache cache;
+  const std::string path = Write("user.js", "old");
+  ASSERT_TRUE(cache.Get(path));
+
+  // Replace the file atomically, as package updates do.
+  const std::string replacement = Write("user.js.new", "new");
+  fs::rename(replacement, path);
+  FileContentCache::Content content = cache.Get(path);
+  ASSERT_TRUE(content);
+  EXPECT_EQ(*content, "new");
+  EXPECT_EQ(cache.GetStats().hits, 0u);
+
+  fs::remove(path);
+  EXPECT_FALSE(cache.Get(path));
+  EXPECT_EQ(cache.GetStats().entries, 0u);
+  EXPECT_FALSE(cache.Get((dir_ / "missing.js").string()));
+  EXPECT_FALSE(cache.Get(dir_.string()));
+}
+
+TEST_F(FileContentCacheTest, ExplicitInvalidation) {
+  FileContentCache cache;
+  const std::string path = Write("user.js", "script");
+  ASSERT_TRUE(cache.Get(path));
+
+  cache.Invalidate(path);
+  EXPECT_EQ(cache.GetStats().entries, 0u);
+  ASSERT_TRUE(cache.Get(path));
+  EXPECT_EQ(cache.GetStats().misses, 2u);
+
+  cache.Clear();
+  EXPECT_EQ(cache.GetStats().entries, 0u);
+  EXPECT_EQ(cache.GetStats().bytes, 0u);
+}
+
+TEST_F(FileContentCacheTest, SizeBound) {
+  FileContentCache cache(10);
+  const std::string a = Write("a.js", "aaaa");
+  const std::string b = Write("b.js", "bbbb");
+  const std::string c = Write("c.js", "cccc");
+  const std::string big = Write("big.js", "0123456789abcdef");
+
+  ASSERT_TRUE(cache.Get(a));
+  ASSERT_TRUE(cache.Get(b));
+  // |a| becomes the most recently used one, so |b| is evicted for |c|.
+  ASSERT_TRUE(cache.Get(a));
+  ASSERT_TRUE(cache.Get(c));
+  EXPECT_EQ(cache.GetStats().evictions, 1u);
+  EXPECT_EQ(cache.GetStats().entries, 2u);
+  EXPECT_LE(cache.GetStats().bytes, cache.MaxBytes());
+
+  const uint64_t hits = cache.GetStats().hits;
+  ASSERT_TRUE(cache.Get(a));
+  EXPECT_EQ(cache.GetStats().hits, hits + 1);
+  ASSERT_TRUE(cache.Get(b));
+  EXPECT_EQ(cache.GetStats().hits, hits + 1);
+
+  // Too large to be kept, but still returned.
+  FileContentCache::Content content = cache.Get(big);
+  ASSERT_TRUE(content);
+  EXPECT_EQ(content->size(), 16u);
+  EXPECT_LE(cache.GetStats().bytes, cache.MaxBytes());
+}
@@ -0,0 +1,267 @@
+// Copyright (c) 2021 LG Electronics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+
+#include <stdlib.h>
+
+#include <chrono>
+#include <condition_variable>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <glib.h>
+#include <gtest/gtest.h>
+
+#include "file_io_service.h"
+
+namespace fs = std::filesystem;
+
+namespace {
+
+// Blocks the worker thread until released, as a read on a slow storage.
+class Gate {
+ public:
+  void Wait() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    entered_ = true;
+    changed_.notify_all();
+    changed_.wait(lock, [this] { return open_; });
+  }
+
+  void WaitUntilEntered() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    changed_.wait(lock, [this] { return entered_; });
+  }
+
+  void Open() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    open_ = true;
+    changed_.notify_all();
+  }
+
+ private:
+  std::mutex mutex_;
+  std::condition_variable changed_;
+  bool entered_ = false;
+  bool open_ = false;
+};
+
+// Reads its script like a page does and keeps it once read.
+class FakePage {
+ public:
+  FakePage(FileIoService* service,
+           Gate* gate,
+           const std::string& path,
+           int* read_count) {
+    service->PostTaskAndReplyWithResult<std::string>(
+        [gate, path] {
+          gate->Wait();
+          std::ifstream file(path);
+          return std::string(std::istreambuf_iterator<char>(file),
+                             std::istreambuf_iterator<char>());
+        },
+        [this, read_count](std::string script) {
+          script_ = std::move(script);
+          ++*read_count;
+        },
+        &reads_);
+  }
+
+  const std::optional<std::string>& Script() const { return script_; }
+  size_t PendingReads() const { return reads_.Pending(); }
+
+ private:
+  std::optional<std::string> script_;
+  FileIoService::TaskGroup reads_;
+};
+
+class FileIoServiceTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    std::string pattern =
+        (fs::temp_directory_path() / "wam-file-io-XXXXXX").string();
+    ASSERT_NE(mkdtemp(pattern.data()), nullptr);
+    dir_ = pattern;
+
+    // The test thread runs the context, so the replies are asynchronous.
+    context_ = g_main_context_new();
+    ASSERT_TRUE(g_main_context_acquire(context_));
+  }
+
+  void TearDown() override {
+    g_main_context_release(context_);
+    g_main_context_unref(context_);
+    fs::remove_all(dir_);
+  }
+
+  std::string Write(const std::string& name, const std::string& content) {
+    fs::path path = dir_ / name;
+    std::ofstream(path, std::ios::trunc) << content;
+    return path.string();
+  }
+
+  bool RunUntil(const std::function<bool()>& done) {
+    const auto deadline =
+        std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while (!done()) {
+      if (std::chrono::steady_clock::now() > deadline) {
+        return false;
+      }
+      g_main_context_iteration(context_, FALSE);
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    return true;
+  }
+
+  fs::path dir_;
+  GMainContext* context_ = nullptr;
+};
+
+}  // namespace
+
+TEST_F(FileIoServiceTest, RepliesInPostingOrder) {
+  FileIoService service(context_);
+  const std::string first = Write("first.js", "first");
+  const std::string second = Write("second.js", "second");
+  std::vector<std::string> replies;
+
+  // The first task is the slowest one, the replies keep the order anyway.
+  service.PostTaskAndReply(
+      [] { std::this_thread::sleep_for(std::chrono::milliseconds(50)); },
+      [&replies] { replies.push_back("slow"); });
+  service.ReadFile(first, [&replies](std::optional<std::string> content) {
+    replies.push_back(content.value_or("none"));
+  });
+  service.PathExists((dir_ / "missing.js").string(), [&replies](bool exists) {
+    replies.push_back(exists ? "exists" : "missing");
+  });
+  service.ReadFile(second, [&replies](std::optional<std::string> content) {
+    replies.push_back(content.value_or("none"));
+  });
+  service.ReadFile((dir_ / "missing.js").string(),
+                   [&replies](std::optional<std::string> content) {
+                     replies.push_back(content.value_or("none"));
+                   });
+  // Nothing is called back before the context runs.
+  EXPECT_TRUE(replies.empty());
+
+  ASSERT_TRUE(RunUntil([&replies] { return replies.size() == 5; }));
+  EXPECT_EQ(replies, (std::vector<std::string>{"slow", "first", "missing",
+                                               "second", "none"}));
+}
+
+TEST_F(FileIoServiceTest, RepliesOnContextThread) {
+  FileIoService service(context_);
+  std::thread::id task_thread;
+  std::thread::id reply_thread;
+  service.PostTaskAndReply(
+      [&task_thread] { task_thread = std::this_thread::get_id(); },
+      [&reply_thread] { reply_thread = std::this_thread::get_id(); });
+
+  ASSERT_TRUE(RunUntil(
+      [&reply_thread] { return reply_thread != std::thread::id(); }));
+  EXPECT_NE(task_thread, std::this_thread::get_id());
+  EXPECT_EQ(reply_thread, std::this_thread::get_id());
+}
+
+TEST_F(FileIoServiceTest, PageDestroyedDuringRead) {
+  FileIoService service(context_);
+  const std::string path = Write("user.js", "script");
+  Gate gate;
+  int read_count = 0;
+  auto page = std::make_unique<FakePage>(&service, &gate, path, &read_count);
+  EXPECT_EQ(page->PendingReads(), 1u);
+
+  // The next page's read waits behind the one of the destroyed page.
+  FakePage next(&service, &gate, path, &read_count);
+  gate.WaitUntilEntered();
+  page.reset();
+  gate.Open();
+
+  ASSERT_TRUE(RunUntil([&next] { return next.PendingReads() == 0; }));
+  ASSERT_TRUE(next.Script());
+  EXPECT_EQ(*next.Script(), "script");
+  EXPECT_EQ(read_count, 1);
+}
+
+TEST_F(FileIoServiceTest, CancelSkipsQueuedWork) {
+  FileIoService service(context_);
+  Gate gate;
+  FileIoService::TaskGroup group;
+  bool ran = false;
+  bool replied = false;
+  bool done = false;
+
+  service.PostTaskAndReply([&gate] { gate.Wait(); }, [] {});
+  service.PostTaskAndReply([&ran] { ran = true; },
+                           [&replied] { replied = true; }, &group);
+  EXPECT_EQ(group.Pending(), 1u);
+  group.Cancel();
+  EXPECT_EQ(group.Pending(), 0u);
+  service.PostTaskAndReply([] {}, [&done] { done = true; });
+  gate.Open();
+
+  ASSERT_TRUE(RunUntil([&done] { return done; }));
+  EXPECT_FALSE(ran);
+  EXPECT_FALSE(replied);
+
+  // The group can be used again after a cancel.
+  service.PostTaskAndReply([] {}, [&replied] { replied = true; }, &group);
+  ASSERT_TRUE(RunUntil([&replied] { return replied; }));
+  EXPECT_EQ(group.Pending(), 0u);
+}
+
+TEST_F(FileIoServiceTest, InlineWithoutRunningContext) {
+  FileIoService service(context_);
+  g_main_context_release(context_);
+
+  const std::string path = Write("user.js", "inline");
+  std::optional<std::string> content;
+  service.ReadFile(path, [&content](std::optional<std::string> result) {
+    content = std::move(result);
+  });
+  ASSERT_TRUE(content);
+  EXPECT_EQ(*content, "inline");
+
+  ASSERT_TRUE(g_main_context_acquire(context_));
+}
+
+TEST_F(FileIoServiceTest, DestroyDropsPendingReplies) {
+  Gate gate;
+  FileIoService::TaskGroup group;
+  bool replied = false;
+  {
+    FileIoService service(context_);
+    service.PostTaskAndReply([&gate] { gate.Wait(); },
+                             [&replied] { replied = true; }, &group);
+    service.PostTaskAndReply([] {}, [&replied] { replied = true; }, &group);
+    gate.WaitUntilEntered();
+    gate.Open();
+  }
+  EXPECT_EQ(group.Pending(), 0u);
+  for (int i = 0; i < 10; ++i) {
+    g_main_context_iteration(context_, FALSE);
+  }
+  EXPECT_FALSE(replied);
+}
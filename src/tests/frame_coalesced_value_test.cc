@@ -0,0 +1,64 @@
+// Copyright (c) 2021 LG Electronics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "frame_coalesced_value.h"
+
+TEST(FrameCoalescedValueTest, FirstUpdateInFrameIsSent) {
+  FrameCoalescedValue<int> value;
+  EXPECT_TRUE(value.Update(1));
+  EXPECT_EQ(value.Sent(), 1);
+
+  // Later updates wait for the next frame, only the last one is kept.
+  EXPECT_FALSE(value.Update(2));
+  EXPECT_FALSE(value.Update(3));
+  EXPECT_TRUE(value.HasPending());
+  EXPECT_TRUE(value.NextFrame());
+  EXPECT_EQ(value.Sent(), 3);
+
+  // Nothing pending, so the next frame starts with a free slot.
+  EXPECT_FALSE(value.NextFrame());
+  EXPECT_TRUE(value.Update(4));
+  EXPECT_EQ(value.Sent(), 4);
+}
+
+TEST(FrameCoalescedValueTest, UnchangedValueIsDropped) {
+  FrameCoalescedValue<std::vector<int>> value;
+  EXPECT_TRUE(value.Update({1, 2}));
+  EXPECT_FALSE(value.NextFrame());
+  EXPECT_FALSE(value.Update({1, 2}));
+  EXPECT_FALSE(value.HasPending());
+
+  // A change that is reverted within the frame is never sent.
+  EXPECT_TRUE(value.Update({3}));
+  EXPECT_FALSE(value.Update({1, 2}));
+  EXPECT_FALSE(value.Update({3}));
+  EXPECT_FALSE(value.HasPending());
+  EXPECT_FALSE(value.NextFrame());
+  EXPECT_EQ(value.Sent(), std::vector<int>({3}));
+}
+
+TEST(FrameCoalescedValueTest, InvalidateResendsValue) {
+  FrameCoalescedValue<int> value;
+  EXPECT_TRUE(value.Update(1));
+  EXPECT_FALSE(value.NextFrame());
+  value.Invalidate();
+  EXPECT_TRUE(value.Update(1));
+}
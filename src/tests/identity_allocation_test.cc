@@ -0,0 +1,119 @@
+// Copyright (c) 2021 LG Electronics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#include <string>
+#include <string_view>
+
+#include <gtest/gtest.h>
+#include <json/json.h>
+
+#include "allocation_counter.h"
+#include "base_mock_initializer.h"
+#include "url.h"
+#include "utils.h"
+#include "web_app_base.h"
+#include "web_app_manager.h"
+#include "web_app_manager_service_luna.h"
+#include "web_page_base.h"
+
+namespace {
+
+constexpr char kAppId[] = "bareapp";
+constexpr char kInstanceId[] = "0c4d7e12-3b5a-4f69-8e21-9a7d6c5b4e3f";
+constexpr char kLaunchAppJsonBody[] = R"({
+  "appDesc": {
+    "defaultWindowType": "card",
+    "id": "bareapp",
+    "trustLevel": "default",
+    "title": "Bare App",
+    "folderPath": "/usr/palm/applications/bareapp",
+    "main": "index.html",
+    "type": "web"
+  },
+  "appId": "bareapp",
+  "parameters": {
+    "displayAffinity": 0
+  },
+  "instanceId": "0c4d7e12-3b5a-4f69-8e21-9a7d6c5b4e3f"
+})";
+
+class IdentityAllocationTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    Json::Value request;
+    ASSERT_TRUE(util::StringToJson(kLaunchAppJsonBody, request));
+    const auto reply = WebAppManagerServiceLuna::Instance()->launchApp(request);
+    ASSERT_TRUE(reply["returnValue"].asBool());
+
+    app_ = WebAppManager::Instance()->FindAppByInstanceId(kInstanceId);
+    ASSERT_NE(app_, nullptr);
+    ASSERT_NE(app_->Page(), nullptr);
+  }
+
+  BaseMockInitializer<> mock_initializer_;
+  WebAppBase* app_ = nullptr;
+};
+
+}  // namespace
+
+TEST_F(IdentityAllocationTest, Lookups) {
+  const std::string app_id(kAppId);
+  const std::string instance_id(kInstanceId);
+  WebAppManager* manager = WebAppManager::Instance();
+
+  AllocationCounter counter;
+  EXPECT_EQ(manager->FindAppByInstanceId(instance_id), app_);
+  EXPECT_EQ(manager->FindAppById(app_id), app_);
+  EXPECT_EQ(app_->AppId(), app_id);
+  EXPECT_EQ(app_->InstanceId(), instance_id);
+  EXPECT_EQ(app_->Page()->AppId(), app_id);
+  EXPECT_EQ(app_->Page()->InstanceId(), instance_id);
+  EXPECT_FALSE(app_->Url().empty());
+  EXPECT_EQ(counter.Count(), 0u);
+}
+
+TEST_F(IdentityAllocationTest, EventLogArguments) {
+  // The identity arguments event handlers pass to PMLOGKS().
+  AllocationCounter counter;
+  const char* app_id = app_->AppId().c_str();
+  const char* instance_id = app_->InstanceId().c_str();
+  const char* launching_app_id = app_->LaunchingAppId().c_str();
+  EXPECT_EQ(app_id, app_->AppId().c_str());
+  EXPECT_EQ(instance_id, app_->InstanceId().c_str());
+  EXPECT_EQ(launching_app_id, app_->LaunchingAppId().c_str());
+  EXPECT_EQ(counter.Count(), 0u);
+}
+
+TEST(UrlAllocationTest, Components) {
+  const wam::Url url(
+      "https://user@www.lge.com:8080/path/index.html?a=b#fragment");
+
+  AllocationCounter counter;
+  EXPECT_EQ(url.Scheme(), "https");
+  EXPECT_EQ(url.Host(), "www.lge.com");
+  EXPECT_EQ(url.Port(), "8080");
+  EXPECT_EQ(url.Path(), "/path/index.html");
+  EXPECT_EQ(url.Query(), "?a=b");
+  EXPECT_EQ(url.Fragment(), "#fragment");
+  EXPECT_FALSE(url.IsLocalFile());
+  EXPECT_EQ(counter.Count(), 0u);
+
+  // A copy is one allocation for the whole buffer.
+  AllocationCounter copy_counter;
+  const wam::Url copy = url;
+  EXPECT_EQ(copy_counter.Count(), 1u);
+  EXPECT_EQ(copy.Host(), "www.lge.com");
+}
@@ -0,0 +1,151 @@
+// Copyright (c) 2021 LG Electronics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+
+#include <gtest/gtest.h>
+#include <json/json.h>
+
+#include "input_latency_tracker.h"
+
+namespace {
+
+using EventType = InputLatencyTracker::EventType;
+
+int64_t g_now_us = 0;
+
+int64_t FakeClock() {
+  return g_now_us;
+}
+
+class InputLatencyTrackerTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    g_now_us = 0;
+    tracker_.SetClockForTesting(&FakeClock);
+    tracker_.SetEnabled(true);
+  }
+
+  InputLatencyTracker tracker_;
+  const Atom app_{"com.webos.app.latency"};
+  const Atom instance_{"latency-instance"};
+  const Atom other_instance_{"latency-other-instance"};
+};
+
+}  // namespace
+
+TEST_F(InputLatencyTrackerTest, DisabledByDefault) {
+  InputLatencyTracker tracker;
+  tracker.SetClockForTesting(&FakeClock);
+  tracker.OnInput(app_, instance_, EventType::kKey);
+  g_now_us = 5000;
+  tracker.OnFrameSwapped(instance_);
+  EXPECT_FALSE(tracker.IsEnabled());
+  EXPECT_EQ(tracker.Find(app_.String(), EventType::kKey), nullptr);
+}
+
+TEST_F(InputLatencyTrackerTest, InputResolvedByNextSwap) {
+  tracker_.OnInput(app_, instance_, EventType::kKey);
+  g_now_us = 3000;
+  tracker_.OnInput(app_, instance_, EventType::kMouseMove);
+  // The swap of another window doesn't resolve the events.
+  g_now_us = 10000;
+  tracker_.OnFrameSwapped(other_instance_);
+  g_now_us = 12000;
+  tracker_.OnFrameSwapped(instance_);
+  // Nothing is left for the following swap.
+  g_now_us = 30000;
+  tracker_.OnFrameSwapped(instance_);
+
+  const auto* key = tracker_.Find(app_.String(), EventType::kKey);
+  ASSERT_NE(key, nullptr);
+  EXPECT_EQ(key->count, 1u);
+  EXPECT_EQ(key->max_us, 12000);
+  EXPECT_EQ(key->buckets[4], 1u);
+
+  const auto* move = tracker_.Find(app_.String(), EventType::kMouseMove);
+  ASSERT_NE(move, nullptr);
+  EXPECT_EQ(move->count, 1u);
+  EXPECT_EQ(move->sum_us, 9000);
+  EXPECT_EQ(tracker_.Find(app_.String(), EventType::kWheel)->count, 0u);
+}
+
+TEST_F(InputLatencyTrackerTest, SampleInterval) {
+  tracker_.SetSampleInterval(4);
+  for (int i = 0; i < 16; ++i) {
+    tracker_.OnInput(app_, instance_, EventType::kMouseMove);
+    g_now_us += 1000;
+    tracker_.OnFrameSwapped(instance_);
+  }
+  EXPECT_EQ(tracker_.Find(app_.String(), EventType::kMouseMove)->count, 4u);
+
+  tracker_.SetSampleInterval(0);
+  EXPECT_EQ(tracker_.SampleInterval(), 1u);
+}
+
+TEST_F(InputLatencyTrackerTest, PendingEventsBounded) {
+  for (size_t i = 0; i < InputLatencyTracker::kMaxPendingEvents + 8; ++i) {
+    tracker_.OnInput(app_, instance_, EventType::kMouseMove);
+  }
+  tracker_.OnFrameSwapped(instance_);
+  EXPECT_EQ(tracker_.Find(app_.String(), EventType::kMouseMove)->count,
+            InputLatencyTracker::kMaxPendingEvents);
+  EXPECT_EQ(tracker_.DroppedEvents(), 8u);
+
+  // Events of a closed window are never resolved.
+  tracker_.OnInput(app_, instance_, EventType::kKey);
+  tracker_.RemoveInstance(instance_);
+  tracker_.OnFrameSwapped(instance_);
+  EXPECT_EQ(tracker_.Find(app_.String(), EventType::kKey)->count, 0u);
+}
+
+TEST_F(InputLatencyTrackerTest, Percentiles) {
+  InputLatencyTracker::Histogram histogram;
+  EXPECT_EQ(histogram.Percentile(50), 0);
+  for (int i = 0; i < 90; ++i) {
+    histogram.Add(1500);
+  }
+  for (int i = 0; i < 10; ++i) {
+    histogram.Add(100000);
+  }
+  EXPECT_EQ(histogram.Percentile(50), 2000);
+  EXPECT_EQ(histogram.Percentile(95), 100000);
+  histogram.Add(900000);
+  EXPECT_EQ(histogram.buckets.back(), 1u);
+  EXPECT_EQ(histogram.Percentile(100), 900000);
+}
+
+TEST_F(InputLatencyTrackerTest, ToJson) {
+  tracker_.OnInput(app_, instance_, EventType::kWheel);
+  g_now_us = 20000;
+  tracker_.OnFrameSwapped(instance_);
+
+  Json::Value json = tracker_.ToJson(app_.String());
+  EXPECT_TRUE(json["enabled"].asBool());
+  EXPECT_EQ(json["sampleInterval"].asUInt(), 1u);
+  EXPECT_EQ(json["bucketBoundsUs"].size(),
+            InputLatencyTracker::kBucketBoundsUs.size());
+  ASSERT_EQ(json["apps"].size(), 1u);
+  EXPECT_EQ(json["apps"][0]["id"].asString(), app_.String());
+  const Json::Value& wheel = json["apps"][0]["events"]["wheel"];
+  EXPECT_EQ(wheel["count"].asUInt64(), 1u);
+  EXPECT_EQ(wheel["maxUs"].asInt64(), 20000);
+  EXPECT_EQ(wheel["buckets"].size(), InputLatencyTracker::kBucketCount);
+  EXPECT_FALSE(json["apps"][0]["events"].isMember("key"));
+
+  EXPECT_EQ(tracker_.ToJson("com.webos.app.other")["apps"].size(), 0u);
+  tracker_.Reset();
+  EXPECT_EQ(tracker_.ToJson()["apps"].size(), 0u);
+}
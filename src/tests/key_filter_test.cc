@@ -0,0 +1,57 @@
+// Copyright (c) 2021 LG Electronics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+
+#include <string>
+#include <unordered_map>
+#include <utility>
+
+#include <gtest/gtest.h>
+
+#include "key_filter.h"
+
+namespace {
+
+using Table = std::unordered_map<int, std::pair<int, int>>;
+
+}  // namespace
+
+TEST(KeyFilterTest, Empty) {
+  KeyFilter filter;
+  EXPECT_TRUE(filter.IsEmpty());
+  EXPECT_EQ(filter.Find(0), nullptr);
+  EXPECT_TRUE(KeyFilter(Table()).IsEmpty());
+}
+
+TEST(KeyFilterTest, FindRemappedKeys) {
+  const Table table = {{7, {8, 9}}, {1, {2, 3}}, {-4, {5, 6}}, {461, {27, 0}}};
+  KeyFilter filter(table);
+  ASSERT_EQ(filter.Entries().size(), table.size());
+  for (size_t i = 1; i < filter.Entries().size(); ++i) {
+    EXPECT_LT(filter.Entries()[i - 1].from, filter.Entries()[i].from);
+  }
+
+  for (const auto& [from, to] : table) {
+    const KeyFilter::Entry* entry = filter.Find(from);
+    ASSERT_NE(entry, nullptr) << from;
+    EXPECT_EQ(entry->from, from);
+    EXPECT_EQ(entry->to, to.first);
+    EXPECT_EQ(entry->modifier, to.second);
+  }
+  for (int key : {-5, 0, 2, 6, 8, 460, 462}) {
+    EXPECT_EQ(filter.Find(key), nullptr) << key;
+  }
+}
@@ -0,0 +1,60 @@
+// Copyright (c) 2021 LG Electronics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+
+#include <gtest/gtest.h>
+
+#include "latency_histogram.h"
+
+TEST(LatencyHistogramTest, BucketBounds) {
+  for (int64_t value = 0; value < 16; ++value) {
+    EXPECT_EQ(LatencyHistogram::BucketIndex(value), static_cast<size_t>(value));
+  }
+  for (size_t i = 0; i + 1 < LatencyHistogram::kBucketCount; ++i) {
+    const int64_t lower = LatencyHistogram::BucketLowerBound(i);
+    const int64_t upper = LatencyHistogram::BucketUpperBound(i);
+    ASSERT_EQ(LatencyHistogram::BucketIndex(lower), i);
+    ASSERT_EQ(LatencyHistogram::BucketIndex(upper), i);
+    ASSERT_EQ(LatencyHistogram::BucketLowerBound(i + 1), upper + 1);
+    // Relative precision of 1/8.
+    ASSERT_LE((upper - lower) * LatencyHistogram::kSubBuckets, lower);
+  }
+  EXPECT_EQ(LatencyHistogram::BucketIndex(int64_t{1} << 40),
+            LatencyHistogram::kBucketCount - 1);
+  EXPECT_EQ(LatencyHistogram::BucketIndex(-5), 0u);
+}
+
+TEST(LatencyHistogramTest, Percentiles) {
+  LatencyHistogram histogram;
+  EXPECT_EQ(histogram.Percentile(50), 0);
+  EXPECT_EQ(histogram.Min(), 0);
+
+  for (int64_t value = 1; value <= 1000; ++value) {
+    histogram.Add(value * 100);
+  }
+  EXPECT_EQ(histogram.Count(), 1000u);
+  EXPECT_EQ(histogram.Min(), 100);
+  EXPECT_EQ(histogram.Max(), 100000);
+  EXPECT_EQ(histogram.Mean(), 50050);
+  EXPECT_NEAR(histogram.Percentile(50), 50000, 50000 / 8);
+  EXPECT_NEAR(histogram.Percentile(99), 99000, 99000 / 8);
+  EXPECT_GE(histogram.Percentile(99), 99000);
+  EXPECT_EQ(histogram.Percentile(100), 100000);
+
+  histogram.Reset();
+  EXPECT_EQ(histogram.Count(), 0u);
+  EXPECT_EQ(histogram.Max(), 0);
+}
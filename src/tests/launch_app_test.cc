@@ -24,6 +24,7 @@
 #include "utils.h"
 #include "web_app_factory_manager_mock.h"
 #include "web_app_manager.h"
+#include "web_app_manager_metrics.h"
 #include "web_app_manager_service_luna.h"
 #include "web_app_window_factory_mock.h"
 #include "web_app_window_mock.h"
@@ -336,6 +337,45 @@ TEST_F(LaunchAppTestSuite, LaunchAppsWithoutParams) {
   ASSERT_TRUE(result.isMember("appId"));
 }
 
+TEST_F(LaunchAppTestSuite, LaunchUpdatesMetrics) {
+  Json::Value request;
+  ASSERT_TRUE(util::StringToJson(kLaunchBareAppJsonBody, request));
+  MetricCounter& launches =
+      WebAppManagerMetrics::AppLaunches().WithLabel("bareapp");
+  const uint64_t launched = launches.Value();
+
+  const auto& result = WebAppManagerServiceLuna::Instance()->launchApp(request);
+  ASSERT_TRUE(result["returnValue"].asBool());
+  EXPECT_EQ(launches.Value(), launched + 1);
+
+  const auto& reply = WebAppManagerServiceLuna::Instance()->getMetrics(
+      Json::Value(Json::objectValue));
+  ASSERT_TRUE(reply["returnValue"].asBool());
+  const std::string metrics = reply["metrics"].asString();
+  EXPECT_NE(metrics.find("# TYPE wam_app_launches_total counter\n"),
+            std::string::npos);
+  EXPECT_NE(metrics.find("wam_app_launches_total{app_id=\"bareapp\"} " +
+                         std::to_string(launched + 1) + "\n"),
+            std::string::npos);
+  EXPECT_NE(metrics.find("wam_apps{state=\"closing\"} "), std::string::npos);
+}
+
+TEST_F(LaunchAppTestSuite, MetricsExportPathIsNotSelectable) {
+  auto* service = WebAppManagerServiceLuna::Instance();
+  Json::Value request;
+  request["path"] = "/tmp/wam-metrics-elsewhere.prom";
+  auto reply = service->getMetrics(request);
+  EXPECT_FALSE(reply["returnValue"].asBool());
+  EXPECT_EQ(reply["errorCode"].asInt(), kErrCodeInvalidParam);
+
+  // Nothing is exported without WAM_METRICS_EXPORT_PATH.
+  request.clear();
+  request["export"] = true;
+  reply = service->getMetrics(request);
+  EXPECT_FALSE(reply["returnValue"].asBool());
+  EXPECT_EQ(reply["errorCode"].asInt(), kErrCodeExportMetricsFailed);
+}
+
 TEST_F(LaunchAppTestSuite, LaunchAppsWithError) {
   constexpr char path[] = "file:///usr/share/localization/wam/loaderror.html";
   constexpr char var_name[] = "WAM_ERROR_PAGE";
@@ -139,3 +139,42 @@ TEST(LogControl, SetMouseMoveOff) {
   EXPECT_FALSE(reply["mouseMove"].asBool());
   EXPECT_TRUE(reply["returnValue"].asBool());
 }
+
+TEST(LogControl, SetCategoryLevel) {
+  const char json_parameters[] = R"({
+        "keys":"level",
+        "value":"warning",
+        "category":"LOAD"
+    })";
+
+  Json::Value request;
+  ASSERT_TRUE(util::StringToJson(json_parameters, request));
+
+  auto reply = WebAppManagerServiceLuna::Instance()->logControl(request);
+
+  ASSERT_TRUE(reply.isObject());
+  ASSERT_TRUE(reply.isMember("level"));
+  ASSERT_TRUE(reply.isMember("categoryLevels"));
+  EXPECT_EQ(reply["categoryLevels"]["LOAD"].asString(), "warning");
+  EXPECT_TRUE(reply["returnValue"].asBool());
+
+  request["value"] = "default";
+  reply = WebAppManagerServiceLuna::Instance()->logControl(request);
+  EXPECT_FALSE(reply["categoryLevels"].isMember("LOAD"));
+  EXPECT_TRUE(reply["returnValue"].asBool());
+}
+
+TEST(LogControl, SetInvalidLevel) {
+  const char json_parameters[] = R"({
+        "keys":"level",
+        "value":"verbose"
+    })";
+
+  Json::Value request;
+  ASSERT_TRUE(util::StringToJson(json_parameters, request));
+
+  const auto reply = WebAppManagerServiceLuna::Instance()->logControl(request);
+
+  ASSERT_TRUE(reply.isObject());
+  EXPECT_FALSE(reply["returnValue"].asBool());
+}
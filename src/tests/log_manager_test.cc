@@ -0,0 +1,175 @@
+// Copyright (c) 2021 LG Electronics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#include <atomic>
+#include <thread>
+
+#include <gtest/gtest.h>
+
+#include "log_manager.h"
+
+namespace {
+
+int64_t g_now_ms = 0;
+
+int64_t FakeClock() {
+  return g_now_ms;
+}
+
+class LogManagerTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    LogManager::SetLevel(LogManager::Level::kDebug);
+    g_now_ms = 0;
+    LogRateLimiter::SetClockForTesting(&FakeClock);
+  }
+
+  void TearDown() override {
+    LogManager::ClearCategoryLevel({});
+    LogManager::ClearCategoryLevel(MSGID_LOAD);
+    LogRateLimiter::SetClockForTesting(nullptr);
+  }
+
+  const char* Evaluate() {
+    ++evaluations_;
+    return "value";
+  }
+
+  // One call site for the rate limited tests.
+  void LogProgress() {
+    LOG_INFO_RATE_LIMITED(10, 3, MSGID_LOAD, 1, PMLOGKS("ARG", Evaluate()),
+                          "");
+  }
+
+  int evaluations_ = 0;
+};
+
+}  // namespace
+
+TEST_F(LogManagerTest, FilteredArgumentsNotEvaluated) {
+  LogManager::SetLevel(LogManager::Level::kWarning);
+  LOG_INFO(MSGID_WAM_DEBUG, 1, PMLOGKS("ARG", Evaluate()), "");
+  LOG_DEBUG("%s", Evaluate());
+  LOG_INFO_WITH_CLOCK(MSGID_WAM_DEBUG, 1, PMLOGKS("ARG", Evaluate()), "");
+  LOG_INFO_RATE_LIMITED(1, 1, MSGID_WAM_DEBUG, 1, PMLOGKS("ARG", Evaluate()),
+                        "");
+  EXPECT_EQ(evaluations_, 0);
+
+  LOG_WARNING(MSGID_WAM_DEBUG, 1, PMLOGKS("ARG", Evaluate()), "");
+  LOG_ERROR(MSGID_WAM_DEBUG, 1, PMLOGKS("ARG", Evaluate()), "");
+  EXPECT_EQ(evaluations_, 2);
+
+  LogManager::SetLevel(LogManager::Level::kNone);
+  LOG_CRITICAL(MSGID_WAM_DEBUG, 1, PMLOGKS("ARG", Evaluate()), "");
+  EXPECT_EQ(evaluations_, 2);
+}
+
+TEST_F(LogManagerTest, CategoryLevel) {
+  LogManager::SetLevel(LogManager::Level::kError, MSGID_LOAD);
+  EXPECT_FALSE(LogManager::IsLevelEnabled(LogManager::Level::kInfo, MSGID_LOAD));
+  EXPECT_TRUE(
+      LogManager::IsLevelEnabled(LogManager::Level::kInfo, MSGID_WAM_DEBUG));
+  LOG_INFO(MSGID_LOAD, 1, PMLOGKS("ARG", Evaluate()), "");
+  EXPECT_EQ(evaluations_, 0);
+
+  // The category level wins over the default one both ways.
+  LogManager::SetLevel(LogManager::Level::kNone);
+  LogManager::SetLevel(LogManager::Level::kDebug, MSGID_LOAD);
+  LOG_INFO(MSGID_LOAD, 1, PMLOGKS("ARG", Evaluate()), "");
+  LOG_INFO(MSGID_WAM_DEBUG, 1, PMLOGKS("ARG", Evaluate()), "");
+  EXPECT_EQ(evaluations_, 1);
+  ASSERT_EQ(LogManager::GetCategoryLevels().size(), 1u);
+
+  LogManager::SetLogControl("level", "default", MSGID_LOAD);
+  EXPECT_TRUE(LogManager::GetCategoryLevels().empty());
+  LogManager::SetLogControl("level", "info");
+  EXPECT_EQ(LogManager::GetDefaultLevel(), LogManager::Level::kInfo);
+  LogManager::SetLogControl("level", "verbose");
+  EXPECT_EQ(LogManager::GetDefaultLevel(), LogManager::Level::kInfo);
+}
+
+TEST_F(LogManagerTest, DefaultLevelFollowsBackend) {
+  LogManager::ClearCategoryLevel({});
+  const LogManager::Level backend = LogManager::GetDefaultLevel();
+#ifdef DISABLE_PMLOG
+  EXPECT_EQ(backend, LogManager::Level::kDebug);
+#endif
+
+  LogManager::SetLogControl("level", "none");
+  EXPECT_EQ(LogManager::GetDefaultLevel(), LogManager::Level::kNone);
+  EXPECT_FALSE(
+      LogManager::IsLevelEnabled(LogManager::Level::kCritical, MSGID_LOAD));
+  LogManager::SetLogControl("level", "default");
+  EXPECT_EQ(LogManager::GetDefaultLevel(), backend);
+}
+
+TEST_F(LogManagerTest, LevelsChangeWhileLogging) {
+  std::atomic<bool> done{false};
+  std::thread reader([&] {
+    while (!done.load()) {
+      LogManager::IsLevelEnabled(LogManager::Level::kInfo, MSGID_LOAD);
+      LogManager::IsLevelEnabled(LogManager::Level::kInfo, MSGID_WAM_DEBUG);
+    }
+  });
+  for (int i = 0; i < 1000; ++i) {
+    LogManager::SetLevel(LogManager::Level::kError, MSGID_LOAD);
+    LogManager::SetLevel(LogManager::Level::kWarning);
+    LogManager::ClearCategoryLevel(MSGID_LOAD);
+    LogManager::SetLevel(LogManager::Level::kDebug);
+  }
+  done = true;
+  reader.join();
+  EXPECT_TRUE(LogManager::GetCategoryLevels().empty());
+  EXPECT_TRUE(LogManager::IsLevelEnabled(LogManager::Level::kInfo, MSGID_LOAD));
+}
+
+TEST_F(LogManagerTest, RateLimitedCallSite) {
+  for (int i = 0; i < 10; ++i) {
+    LogProgress();
+  }
+  // The burst goes through, the rest is dropped unevaluated.
+  EXPECT_EQ(evaluations_, 3);
+
+  // 10 per second gives a token every 100 ms.
+  g_now_ms += 100;
+  LogProgress();
+  LogProgress();
+  EXPECT_EQ(evaluations_, 4);
+
+  g_now_ms += 10000;
+  for (int i = 0; i < 10; ++i) {
+    LogProgress();
+  }
+  EXPECT_EQ(evaluations_, 7);
+}
+
+TEST(LogRateLimiterTest, SuppressedCount) {
+  g_now_ms = 0;
+  LogRateLimiter::SetClockForTesting(&FakeClock);
+  LogRateLimiter limiter(1, 2);
+  uint64_t suppressed = 42;
+  EXPECT_TRUE(limiter.Allow(&suppressed));
+  EXPECT_EQ(suppressed, 0u);
+  EXPECT_TRUE(limiter.Allow(&suppressed));
+  for (int i = 0; i < 5; ++i) {
+    EXPECT_FALSE(limiter.Allow(&suppressed));
+  }
+  g_now_ms = 1000;
+  EXPECT_TRUE(limiter.Allow(&suppressed));
+  EXPECT_EQ(suppressed, 5u);
+  EXPECT_FALSE(limiter.Allow(&suppressed));
+  LogRateLimiter::SetClockForTesting(nullptr);
+}
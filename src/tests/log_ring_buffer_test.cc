@@ -0,0 +1,150 @@
+// Copyright (c) 2021 LG Electronics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+
+#include <stdlib.h>
+#include <unistd.h>
+
+#include <fstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "log_ring_buffer.h"
+
+namespace {
+
+class LogRingBufferTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    char path[] = "/tmp/wam-log-ring-XXXXXX";
+    fd_ = mkstemp(path);
+    ASSERT_GE(fd_, 0);
+    path_ = path;
+  }
+
+  void TearDown() override {
+    close(fd_);
+    unlink(path_.c_str());
+  }
+
+  std::vector<std::string> Lines() const {
+    std::ifstream in(path_);
+    std::vector<std::string> lines;
+    std::string line;
+    while (std::getline(in, line)) {
+      lines.push_back(line);
+    }
+    return lines;
+  }
+
+  int fd_ = -1;
+  std::string path_;
+};
+
+}  // namespace
+
+TEST_F(LogRingBufferTest, WritesInOrder) {
+  {
+    LogRingBuffer log(fd_, 8);
+    log.Start();
+    for (int i = 0; i < 100; ++i) {
+      log.Append("INFO", "MSGID_TEST", "{\"N\":%d} line", i);
+      if (i % 4 == 0) {
+        log.Flush();
+      }
+    }
+    log.Flush();
+    EXPECT_EQ(log.Pending(), 0u);
+  }
+
+  std::vector<std::string> lines = Lines();
+  ASSERT_FALSE(lines.empty());
+  EXPECT_EQ(lines[0], "[INFO] MSGID_TEST {\"N\":0} line");
+  // Lines may only be dropped, never reordered or torn.
+  int last = -1;
+  for (const std::string& line : lines) {
+    int n = -1;
+    ASSERT_EQ(sscanf(line.c_str(), "[INFO] MSGID_TEST {\"N\":%d} line", &n),
+              1)
+        << line;
+    EXPECT_GT(n, last);
+    last = n;
+  }
+  EXPECT_EQ(last, 99);
+}
+
+TEST_F(LogRingBufferTest, DropsOldestWhenFull) {
+  LogRingBuffer log(fd_, 4);
+  ASSERT_EQ(log.SlotCount(), 4u);
+  for (int i = 0; i < 10; ++i) {
+    log.Append("DEBUG", nullptr, "%d", i);
+  }
+  EXPECT_EQ(log.Pending(), 4u);
+  log.Flush();
+
+  std::vector<std::string> lines = Lines();
+  ASSERT_EQ(lines.size(), 4u);
+  EXPECT_EQ(lines.front(), "[DEBUG]  6");
+  EXPECT_EQ(lines.back(), "[DEBUG]  9");
+
+  LogRingBuffer::Stats stats = log.GetStats();
+  EXPECT_EQ(stats.appended, 10u);
+  EXPECT_EQ(stats.dropped, 6u);
+  EXPECT_EQ(stats.truncated, 0u);
+}
+
+TEST_F(LogRingBufferTest, TruncatesLongLines) {
+  LogRingBuffer log(fd_, 4);
+  const std::string long_text(LogRingBuffer::kSlotSize * 2, 'x');
+  log.Append("INFO", "MSGID_TEST", "%s", long_text.c_str());
+  log.Flush();
+
+  std::vector<std::string> lines = Lines();
+  ASSERT_EQ(lines.size(), 1u);
+  EXPECT_EQ(lines[0].size() + 1, LogRingBuffer::kSlotSize - 1);
+  EXPECT_EQ(log.GetStats().truncated, 1u);
+}
+
+TEST_F(LogRingBufferTest, OtherThreadsWriteSynchronously) {
+  LogRingBuffer log(fd_, 4);
+  log.Append("INFO", "MSGID_TEST", "first");
+  std::thread([&log] { log.Append("INFO", "MSGID_TEST", "second"); }).join();
+  // The pending line of the producer went first.
+  EXPECT_EQ(log.Pending(), 0u);
+  log.Append("INFO", "MSGID_TEST", "third");
+  log.Flush();
+
+  std::vector<std::string> lines = Lines();
+  ASSERT_EQ(lines.size(), 3u);
+  EXPECT_EQ(lines[0], "[INFO] MSGID_TEST first");
+  EXPECT_EQ(lines[1], "[INFO] MSGID_TEST second");
+  EXPECT_EQ(lines[2], "[INFO] MSGID_TEST third");
+  EXPECT_EQ(log.GetStats().synchronous, 1u);
+}
+
+TEST_F(LogRingBufferTest, FlushOnDestruction) {
+  {
+    LogRingBuffer log(fd_, 16);
+    log.Start();
+    log.Append("INFO", "MSGID_TEST", "pending");
+  }
+  std::vector<std::string> lines = Lines();
+  ASSERT_EQ(lines.size(), 1u);
+  EXPECT_EQ(lines[0], "[INFO] MSGID_TEST pending");
+}
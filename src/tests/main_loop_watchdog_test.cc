@@ -0,0 +1,168 @@
+// Copyright (c) 2021 LG Electronics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+
+#include <poll.h>
+#include <signal.h>
+
+#include <chrono>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <glib.h>
+#include <gtest/gtest.h>
+
+#include "main_loop_watchdog.h"
+#include "metrics_registry.h"
+
+// Not in an anonymous namespace, so that backtraces can name it.
+gboolean MainLoopWatchdogTestBlockingCallback(gpointer) {
+  MainLoopWatchdog::Scope scope("BlockingCallback");
+  std::this_thread::sleep_for(std::chrono::milliseconds(300));
+  return G_SOURCE_REMOVE;
+}
+
+namespace {
+
+class MainLoopWatchdogTest : public ::testing::Test {
+ protected:
+  void SetUp() override { context_ = g_main_context_new(); }
+  void TearDown() override { g_main_context_unref(context_); }
+
+  // Runs |context_| on this thread, the loop thread of the tests.
+  bool RunUntil(const std::function<bool()>& done,
+                std::chrono::milliseconds timeout) {
+    const auto deadline = std::chrono::steady_clock::now() + timeout;
+    while (!done()) {
+      if (std::chrono::steady_clock::now() > deadline) {
+        return false;
+      }
+      g_main_context_iteration(context_, FALSE);
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    return true;
+  }
+
+  void RunFor(std::chrono::milliseconds duration) {
+    RunUntil([] { return false; }, duration);
+  }
+
+  GMainContext* context_ = nullptr;
+};
+
+}  // namespace
+
+TEST_F(MainLoopWatchdogTest, ReportsBlockedCallback) {
+  MainLoopWatchdog watchdog(context_);
+  std::mutex mutex;
+  std::vector<MainLoopWatchdog::Stall> stalls;
+  watchdog.SetStallCallbackForTesting(
+      [&](const MainLoopWatchdog::Stall& stall) {
+        std::lock_guard<std::mutex> lock(mutex);
+        stalls.push_back(stall);
+      });
+
+  MainLoopWatchdog::Options options;
+  options.threshold_ms = 50;
+  options.interval_ms = 10;
+  options.capture_backtrace = true;
+  ASSERT_TRUE(watchdog.Start(options));
+  EXPECT_FALSE(watchdog.Start(options));
+
+  // A responsive loop has no stall.
+  RunFor(std::chrono::milliseconds(100));
+  EXPECT_EQ(watchdog.StallCount(), 0u);
+
+  GSource* source = g_idle_source_new();
+  g_source_set_callback(source, MainLoopWatchdogTestBlockingCallback, nullptr,
+                        nullptr);
+  g_source_attach(source, context_);
+  g_source_unref(source);
+  ASSERT_TRUE(RunUntil(
+      [&] {
+        std::lock_guard<std::mutex> lock(mutex);
+        return stalls.size() == 2;
+      },
+      std::chrono::seconds(5)));
+  watchdog.Stop();
+  EXPECT_EQ(watchdog.StallCount(), 1u);
+
+  // Reported while the callback still blocks, then again on recovery.
+  ASSERT_EQ(stalls.size(), 2u);
+  const MainLoopWatchdog::Stall& stall = stalls.front();
+  EXPECT_FALSE(stall.recovered);
+  EXPECT_EQ(stall.label, "BlockingCallback");
+  EXPECT_GE(stall.duration_ms, 50);
+  EXPECT_LT(stall.duration_ms, 300);
+  const MainLoopWatchdog::Stall& recovery = stalls.back();
+  EXPECT_TRUE(recovery.recovered);
+  EXPECT_EQ(recovery.label, "BlockingCallback");
+  EXPECT_GE(recovery.duration_ms, 200);
+  EXPECT_LT(recovery.duration_ms, 2000);
+  EXPECT_TRUE(recovery.backtrace.empty());
+  ASSERT_FALSE(stall.backtrace.empty());
+  bool found = false;
+  for (const std::string& frame : stall.backtrace) {
+    found |= frame.find("MainLoopWatchdogTestBlockingCallback") !=
+             std::string::npos;
+  }
+  EXPECT_TRUE(found);
+
+  const std::string metrics = MetricsRegistry::Instance().ToPrometheusText();
+  EXPECT_NE(
+      metrics.find("wam_main_loop_stalls_total{source=\"BlockingCallback\"}"),
+      std::string::npos);
+}
+
+TEST_F(MainLoopWatchdogTest, ReportsLoopThatNeverReturns) {
+  MainLoopWatchdog::Scope outer("Outer");
+  {
+    MainLoopWatchdog::Scope inner("Inner");
+  }
+
+  std::vector<MainLoopWatchdog::Stall> stalls;
+  {
+    MainLoopWatchdog watchdog(context_);
+    watchdog.SetStallCallbackForTesting(
+        [&](const MainLoopWatchdog::Stall& stall) { stalls.push_back(stall); });
+    MainLoopWatchdog::Options options;
+    options.threshold_ms = 20;
+    options.interval_ms = 10;
+    ASSERT_TRUE(watchdog.Start(options));
+    // The loop is not run, the ping stays pending. Without backtraces the
+    // loop thread is not signalled, so the call it is blocked in is not
+    // interrupted.
+    struct sigaction action = {};
+    struct sigaction previous;
+    action.sa_handler = [](int) {};
+    sigemptyset(&action.sa_mask);
+    ASSERT_EQ(sigaction(SIGURG, &action, &previous), 0);
+    EXPECT_EQ(poll(nullptr, 0, 100), 0);
+    sigaction(SIGURG, &previous, nullptr);
+    watchdog.Stop();
+    EXPECT_FALSE(watchdog.IsRunning());
+  }
+  ASSERT_EQ(stalls.size(), 1u);
+  EXPECT_FALSE(stalls.front().recovered);
+  EXPECT_EQ(stalls.front().label, "Outer");
+
+  // The cancelled ping is never dispatched to the watchdog which is gone.
+  RunFor(std::chrono::milliseconds(20));
+  EXPECT_EQ(stalls.size(), 1u);
+}
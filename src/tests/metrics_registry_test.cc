@@ -0,0 +1,198 @@
+// Copyright (c) 2021 LG Electronics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "metrics_registry.h"
+
+namespace fs = std::filesystem;
+
+namespace {
+
+std::string ReadFile(const fs::path& path) {
+  std::ifstream file(path);
+  std::stringstream content;
+  content << file.rdbuf();
+  return content.str();
+}
+
+}  // namespace
+
+TEST(MetricsRegistryTest, PrometheusTextFormat) {
+  CounterFamily launches("test_launches_total", "Apps launched", "app_id");
+  GaugeFamily apps("test_apps", "Running apps\nby state");
+  HistogramFamily load("test_load_seconds", "Load time", "app_id",
+                       {0.005, 0.5, 2});
+
+  launches.WithLabel("com.webos.app.a").Increment();
+  launches.WithLabel("com.webos.app.a").Increment(2);
+  launches.WithLabel("quote\"back\\slash").Increment();
+  apps.Get().Set(4);
+  apps.Get().Add(-1);
+  load.WithLabel("com.webos.app.a").Observe(0.004);
+  load.WithLabel("com.webos.app.a").Observe(0.25);
+  load.WithLabel("com.webos.app.a").Observe(7);
+
+  const std::string text = MetricsRegistry::Instance().ToPrometheusText();
+  EXPECT_NE(text.find("# HELP test_launches_total Apps launched\n"
+                      "# TYPE test_launches_total counter\n"
+                      "test_launches_total{app_id=\"com.webos.app.a\"} 3\n"
+                      "test_launches_total{app_id=\"quote\\\"back\\\\slash\"}"
+                      " 1\n"),
+            std::string::npos)
+      << text;
+  EXPECT_NE(text.find("# HELP test_apps Running apps\\nby state\n"
+                      "# TYPE test_apps gauge\n"
+                      "test_apps 3\n"),
+            std::string::npos)
+      << text;
+  EXPECT_NE(
+      text.find("# TYPE test_load_seconds histogram\n"
+                "test_load_seconds_bucket{app_id=\"com.webos.app.a\","
+                "le=\"0.005\"} 1\n"
+                "test_load_seconds_bucket{app_id=\"com.webos.app.a\","
+                "le=\"0.5\"} 2\n"
+                "test_load_seconds_bucket{app_id=\"com.webos.app.a\","
+                "le=\"2\"} 2\n"
+                "test_load_seconds_bucket{app_id=\"com.webos.app.a\","
+                "le=\"+Inf\"} 3\n"
+                "test_load_seconds_sum{app_id=\"com.webos.app.a\"} 7.254\n"
+                "test_load_seconds_count{app_id=\"com.webos.app.a\"} 3\n"),
+      std::string::npos)
+      << text;
+  // Families are sorted and the labeled ones have no unlabeled sample.
+  EXPECT_LT(text.find("test_apps"), text.find("test_launches_total"));
+  EXPECT_EQ(text.find("test_launches_total 0"), std::string::npos);
+
+  launches.RemoveLabel("com.webos.app.a");
+  EXPECT_EQ(MetricsRegistry::Instance().ToPrometheusText().find(
+                "test_launches_total{app_id=\"com.webos.app.a\"}"),
+            std::string::npos);
+}
+
+TEST(MetricsRegistryTest, Collectors) {
+  GaugeFamily collected("test_collected", "Set by a collector");
+  int runs = 0;
+  const int id = MetricsRegistry::Instance().AddCollector([&] {
+    collected.Get().Set(++runs * 10);
+  });
+  EXPECT_NE(MetricsRegistry::Instance().ToPrometheusText().find(
+                "test_collected 10\n"),
+            std::string::npos);
+  MetricsRegistry::Instance().RemoveCollector(id);
+  MetricsRegistry::Instance().ToPrometheusText();
+  EXPECT_EQ(runs, 1);
+}
+
+TEST(MetricsRegistryTest, RecordingIsLockFree) {
+  static_assert(std::atomic<uint64_t>::is_always_lock_free);
+  static_assert(std::atomic<int64_t>::is_always_lock_free);
+  static_assert(std::atomic<double>::is_always_lock_free);
+
+  CounterFamily counter("test_contended_total", "Contended counter");
+  CounterFamily labeled("test_contended_labeled_total", "Contended", "app");
+  GaugeFamily gauge("test_contended_gauge", "Contended gauge");
+  HistogramFamily histogram("test_contended_seconds", "Contended", "",
+                            {1, 10});
+  MetricCounter& child = labeled.WithLabel("app");
+
+  constexpr int kThreads = 8;
+  constexpr int kIterations = 100000;
+  {
+    // Recording threads would never finish if they took the lock.
+    auto lock = MetricsRegistry::Instance().LockForTesting();
+    std::vector<std::thread> threads;
+    for (int i = 0; i < kThreads; ++i) {
+      threads.emplace_back([&] {
+        for (int j = 0; j < kIterations; ++j) {
+          counter.Get().Increment();
+          child.Increment();
+          gauge.Get().Add(j % 2 ? -1 : 1);
+          histogram.Get().Observe(j % 20);
+        }
+      });
+    }
+    for (std::thread& thread : threads) {
+      thread.join();
+    }
+  }
+
+  EXPECT_EQ(counter.Get().Value(), uint64_t{kThreads} * kIterations);
+  EXPECT_EQ(child.Value(), uint64_t{kThreads} * kIterations);
+  EXPECT_EQ(gauge.Get().Value(), 0);
+  EXPECT_EQ(histogram.Get().Count(), uint64_t{kThreads} * kIterations);
+  EXPECT_EQ(histogram.Get().BucketValue(0), uint64_t{kThreads} * 10000);
+  EXPECT_DOUBLE_EQ(histogram.Get().Sum(), 9.5 * kThreads * kIterations);
+}
+
+TEST(MetricsRegistryTest, ExportToFileAndSocket) {
+  CounterFamily exported("test_exported_total", "Exported");
+  exported.Get().Increment();
+
+  std::string pattern =
+      (fs::temp_directory_path() / "wam-metrics-XXXXXX").string();
+  ASSERT_NE(mkdtemp(pattern.data()), nullptr);
+  const fs::path dir = pattern;
+
+  const fs::path file = dir / "wam.prom";
+  ASSERT_TRUE(MetricsRegistry::Instance().Export(file.string()));
+  EXPECT_NE(ReadFile(file).find("test_exported_total 1\n"), std::string::npos);
+  EXPECT_FALSE(fs::exists(dir / "wam.prom.tmp"));
+  EXPECT_FALSE(MetricsRegistry::Instance().Export((dir / "no/file").string()));
+
+  const fs::path socket_path = dir / "metrics.sock";
+  int server = socket(AF_UNIX, SOCK_STREAM, 0);
+  ASSERT_GE(server, 0);
+  sockaddr_un address{};
+  address.sun_family = AF_UNIX;
+  strncpy(address.sun_path, socket_path.c_str(), sizeof(address.sun_path) - 1);
+  ASSERT_EQ(bind(server, reinterpret_cast<sockaddr*>(&address),
+                 sizeof(address)),
+            0);
+  ASSERT_EQ(listen(server, 1), 0);
+
+  std::string received;
+  std::thread reader([&] {
+    int client = accept(server, nullptr, nullptr);
+    char buffer[4096];
+    ssize_t size;
+    while ((size = read(client, buffer, sizeof(buffer))) > 0) {
+      received.append(buffer, size);
+    }
+    close(client);
+  });
+  EXPECT_TRUE(MetricsRegistry::Instance().Export(socket_path.string()));
+  reader.join();
+  close(server);
+  EXPECT_NE(received.find("test_exported_total 1\n"), std::string::npos);
+
+  fs::remove_all(dir);
+}
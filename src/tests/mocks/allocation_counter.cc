@@ -0,0 +1,67 @@
+// Copyright (c) 2021 LG Electronics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+
+#include "allocation_counter.h"
+
+#include <cstdlib>
+#include <new>
+
+namespace {
+
+// Per thread so that background threads (log writer, file io workers) do not
+// disturb the counts of the test thread.
+thread_local size_t allocation_count = 0;
+
+void* CountedAllocation(size_t size) {
+  ++allocation_count;
+  if (void* ptr = std::malloc(size ? size : 1)) {
+    return ptr;
+  }
+  std::abort();
+}
+
+}  // namespace
+
+AllocationCounter::AllocationCounter() : start_(allocation_count) {}
+
+size_t AllocationCounter::Count() const {
+  return allocation_count - start_;
+}
+
+void* operator new(size_t size) {
+  return CountedAllocation(size);
+}
+
+void* operator new[](size_t size) {
+  return CountedAllocation(size);
+}
+
+void operator delete(void* ptr) noexcept {
+  std::free(ptr);
+}
+
+void operator delete[](void* ptr) noexcept {
+  std::free(ptr);
+}
+
+void operator delete(void* ptr, size_t) noexcept {
+  std::free(ptr);
+}
+
+void operator delete[](void* ptr, size_t) noexcept {
+  std::free(ptr);
+}
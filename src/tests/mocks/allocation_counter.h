@@ -0,0 +1,38 @@
+// Copyright (c) 2021 LG Electronics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+
+#ifndef TESTS_MOCKS_ALLOCATION_COUNTER_H_
+#define TESTS_MOCKS_ALLOCATION_COUNTER_H_
+
+#include <cstddef>
+
+// Number of global operator new calls made by the constructing thread since
+// construction. The replacement operators live in allocation_counter.cc so
+// that every test of the binary shares one definition.
+class AllocationCounter {
+ public:
+  AllocationCounter();
+  AllocationCounter(const AllocationCounter&) = delete;
+  AllocationCounter& operator=(const AllocationCounter&) = delete;
+
+  size_t Count() const;
+
+ private:
+  const size_t start_;
+};
+
+#endif  // TESTS_MOCKS_ALLOCATION_COUNTER_H_
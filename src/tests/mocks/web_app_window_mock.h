@@ -26,7 +26,10 @@ class WebAppWindowMock : public WebAppWindow {
   WebAppWindowMock() = default;
   ~WebAppWindowMock() override = default;
 
-  void SetInputRegion(const std::vector<gfx::Rect>&) override {}
+  MOCK_METHOD(void,
+              SetInputRegion,
+              (const std::vector<gfx::Rect>&),
+              (override));
   MOCK_METHOD(int, DisplayWidth, (), (override));
   MOCK_METHOD(int, DisplayHeight, (), (override));
   MOCK_METHOD(void, InitWindow, (int, int), (override));
@@ -103,6 +103,10 @@ class WebViewMock : public WebView {
   MOCK_METHOD(void, DeactivateRendererCompositor, (), (override));
   MOCK_METHOD(const std::string&, GetUrl, (), (override));
   MOCK_METHOD(void, UpdatePreferences, (), (override));
+  MOCK_METHOD(void,
+              SetPreferences,
+              (const WebPreferenceProfile::Changes&),
+              (override));
   MOCK_METHOD(void, ResetStateToMarkNextPaint, (), (override));
   MOCK_METHOD(void, SetAllowRunningInsecureContent, (bool), (override));
   MOCK_METHOD(void, SetAllowScriptsToCloseWindows, (bool), (override));
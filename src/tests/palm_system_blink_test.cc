@@ -14,21 +14,31 @@
 //
 // SPDX-License-Identifier: Apache-2.0
 
+#include <cstdint>
+#include <memory>
 #include <string>
+#include <string_view>
+#include <utility>
 #include <vector>
 
 #include <gmock/gmock.h>
 #include <gtest/gtest.h>
 #include <json/json.h>
 
+#include "application_description.h"
+#include "device_info_snapshot.h"
+#include "metrics_registry.h"
+#include "palm_system_blink.h"
 #include "platform_module_factory_impl.h"
 #include "utils.h"
+#include "web_app_base.h"
 #include "web_app_factory_manager_mock.h"
 #include "web_app_manager.h"
 #include "web_app_manager_service_luna.h"
 #include "web_app_wayland.h"
 #include "web_app_window_factory_mock.h"
 #include "web_app_window_mock.h"
+#include "web_page_base.h"
 #include "web_page_blink_delegate.h"
 #include "web_view_factory_mock.h"
 #include "web_view_mock.h"
@@ -41,6 +51,7 @@ using ::testing::AnyNumber;
 using ::testing::Eq;
 using ::testing::Invoke;
 using ::testing::Return;
+using ::testing::SaveArg;
 using ::testing::ReturnRef;
 using ::testing::StrEq;
 
@@ -134,6 +145,48 @@ static constexpr char kLocaleInfo[] = R"({
     }
 })";
 
+// Builds the initialize() payload field by field, as it was built before the
+// page independent part was shared.
+class ReferencePalmSystem : public PalmSystemBlink {
+ public:
+  explicit ReferencePalmSystem(WebAppBase* app) : PalmSystemBlink(app) {}
+
+  std::string Payload() {
+    std::shared_ptr<const DeviceInfoSnapshot> device_info =
+        GetDeviceInfoSnapshot();
+    launch_params_ = app_->Page()->LaunchParams();
+
+    Json::Value data;
+    data["launchParams"] = LaunchParams();
+    data["country"] = Country();
+    data["tvSystemName"] = device_info->TvSystemName();
+    data["currentCountryGroup"] = device_info->CountryGroup();
+    data["locale"] = Locale();
+    data["localeRegion"] = LocaleRegion();
+    data["isMinimal"] = IsMinimal();
+    data["identifier"] = Identifier();
+    data["screenOrientation"] = ScreenOrientation();
+    data["deviceInfo"] = device_info->TvDeviceInfo();
+    data["activityId"] = static_cast<double>(ActivityId());
+    data["phoneRegion"] = PhoneRegion();
+    data["folderPath"] = app_->GetAppDescription()->FolderPath();
+
+    data["devicePixelRatio"] = DevicePixelRatio();
+    data["trustLevel"] = TrustLevel();
+    return util::JsonToString(data);
+  }
+};
+
+// Reports the first use as finished once |ran_first_use| is set.
+class FirstUsePalmSystem : public PalmSystemBlink {
+ public:
+  explicit FirstUsePalmSystem(WebAppBase* app) : PalmSystemBlink(app) {}
+
+  bool IsMinimal() const override { return ran_first_use; }
+
+  bool ran_first_use = false;
+};
+
 }  // namespace
 
 class PalmSystemBlinkTestSuite : public ::testing::Test {
@@ -394,3 +447,226 @@ TEST_F(PalmSystemBlinkTestSuite, handleBrowserControlMessage_PmLogString) {
   web_view_delegate_->HandleBrowserControlFunction("PmLogString", params,
                                                    &return_value);
 }
+
+TEST_F(PalmSystemBlinkTestSuite, handleBrowserControlMessage_everyCommand) {
+  const std::vector<std::pair<std::string, std::vector<std::string>>>
+      commands = {
+          {"initialize", {}},
+          {"country", {}},
+          {"locale", {}},
+          {"localeRegion", {}},
+          {"isMinimal", {}},
+          {"identifier", {}},
+          {"getIdentifier", {}},
+          {"screenOrientation", {}},
+          {"currentCountryGroup", {}},
+          {"stageReady", {}},
+          {"activate", {}},
+          {"deactivate", {}},
+          {"isActivated", {}},
+          {"isKeyboardVisible", {}},
+          {"launchParams", {"{}"}},
+          {"keepAlive", {"false"}},
+          {"PmLogInfoWithClock", {"", "", ""}},
+          {"PmLogString", {"7", "", "", ""}},
+          {"setWindowProperty", {"TestProperty", "TestValue"}},
+          {"platformBack", {}},
+          {"setCursor", {"Cursor", "1", "2"}},
+          {"setInputRegion", {"[]"}},
+          {"setKeyMask", {"[]"}},
+          {"focusOwner", {}},
+          {"focusLayer", {}},
+          {"hide", {}},
+          {"setLoadErrorPolicy", {"default"}},
+          {"onCloseNotify", {"didClearOnCloseCallback"}},
+          {"cursorVisibility", {}},
+          {"serviceCall", {"luna://com.webos.service/method", "{}"}},
+      };
+
+  std::vector<std::string_view> names = PalmSystemBlink::CommandNames();
+  ASSERT_EQ(names.size(), commands.size());
+  for (size_t i = 0; i < commands.size(); ++i) {
+    EXPECT_EQ(names[i], commands[i].first);
+  }
+
+  const uint64_t unknown = PalmSystemBlink::UnknownCommandCount();
+  for (const auto& [command, arguments] : commands) {
+    const uint64_t count = PalmSystemBlink::CommandCount(command);
+    std::string return_value;
+    web_view_delegate_->HandleBrowserControlFunction(command, arguments,
+                                                     &return_value);
+    EXPECT_EQ(PalmSystemBlink::CommandCount(command), count + 1) << command;
+  }
+  EXPECT_EQ(PalmSystemBlink::UnknownCommandCount(), unknown);
+
+  const std::string metrics = MetricsRegistry::Instance().ToPrometheusText();
+  for (const auto& command : names) {
+    const std::string sample =
+        "wam_palmsystem_commands_total{command=\"" + std::string(command) +
+        "\"} " + std::to_string(PalmSystemBlink::CommandCount(command)) +
+        "\n";
+    EXPECT_NE(metrics.find(sample), std::string::npos) << sample;
+  }
+}
+
+TEST_F(PalmSystemBlinkTestSuite, handleBrowserControlMessage_unknownCommand) {
+  const uint64_t unknown = PalmSystemBlink::UnknownCommandCount();
+  for (const char* command :
+       {"", "keyboardShow", "Initialize", "initialize "}) {
+    std::string return_value = "unchanged";
+    web_view_delegate_->HandleBrowserControlFunction(
+        command, std::vector<std::string>(), &return_value);
+    EXPECT_TRUE(return_value.empty()) << command;
+    EXPECT_EQ(PalmSystemBlink::CommandCount(command), 0u) << command;
+  }
+  EXPECT_EQ(PalmSystemBlink::UnknownCommandCount(), unknown + 4);
+  EXPECT_NE(MetricsRegistry::Instance().ToPrometheusText().find(
+                "wam_palmsystem_unknown_commands_total " +
+                std::to_string(unknown + 4) + "\n"),
+            std::string::npos);
+}
+
+TEST_F(PalmSystemBlinkTestSuite, initializePayload_sameAsReference) {
+  ReferencePalmSystem reference(web_app_);
+
+  std::string built;
+  web_view_delegate_->HandleBrowserControlFunction(
+      "initialize", std::vector<std::string>(), &built);
+  std::string cached;
+  web_view_delegate_->HandleBrowserControlFunction(
+      "initialize", std::vector<std::string>(), &cached);
+
+  EXPECT_EQ(built, reference.Payload());
+  EXPECT_EQ(cached, built);
+}
+
+TEST_F(PalmSystemBlinkTestSuite, initializePayload_noRebuildOnHotPath) {
+  std::string return_value;
+  web_view_delegate_->HandleBrowserControlFunction(
+      "initialize", std::vector<std::string>(), &return_value);
+
+  // Later pages and the getters reuse the payload; isMinimal is not part of
+  // it.
+  const PalmSystemBlink::InitializePayloadStats& stats =
+      PalmSystemBlink::GetInitializePayloadStats();
+  const uint64_t builds = stats.builds;
+  const uint64_t hits = stats.hits;
+  for (const char* command :
+       {"initialize", "isMinimal", "country", "locale", "initialize"}) {
+    web_view_delegate_->HandleBrowserControlFunction(
+        command, std::vector<std::string>(), &return_value);
+  }
+  EXPECT_EQ(stats.builds, builds);
+  EXPECT_EQ(stats.hits, hits + 4);
+}
+
+TEST_F(PalmSystemBlinkTestSuite, initializePayload_isMinimalNotCached) {
+  FirstUsePalmSystem palm_system(web_app_);
+  const std::vector<std::string> arguments;
+  EXPECT_EQ(palm_system.HandleBrowserControlMessage("isMinimal", arguments),
+            "false");
+  Json::Value payload;
+  ASSERT_TRUE(util::StringToJson(
+      palm_system.HandleBrowserControlMessage("initialize", arguments),
+      payload));
+  EXPECT_FALSE(payload["isMinimal"].asBool());
+
+  // The device info does not change when the first use finishes.
+  palm_system.ran_first_use = true;
+  EXPECT_EQ(palm_system.HandleBrowserControlMessage("isMinimal", arguments),
+            "true");
+  ASSERT_TRUE(util::StringToJson(
+      palm_system.HandleBrowserControlMessage("initialize", arguments),
+      payload));
+  EXPECT_TRUE(payload["isMinimal"].asBool());
+}
+
+TEST_F(PalmSystemBlinkTestSuite, initializePayload_deviceInfoChange) {
+  ReferencePalmSystem reference(web_app_);
+  std::string return_value;
+  web_view_delegate_->HandleBrowserControlFunction(
+      "initialize", std::vector<std::string>(), &return_value);
+  const uint64_t builds = PalmSystemBlink::GetInitializePayloadStats().builds;
+
+  std::string country;
+  WebAppManager::Instance()->GetDeviceInfo("LocalCountry", country);
+  WebAppManager::Instance()->SetDeviceInfo("LocalCountry", "KOR");
+
+  web_view_delegate_->HandleBrowserControlFunction(
+      "initialize", std::vector<std::string>(), &return_value);
+  EXPECT_EQ(PalmSystemBlink::GetInitializePayloadStats().builds, builds + 1);
+  EXPECT_EQ(return_value, reference.Payload());
+
+  web_view_delegate_->HandleBrowserControlFunction(
+      "country", std::vector<std::string>(), &return_value);
+  EXPECT_NE(return_value.find("KOR"), std::string::npos);
+
+  WebAppManager::Instance()->SetDeviceInfo("LocalCountry", country);
+}
+
+TEST_F(PalmSystemBlinkTestSuite, setInputRegion_coalescedPerFrame) {
+  std::vector<gfx::Rect> region;
+  EXPECT_CALL(*web_app_window_, SetInputRegion(_))
+      .Times(2)
+      .WillRepeatedly(SaveArg<0>(&region));
+
+  std::string return_value;
+  for (int width = 100; width <= 1000; width += 100) {
+    const std::string params = R"([{"x": 0, "y": 0, "width": )" +
+                               std::to_string(width) + R"(, "height": 50}])";
+    web_view_delegate_->HandleBrowserControlFunction(
+        "setInputRegion", std::vector<std::string>{params}, &return_value);
+  }
+  // Only the first update of the frame reached the window so far, the last
+  // one is sent when the frame ends.
+  ASSERT_EQ(region.size(), 1u);
+  const int first_width = region[0].width();
+
+  web_app_->FlushWindowUpdates();
+  ASSERT_EQ(region.size(), 1u);
+  EXPECT_EQ(region[0].width(), first_width * 10);
+  web_app_->FlushWindowUpdates();
+}
+
+TEST_F(PalmSystemBlinkTestSuite, setKeyMask_unchangedNotSent) {
+  EXPECT_CALL(*web_app_window_, SetKeyMask(webos::WebOSKeyMask::KEY_MASK_BACK))
+      .Times(1);
+
+  std::string return_value;
+  for (int frame = 0; frame < 10; ++frame) {
+    web_view_delegate_->HandleBrowserControlFunction(
+        "setKeyMask", std::vector<std::string>{R"(["KeyMaskBack"])"},
+        &return_value);
+    web_app_->FlushWindowUpdates();
+  }
+}
+
+TEST_F(PalmSystemBlinkTestSuite, windowUpdates_onlyChangesSentPerFrame) {
+  constexpr int kFrames = 60;
+  constexpr int kUpdatesPerFrame = 3;
+  int region_calls = 0;
+  int key_mask_calls = 0;
+  EXPECT_CALL(*web_app_window_, SetInputRegion(_))
+      .WillRepeatedly([&](const std::vector<gfx::Rect>&) { ++region_calls; });
+  EXPECT_CALL(*web_app_window_, SetKeyMask(_))
+      .WillRepeatedly([&](webos::WebOSKeyMask) { ++key_mask_calls; });
+
+  // An animation that sends the same key mask on every frame, and moves
+  // its input region every 10th frame, sending it a few times per frame.
+  std::string return_value;
+  for (int frame = 0; frame < kFrames; ++frame) {
+    const std::string region = R"([{"x": )" + std::to_string(frame / 10) +
+                               R"(, "y": 0, "width": 320, "height": 80}])";
+    for (int i = 0; i < kUpdatesPerFrame; ++i) {
+      web_view_delegate_->HandleBrowserControlFunction(
+          "setInputRegion", std::vector<std::string>{region}, &return_value);
+    }
+    web_view_delegate_->HandleBrowserControlFunction(
+        "setKeyMask", std::vector<std::string>{R"(["KeyMaskHome"])"},
+        &return_value);
+    web_app_->FlushWindowUpdates();
+  }
+
+  EXPECT_EQ(region_calls, kFrames / 10);
+  EXPECT_EQ(key_mask_calls, 1);
+}
@@ -0,0 +1,280 @@
+// Copyright (c) 2021 LG Electronics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#include <cstdint>
+#include <optional>
+#include <string>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include <json/json.h>
+
+#include "base_mock_initializer.h"
+#include "deferred_replies.h"
+#include "reply_cache.h"
+#include "utils.h"
+#include "web_app_manager_service_luna.h"
+#include "web_view_mock_impl.h"
+
+namespace {
+
+constexpr int kPid = 4312;
+constexpr char kAppId[] = "bareapp";
+constexpr char kInstanceId[] = "de90e74a-b86b-42c8-8785-3efd927a36430";
+
+// TODO: Move it to separate file.
+constexpr char kLaunchAppJsonBody[] = R"({
+  "launchingAppId": "com.webos.app.home",
+  "appDesc": {
+    "defaultWindowType": "card",
+    "uiRevision": "2",
+    "systemApp": true,
+    "version": "1.0.1",
+    "vendor": "LG Electronics, Inc.",
+    "miniicon": "icon.png",
+    "hasPromotion": false,
+    "tileSize": "normal",
+    "icons": [],
+    "launchPointId": "bareapp_default",
+    "largeIcon": "/usr/palm/applications/bareapp/icon.png",
+    "lockable": true,
+    "transparent": false,
+    "icon": "/usr/palm/applications/bareapp/icon.png",
+    "checkUpdateOnLaunch": true,
+    "imageForRecents": "",
+    "spinnerOnLaunch": true,
+    "handlesRelaunch": false,
+    "unmovable": false,
+    "id": "bareapp",
+    "inspectable": false,
+    "noSplashOnLaunch": false,
+    "privilegedJail": false,
+    "trustLevel": "default",
+    "title": "Bare App",
+    "deeplinkingParams": "",
+    "lptype": "default",
+    "inAppSetting": false,
+    "favicon": "",
+    "visible": true,
+    "accessibility": {
+      "supportsAudioGuidance": false
+    },
+    "folderPath": "/usr/palm/applications/bareapp",
+    "main": "index.html",
+    "removable": true,
+    "type": "web",
+    "disableBackHistoryAPI": false,
+    "bgImage": ""
+  },
+  "appId": "bareapp",
+  "parameters": {
+    "displayAffinity": 0
+  },
+  "reason": "com.webos.app.home",
+  "launchingProcId": "",
+  "instanceId": "de90e74a-b86b-42c8-8785-3efd927a36430"
+})";
+
+int64_t fake_now_ms = 0;
+
+int64_t FakeClock() {
+  return fake_now_ms;
+}
+
+Json::Value Request(bool include_sys_apps) {
+  Json::Value request;
+  request["includeSysApps"] = include_sys_apps;
+  return request;
+}
+
+// Caches a reply to listRunningApps and tells if it is still there after
+// |event|.
+template <typename Event>
+bool KeptAfter(Event event) {
+  ReplyCache& cache = WebAppManagerServiceLuna::Instance()->GetReplyCache();
+  std::optional<ReplyCache::Key> key =
+      cache.KeyFor("listRunningApps", Request(true));
+  if (!key) {
+    ADD_FAILURE() << "listRunningApps is not cached";
+    return false;
+  }
+  cache.Put(*key, R"({"returnValue":true,"running":[]})");
+  if (!cache.Get(*key)) {
+    ADD_FAILURE() << "reply was not kept";
+    return false;
+  }
+
+  event();
+  return cache.Get(*cache.KeyFor("listRunningApps", Request(true))) !=
+         nullptr;
+}
+
+}  // namespace
+
+TEST(ReplyCacheTest, TimeToLive) {
+  ReplyCache cache;
+  cache.SetClockForTesting(&FakeClock);
+  cache.Enable("getWebProcessSize", 1000);
+  fake_now_ms = 5000;
+
+  std::optional<ReplyCache::Key> key =
+      cache.KeyFor("getWebProcessSize", Json::Value(Json::objectValue));
+  ASSERT_TRUE(key);
+  EXPECT_FALSE(cache.Get(*key));
+  cache.Put(*key, "reply");
+
+  fake_now_ms += 999;
+  ReplyCache::Content first = cache.Get(*key);
+  ReplyCache::Content second = cache.Get(*key);
+  ASSERT_TRUE(first);
+  EXPECT_EQ(*first, "reply");
+  // Hits share the serialized reply.
+  EXPECT_EQ(first.get(), second.get());
+
+  fake_now_ms += 1;
+  EXPECT_FALSE(cache.Get(*key));
+  EXPECT_EQ(cache.GetStats().hits, 2u);
+  EXPECT_EQ(cache.GetStats().misses, 2u);
+  cache.SetClockForTesting(nullptr);
+}
+
+TEST(ReplyCacheTest, CanonicalRequest) {
+  ReplyCache cache;
+  cache.Enable("listRunningApps", 1000);
+  EXPECT_FALSE(cache.KeyFor("killApp", Request(true)));
+
+  Json::Value parsed;
+  ASSERT_TRUE(util::StringToJson(
+      R"({ "subscribe": false,  "includeSysApps": true })", parsed));
+  Json::Value built;
+  built["includeSysApps"] = true;
+  built["subscribe"] = false;
+
+  std::optional<ReplyCache::Key> key = cache.KeyFor("listRunningApps", parsed);
+  ASSERT_TRUE(key);
+  cache.Put(*key, "all apps");
+  ReplyCache::Content reply =
+      cache.Get(*cache.KeyFor("listRunningApps", built));
+  ASSERT_TRUE(reply);
+  EXPECT_EQ(*reply, "all apps");
+
+  EXPECT_FALSE(cache.Get(*cache.KeyFor("listRunningApps", Request(false))));
+}
+
+TEST(ReplyCacheTest, InvalidationDropsStaleReplies) {
+  ReplyCache cache;
+  cache.Enable("listRunningApps", 1000);
+  std::optional<ReplyCache::Key> key =
+      cache.KeyFor("listRunningApps", Request(true));
+  ASSERT_TRUE(key);
+  cache.Put(*key, "before");
+
+  cache.Invalidate();
+  EXPECT_FALSE(cache.Get(*key));
+  EXPECT_EQ(cache.GetStats().entries, 0u);
+
+  // Built before the change, so not kept.
+  cache.Put(*key, "in flight");
+  EXPECT_EQ(cache.GetStats().entries, 0u);
+  key = cache.KeyFor("listRunningApps", Request(true));
+  cache.Put(*key, "after");
+  ASSERT_TRUE(cache.Get(*key));
+  EXPECT_EQ(*cache.Get(*key), "after");
+}
+
+TEST(ReplyCacheTest, SizeBound) {
+  ReplyCache cache(1);
+  cache.Enable("listRunningApps", 1000);
+  std::optional<ReplyCache::Key> all =
+      cache.KeyFor("listRunningApps", Request(true));
+  std::optional<ReplyCache::Key> user =
+      cache.KeyFor("listRunningApps", Request(false));
+  cache.Put(*all, "all apps");
+  cache.Put(*user, "user apps");
+  EXPECT_TRUE(cache.Get(*all));
+  EXPECT_FALSE(cache.Get(*user));
+  EXPECT_EQ(cache.GetStats().entries, 1u);
+}
+
+TEST(ReplyCacheTest, KeepsDeferredReply) {
+  ReplyCache cache;
+  cache.Enable("getWebProcessSize", 1000);
+  std::optional<ReplyCache::Key> key =
+      cache.KeyFor("getWebProcessSize", Json::Value(Json::objectValue));
+  ASSERT_TRUE(key);
+
+  DeferredReplies::Bus bus;
+  bus.ref = [](LSMessage*) {};
+  bus.unref = [](LSMessage*) {};
+  bus.reply = [](LSHandle*, LSMessage*, const std::string&) { return true; };
+  DeferredReplies replies(nullptr, bus);
+  auto sent = [&cache, key = *key](const std::string& payload) {
+    cache.Put(key, payload);
+  };
+
+  Json::Value failed;
+  failed["returnValue"] = false;
+  std::optional<DeferredReplies::Reply> reply = replies.Defer(
+      nullptr, nullptr, ServiceMetrics::kInvalidCallId, sent);
+  ASSERT_TRUE(reply);
+  reply->Send(failed);
+  EXPECT_FALSE(cache.Get(*key));
+
+  Json::Value succeeded;
+  succeeded["returnValue"] = true;
+  reply = replies.Defer(nullptr, nullptr, ServiceMetrics::kInvalidCallId,
+                        sent);
+  ASSERT_TRUE(reply);
+  reply->Send(succeeded);
+  ReplyCache::Content cached = cache.Get(*key);
+  ASSERT_TRUE(cached);
+  EXPECT_EQ(*cached, util::JsonToString(succeeded));
+}
+
+TEST(ReplyCacheTest, InvalidatedOnAppStateChanges) {
+  BaseMockInitializer<NiceWebViewMockImpl> mock_initializer;
+  mock_initializer.GetWebViewMock()->SetOnInitActions();
+  mock_initializer.GetWebViewMock()->SetOnLoadURLActions();
+  EXPECT_CALL(*mock_initializer.GetWebViewMock(), RenderProcessPid())
+      .WillRepeatedly(testing::Return(kPid));
+  WebAppManagerServiceLuna* luna_service = WebAppManagerServiceLuna::Instance();
+
+  // Every event which posts the running app list drops the cached replies.
+  EXPECT_FALSE(KeptAfter([&] {
+    Json::Value request;
+    ASSERT_TRUE(util::StringToJson(kLaunchAppJsonBody, request));
+    ASSERT_TRUE(luna_service->launchApp(request)["returnValue"].asBool());
+  }));
+
+  EXPECT_FALSE(KeptAfter([&] {
+    WebPageBlinkDelegate* delegate =
+        mock_initializer.GetWebViewMock()->GetWebViewDelegate();
+    ASSERT_TRUE(delegate);
+    delegate->RenderProcessCreated(kPid);
+  }));
+
+  Json::Value memory_request;
+  memory_request["appId"] = kAppId;
+  EXPECT_TRUE(
+      KeptAfter([&] { luna_service->getAppMemoryUsage(memory_request); }));
+
+  EXPECT_FALSE(KeptAfter([&] {
+    Json::Value request;
+    request["instanceId"] = kInstanceId;
+    request["appId"] = kAppId;
+    ASSERT_TRUE(luna_service->killApp(request)["returnValue"].asBool());
+  }));
+}
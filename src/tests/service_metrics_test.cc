@@ -0,0 +1,222 @@
+// Copyright (c) 2021 LG Electronics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <string>
+
+#include <gtest/gtest.h>
+#include <json/json.h>
+
+#include "service_metrics.h"
+#include "utils.h"
+#include "web_app_manager_service_luna.h"
+
+namespace {
+
+int64_t fake_now_us = 0;
+
+int64_t FakeClock() {
+  return fake_now_us;
+}
+
+// Stands for the LS2 bus: hands out tokens per handle and delivers the
+// replies when the test says so, recording through the same hooks the
+// PalmServiceBase templates use.
+class FakeBus {
+ public:
+  explicit FakeBus(ServiceMetrics& metrics) : metrics_(metrics) {}
+
+  uint64_t Call(const void* handle, const std::string& uri) {
+    const uint64_t token = ++tokens_[handle];
+    metrics_.BeginCallout(uri, handle, token);
+    return token;
+  }
+
+  void Reply(const void* handle, uint64_t token, const char* payload) {
+    Json::Value reply;
+    bool parsed = util::StringToJson(payload, reply);
+    metrics_.EndCallout(handle, token,
+                        parsed && ServiceMetrics::Succeeded(reply));
+  }
+
+  Json::Value Dispatch(
+      const std::string& method,
+      const std::function<Json::Value(const Json::Value&)>& handler,
+      const Json::Value& request) {
+    const ServiceMetrics::CallId call = metrics_.BeginCall(method);
+    Json::Value reply = handler(request);
+    metrics_.EndCall(call, ServiceMetrics::Succeeded(reply));
+    return reply;
+  }
+
+ private:
+  ServiceMetrics& metrics_;
+  std::map<const void*, uint64_t> tokens_;
+};
+
+class ServiceMetricsTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    fake_now_us = 1000;
+    metrics_.SetClockForTesting(&FakeClock);
+  }
+
+  ServiceMetrics metrics_;
+  FakeBus bus_{metrics_};
+  const int wam_handle_ = 0;
+  const int plugin_handle_ = 0;
+};
+
+constexpr char kSettings[] =
+    "luna://com.webos.settingsservice/getSystemSettings";
+constexpr char kMemoryManager[] =
+    "luna://com.webos.memorymanager/getCloseAppId";
+
+}  // namespace
+
+TEST_F(ServiceMetricsTest, InboundLatencyPerMethod) {
+  auto handler = [](const Json::Value& request) {
+    fake_now_us += request["cost"].asInt();
+    Json::Value reply;
+    reply["returnValue"] = request["cost"].asInt() < 3000;
+    return reply;
+  };
+  Json::Value request;
+  for (int cost : {1000, 2000, 4000}) {
+    request["cost"] = cost;
+    bus_.Dispatch("launchApp", handler, request);
+  }
+  request["cost"] = 100;
+  bus_.Dispatch("killApp", handler, request);
+
+  const ServiceMetrics::Stats* launch =
+      metrics_.Find(ServiceMetrics::Direction::kInbound, "launchApp");
+  ASSERT_TRUE(launch);
+  EXPECT_EQ(launch->calls, 3u);
+  EXPECT_EQ(launch->errors, 1u);
+  EXPECT_EQ(launch->in_flight, 0u);
+  EXPECT_EQ(launch->max_in_flight, 1u);
+  EXPECT_EQ(launch->latency.Count(), 3u);
+  EXPECT_EQ(launch->latency.Min(), 1000);
+  EXPECT_EQ(launch->latency.Max(), 4000);
+  EXPECT_EQ(metrics_.Find(ServiceMetrics::Direction::kInbound, "killApp")
+                ->latency.Max(),
+            100);
+  EXPECT_FALSE(metrics_.Find(ServiceMetrics::Direction::kOutbound,
+                             "launchApp"));
+}
+
+TEST_F(ServiceMetricsTest, CalloutsInFlightAndTimeouts) {
+  metrics_.SetTimeout(500 * 1000);
+  const uint64_t first = bus_.Call(&wam_handle_, kSettings);
+  const uint64_t second = bus_.Call(&wam_handle_, kSettings);
+  // Same token on another handle is another call.
+  const uint64_t other = bus_.Call(&plugin_handle_, kSettings);
+  ASSERT_EQ(first, other);
+  const uint64_t memory = bus_.Call(&wam_handle_, kMemoryManager);
+
+  const ServiceMetrics::Stats* settings =
+      metrics_.Find(ServiceMetrics::Direction::kOutbound, kSettings);
+  ASSERT_TRUE(settings);
+  EXPECT_EQ(settings->in_flight, 3u);
+  EXPECT_EQ(settings->max_in_flight, 3u);
+
+  fake_now_us += 20 * 1000;
+  bus_.Reply(&wam_handle_, first, R"({"returnValue": true})");
+  bus_.Reply(&plugin_handle_, other, R"({"returnValue": false})");
+  // A subscription's following replies are not timed.
+  bus_.Reply(&wam_handle_, first, R"({"returnValue": false})");
+  EXPECT_EQ(settings->in_flight, 1u);
+  EXPECT_EQ(settings->errors, 1u);
+  EXPECT_EQ(settings->latency.Count(), 2u);
+  EXPECT_EQ(settings->latency.Max(), 20 * 1000);
+
+  fake_now_us += 600 * 1000;
+  EXPECT_EQ(metrics_.Overdue(kSettings), 1u);
+  EXPECT_EQ(metrics_.Overdue(kMemoryManager), 1u);
+  bus_.Reply(&wam_handle_, second, "not json");
+  EXPECT_EQ(settings->timeouts, 1u);
+  EXPECT_EQ(settings->errors, 2u);
+  EXPECT_EQ(metrics_.Overdue(kSettings), 0u);
+
+  metrics_.CancelCallout(&wam_handle_, memory);
+  const ServiceMetrics::Stats* memory_stats =
+      metrics_.Find(ServiceMetrics::Direction::kOutbound, kMemoryManager);
+  EXPECT_EQ(memory_stats->in_flight, 0u);
+  EXPECT_EQ(memory_stats->latency.Count(), 0u);
+  EXPECT_EQ(metrics_.Overdue(kMemoryManager), 0u);
+}
+
+TEST_F(ServiceMetricsTest, ResetKeepsCallsInFlight) {
+  const uint64_t pending = bus_.Call(&wam_handle_, kSettings);
+  bus_.Reply(&wam_handle_, bus_.Call(&wam_handle_, kSettings), "{}");
+
+  metrics_.Reset();
+  const ServiceMetrics::Stats* settings =
+      metrics_.Find(ServiceMetrics::Direction::kOutbound, kSettings);
+  EXPECT_EQ(settings->calls, 0u);
+  EXPECT_EQ(settings->latency.Count(), 0u);
+  EXPECT_EQ(settings->in_flight, 1u);
+
+  fake_now_us += 300;
+  bus_.Reply(&wam_handle_, pending, "{}");
+  EXPECT_EQ(settings->in_flight, 0u);
+  EXPECT_EQ(settings->latency.Count(), 1u);
+  EXPECT_EQ(settings->latency.Max(), 300);
+}
+
+TEST_F(ServiceMetricsTest, Json) {
+  metrics_.SetTimeout(1000);
+  bus_.Dispatch(
+      "getWebProcessSize",
+      [](const Json::Value&) {
+        fake_now_us += 250;
+        return Json::Value(Json::objectValue);
+      },
+      Json::Value(Json::objectValue));
+  bus_.Call(&wam_handle_, kSettings);
+  fake_now_us += 2000;
+
+  Json::Value json = metrics_.ToJson();
+  EXPECT_EQ(json["timeoutMs"].asInt(), 1);
+  const Json::Value& method = json["methods"]["getWebProcessSize"];
+  EXPECT_EQ(method["calls"].asUInt(), 1u);
+  EXPECT_EQ(method["latency"]["maxUs"].asInt(), 250);
+  EXPECT_EQ(method["latency"]["p99Us"].asInt(), 250);
+  EXPECT_FALSE(method.isMember("timeouts"));
+  const Json::Value& callout = json["callouts"][kSettings];
+  EXPECT_EQ(callout["inFlight"].asUInt(), 1u);
+  EXPECT_EQ(callout["overdue"].asUInt(), 1u);
+  EXPECT_EQ(callout["timeouts"].asUInt(), 0u);
+}
+
+TEST(GetServiceMetrics, Reply) {
+  auto* service = WebAppManagerServiceLuna::Instance();
+  Json::Value request(Json::objectValue);
+  request["reset"] = true;
+  Json::Value reply = service->getServiceMetrics(request);
+  ASSERT_TRUE(reply["returnValue"].asBool());
+  EXPECT_TRUE(reply["methods"].isObject());
+  EXPECT_TRUE(reply["callouts"].isObject());
+
+  request["reset"] = "yes";
+  reply = service->getServiceMetrics(request);
+  EXPECT_FALSE(reply["returnValue"].asBool());
+  EXPECT_EQ(reply["errorCode"].asInt(), kErrCodeInvalidParam);
+}
@@ -0,0 +1,166 @@
+// Copyright (c) 2021 LG Electronics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#include <string>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include <json/json.h>
+
+#include "base_mock_initializer.h"
+#include "utils.h"
+#include "web_app_base.h"
+#include "web_app_manager.h"
+#include "web_app_manager_service_luna.h"
+#include "web_page_base.h"
+
+namespace {
+
+using ::testing::_;
+using ::testing::AnyNumber;
+using ::testing::HasSubstr;
+
+constexpr char kInstanceId[] = "5e1f3c2a-8f0d-4a3b-9d6e-7c2b1a0f4e5d";
+constexpr char kLaunchAppJsonBody[] = R"({
+  "appDesc": {
+    "defaultWindowType": "card",
+    "id": "bareapp",
+    "trustLevel": "default",
+    "title": "Bare App",
+    "folderPath": "/usr/palm/applications/bareapp",
+    "main": "index.html",
+    "type": "web",
+    "accessibility": {
+      "supportsAudioGuidance": true
+    }
+  },
+  "appId": "bareapp",
+  "parameters": {
+    "displayAffinity": 0
+  },
+  "instanceId": "5e1f3c2a-8f0d-4a3b-9d6e-7c2b1a0f4e5d"
+})";
+
+class SettingsPropagationTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    Json::Value request;
+    ASSERT_TRUE(util::StringToJson(kLaunchAppJsonBody, request));
+    const auto reply = WebAppManagerServiceLuna::Instance()->launchApp(request);
+    ASSERT_TRUE(reply["returnValue"].asBool());
+
+    app_ = WebAppManager::Instance()->FindAppByInstanceId(kInstanceId);
+    ASSERT_NE(app_, nullptr);
+    ASSERT_NE(app_->Page(), nullptr);
+
+    WebAppManager::Instance()->GetSystemLanguage(language_);
+  }
+
+  void TearDown() override {
+    ::testing::Mock::VerifyAndClearExpectations(
+        mock_initializer_.GetWebViewMock());
+    WebAppManager::Instance()->SetAccessibilityEnabled(false);
+    if (!language_.empty()) {
+      WebAppManager::Instance()->SetSystemLanguage(language_);
+    }
+  }
+
+  BaseMockInitializer<> mock_initializer_;
+  WebAppBase* app_ = nullptr;
+  std::string language_;
+};
+
+}  // namespace
+
+TEST_F(SettingsPropagationTest, VisiblePageIsUpdatedImmediately) {
+  NiceWebViewMock* web_view = mock_initializer_.GetWebViewMock();
+  EXPECT_CALL(*web_view, SetAcceptLanguages("de-DE")).Times(1);
+  EXPECT_CALL(*web_view, RunJavaScript(_)).Times(AnyNumber());
+  EXPECT_CALL(*web_view, RunJavaScript(HasSubstr("webOSLocaleChange")))
+      .Times(1);
+
+  WebAppManager::Instance()->SetSystemLanguage("de-DE");
+
+  EXPECT_EQ(app_->Page()->SettingsGeneration(),
+            WebAppManager::Instance()->SettingsGeneration());
+}
+
+TEST_F(SettingsPropagationTest, NoWebViewCallsToSuspendedPage) {
+  app_->SuspendAppRendering();
+  ASSERT_TRUE(app_->Page()->IsSuspended());
+
+  NiceWebViewMock* web_view = mock_initializer_.GetWebViewMock();
+  EXPECT_CALL(*web_view, SetAcceptLanguages(_)).Times(0);
+  EXPECT_CALL(*web_view, UpdatePreferences()).Times(0);
+  EXPECT_CALL(*web_view, RunJavaScript(_)).Times(0);
+  EXPECT_CALL(*web_view, RunJavaScriptInAllFrames(_)).Times(0);
+  EXPECT_CALL(*web_view, SetUseAccessibility(_)).Times(0);
+  EXPECT_CALL(*web_view, SetAudioGuidanceOn(_)).Times(0);
+
+  WebAppManager::Instance()->SetSystemLanguage("ko-KR");
+  WebAppManager::Instance()->SetSystemLanguage("fr-FR");
+  WebAppManager::Instance()->SetAccessibilityEnabled(true);
+
+  EXPECT_LT(app_->Page()->SettingsGeneration(),
+            WebAppManager::Instance()->SettingsGeneration());
+  ::testing::Mock::VerifyAndClearExpectations(web_view);
+
+  // Only the latest values are applied, once.
+  EXPECT_CALL(*web_view, SetAcceptLanguages(_)).Times(0);
+  EXPECT_CALL(*web_view, SetAcceptLanguages("fr-FR")).Times(1);
+  EXPECT_CALL(*web_view, RunJavaScript(_)).Times(AnyNumber());
+  EXPECT_CALL(*web_view, RunJavaScript(HasSubstr("webOSLocaleChange")))
+      .Times(1);
+  EXPECT_CALL(*web_view, SetAudioGuidanceOn(true)).Times(1);
+  EXPECT_CALL(*web_view, SetUseAccessibility(true)).Times(1);
+
+  app_->ResumeAppRendering();
+
+  EXPECT_FALSE(app_->Page()->IsSuspended());
+  EXPECT_EQ(app_->Page()->SettingsGeneration(),
+            WebAppManager::Instance()->SettingsGeneration());
+}
+
+TEST_F(SettingsPropagationTest, NoWebViewCallsToHiddenPage) {
+  app_->SetHiddenWindow(true);
+  ASSERT_FALSE(app_->Page()->IsSuspended());
+
+  NiceWebViewMock* web_view = mock_initializer_.GetWebViewMock();
+  EXPECT_CALL(*web_view, SetAcceptLanguages(_)).Times(0);
+  EXPECT_CALL(*web_view, UpdatePreferences()).Times(0);
+  EXPECT_CALL(*web_view, RunJavaScript(_)).Times(0);
+  EXPECT_CALL(*web_view, RunJavaScriptInAllFrames(_)).Times(0);
+
+  WebAppManager::Instance()->SetSystemLanguage("ko-KR");
+  WebAppManager::Instance()->SetSystemLanguage("fr-FR");
+
+  EXPECT_LT(app_->Page()->SettingsGeneration(),
+            WebAppManager::Instance()->SettingsGeneration());
+  ::testing::Mock::VerifyAndClearExpectations(web_view);
+
+  // Showing the window applies the latest language once.
+  EXPECT_CALL(*web_view, SetAcceptLanguages(_)).Times(0);
+  EXPECT_CALL(*web_view, SetAcceptLanguages("fr-FR")).Times(1);
+  EXPECT_CALL(*web_view, RunJavaScript(_)).Times(AnyNumber());
+  EXPECT_CALL(*web_view, RunJavaScript(HasSubstr("webOSLocaleChange")))
+      .Times(1);
+
+  app_->SetHiddenWindow(false);
+  app_->ResumeAppRendering();
+
+  EXPECT_EQ(app_->Page()->SettingsGeneration(),
+            WebAppManager::Instance()->SettingsGeneration());
+}
@@ -0,0 +1,191 @@
+// Copyright (c) 2021 LG Electronics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <glib.h>
+#include <gtest/gtest.h>
+#include <json/json.h>
+
+#include "platform_module_factory_impl.h"
+#include "startup_profiler.h"
+#include "web_app_manager.h"
+
+namespace {
+
+int64_t fake_now_us = 0;
+
+int64_t FakeClock() {
+  return fake_now_us;
+}
+
+class StartupProfilerTest : public ::testing::Test {
+ protected:
+  void SetUp() override { context_ = g_main_context_new(); }
+  void TearDown() override { g_main_context_unref(context_); }
+
+  // Returns false once nothing was dispatched.
+  bool RunOnce() { return g_main_context_iteration(context_, FALSE); }
+
+  GMainContext* context_ = nullptr;
+};
+
+std::vector<std::string> PhaseNames(const StartupProfiler& profiler) {
+  std::vector<std::string> names;
+  for (const StartupProfiler::Phase& phase : profiler.Phases()) {
+    names.push_back(phase.name);
+  }
+  return names;
+}
+
+}  // namespace
+
+TEST_F(StartupProfilerTest, NestedPhases) {
+  StartupProfiler profiler(context_);
+  profiler.SetClockForTesting(&FakeClock);
+  fake_now_us = 1000;
+  EXPECT_EQ(profiler.Begin("BeforeStart"), StartupProfiler::kInvalidPhase);
+
+  profiler.Start();
+  StartupProfiler::PhaseId outer = profiler.Begin("Outer");
+  fake_now_us += 10;
+  StartupProfiler::PhaseId inner = profiler.Begin("Inner");
+  fake_now_us += 20;
+  profiler.End(inner);
+  profiler.End(inner);
+  fake_now_us += 5;
+  profiler.End(outer);
+  profiler.CriticalPathDone();
+
+  ASSERT_EQ(profiler.Phases().size(), 2u);
+  const StartupProfiler::Phase& first = profiler.Phases()[0];
+  EXPECT_EQ(first.name, "Outer");
+  EXPECT_EQ(first.start_us, 0);
+  EXPECT_EQ(first.duration_us, 35);
+  EXPECT_EQ(first.depth, 0);
+  const StartupProfiler::Phase& second = profiler.Phases()[1];
+  EXPECT_EQ(second.name, "Inner");
+  EXPECT_EQ(second.start_us, 10);
+  EXPECT_EQ(second.duration_us, 20);
+  EXPECT_EQ(second.depth, 1);
+  EXPECT_FALSE(second.idle);
+
+  // Nothing was posted, so the startup is over.
+  EXPECT_TRUE(profiler.IsComplete());
+  EXPECT_EQ(profiler.CriticalPathUs(), 35);
+  EXPECT_EQ(profiler.Begin("Later"), StartupProfiler::kInvalidPhase);
+
+  Json::Value json = profiler.ToJson();
+  EXPECT_TRUE(json["complete"].asBool());
+  EXPECT_EQ(json["criticalPathUs"].asInt64(), 35);
+  ASSERT_EQ(json["phases"].size(), 2u);
+  EXPECT_EQ(json["phases"][1]["name"].asString(), "Inner");
+  EXPECT_EQ(json["phases"][1]["stage"].asString(), "critical");
+  EXPECT_EQ(json["phases"][1]["durationUs"].asInt64(), 20);
+}
+
+TEST_F(StartupProfilerTest, IdlePhasesRunOneAtATime) {
+  StartupProfiler profiler(context_);
+  profiler.Start();
+
+  std::vector<std::string> ran;
+  auto cancelled = std::make_unique<StartupProfiler::IdleTasks>();
+  StartupProfiler::IdleTasks tasks;
+  profiler.PostIdlePhase("First", [&] { ran.push_back("First"); }, &tasks);
+  profiler.PostIdlePhase(
+      "Cancelled", [&] { ran.push_back("Cancelled"); }, cancelled.get());
+  profiler.PostIdlePhase("Second", [&] {
+    ran.push_back("Second");
+    profiler.PostIdlePhase("Third", [&] { ran.push_back("Third"); });
+  });
+  cancelled.reset();
+
+  // Idle phases don't run before the critical path returns to the loop.
+  EXPECT_TRUE(ran.empty());
+  profiler.CriticalPathDone();
+  EXPECT_FALSE(profiler.IsComplete());
+
+  ASSERT_TRUE(RunOnce());
+  EXPECT_EQ(ran, std::vector<std::string>({"First"}));
+  ASSERT_TRUE(RunOnce());
+  ASSERT_TRUE(RunOnce());
+  EXPECT_EQ(ran, std::vector<std::string>({"First", "Second"}));
+  EXPECT_FALSE(profiler.IsComplete());
+  ASSERT_TRUE(RunOnce());
+  EXPECT_EQ(ran, std::vector<std::string>({"First", "Second", "Third"}));
+  EXPECT_TRUE(profiler.IsComplete());
+  EXPECT_FALSE(RunOnce());
+
+  EXPECT_EQ(PhaseNames(profiler),
+            std::vector<std::string>({"First", "Second", "Third"}));
+  for (const StartupProfiler::Phase& phase : profiler.Phases()) {
+    EXPECT_TRUE(phase.idle);
+    EXPECT_GE(phase.duration_us, 0);
+  }
+}
+
+TEST_F(StartupProfilerTest, DestroyedWithPendingPhases) {
+  bool ran = false;
+  {
+    StartupProfiler profiler(context_);
+    profiler.PostIdlePhase("Pending", [&] { ran = true; });
+  }
+  EXPECT_FALSE(RunOnce());
+  EXPECT_FALSE(ran);
+}
+
+// Follows StartWebAppManager() of wam_main.cc.
+TEST(StartupProfilerPhaseOrderTest, PhaseOrder) {
+  StartupProfiler* profiler = StartupProfiler::Instance();
+  profiler->Start();
+  {
+    StartupProfiler::Scope scope("StartWebAppManager");
+    WebAppManager::Instance()->SetPlatformModules(
+        std::make_unique<PlatformModuleFactoryImpl>());
+    profiler->PostIdlePhase("PreloadPlugins", [] {});
+  }
+  profiler->CriticalPathDone();
+  EXPECT_FALSE(profiler->IsComplete());
+
+  while (!profiler->IsComplete() && g_main_context_iteration(nullptr, FALSE)) {
+  }
+  ASSERT_TRUE(profiler->IsComplete());
+
+  EXPECT_EQ(PhaseNames(*profiler),
+            std::vector<std::string>({
+                "StartWebAppManager",
+                "SetPlatformModules",
+                "WebAppManagerConfig::InitConfiguration",
+                "PostInitConfiguration",
+                "DeviceInfoImpl::Initialize",
+                "PreloadPlugins",
+            }));
+
+  const std::vector<StartupProfiler::Phase>& phases = profiler->Phases();
+  EXPECT_EQ(phases[0].depth, 0);
+  EXPECT_EQ(phases[1].depth, 1);
+  EXPECT_EQ(phases[2].depth, 2);
+  EXPECT_EQ(phases[3].depth, 2);
+  // Only the critical path runs before the first launch can be accepted.
+  for (size_t i = 0; i < phases.size(); ++i) {
+    EXPECT_EQ(phases[i].idle, i >= 4) << phases[i].name;
+  }
+  EXPECT_LE(phases[0].duration_us, profiler->CriticalPathUs());
+  EXPECT_GE(phases[4].start_us, profiler->CriticalPathUs());
+}
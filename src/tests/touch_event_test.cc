@@ -15,6 +15,7 @@
 // SPDX-License-Identifier: Apache-2.0
 
 #include <string>
+#include <vector>
 
 #include <gmock/gmock.h>
 #include <gtest/gtest.h>
@@ -26,11 +27,13 @@
 #include "web_app_manager.h"
 #include "web_app_manager_service_luna.h"
 #include "web_app_wayland.h"
+#include "web_app_wayland_window.h"
 #include "web_app_window_factory_mock.h"
 #include "web_app_window_mock.h"
 #include "web_page_blink_delegate.h"
 #include "web_view_factory_mock.h"
 #include "web_view_mock.h"
+#include "webos/common/webos_event.h"
 #include "webos/window_group_configuration.h"
 
 namespace {
@@ -95,6 +98,13 @@ static constexpr char launchBareAppJsonBody[] = R"({
   "instanceId": "188f99b7-1e1a-489f-8e3d-56844a7713030"
 })";
 
+// The cursor is enabled by an environment variable by default, without it
+// the window drops all pointer events.
+class CursorEnabledWindow : public WebAppWaylandWindow {
+ public:
+  CursorEnabledWindow() { SetCursorEnabled(true); }
+};
+
 }  // namespace
 
 class TouchEventTestSuite : public ::testing::Test {
@@ -186,3 +196,118 @@ TEST_F(TouchEventTestSuite, LeaveEventTest) {
 
   web_app_->SendWebOSMouseEvent("Leave");
 }
+
+TEST_F(TouchEventTestSuite, coalesceMouseMovesPerFrame) {
+  constexpr int kFrames = 10;
+  // A 1 kHz mouse on a 60 Hz display.
+  constexpr int kMovesPerFrame = 16;
+  CursorEnabledWindow window;
+  window.SetWebApp(web_app_);
+
+  std::vector<float> forwarded;
+  EXPECT_CALL(*web_view_, ForwardWebOSEvent(_))
+      .WillRepeatedly([&](WebOSEvent* event) {
+        ASSERT_EQ(event->GetType(), WebOSEvent::MouseMove);
+        forwarded.push_back(static_cast<WebOSMouseEvent*>(event)->GetX());
+      });
+
+  int passed_to_engine = 0;
+  for (int frame = 0; frame < kFrames; ++frame) {
+    for (int i = 0; i < kMovesPerFrame; ++i) {
+      WebOSMouseEvent move(WebOSEvent::MouseMove, frame * kMovesPerFrame + i,
+                           100);
+      if (!window.HandleWebOSEvent(&move)) {
+        ++passed_to_engine;
+      }
+    }
+    WebOSEvent swap(WebOSEvent::Swap);
+    window.HandleWebOSEvent(&swap);
+  }
+
+  // Only the very first move goes to the engine directly, every frame swap
+  // then forwards the last position of its frame.
+  EXPECT_EQ(passed_to_engine, 1);
+  ASSERT_EQ(forwarded.size(), static_cast<size_t>(kFrames));
+  for (int frame = 0; frame < kFrames; ++frame) {
+    EXPECT_EQ(forwarded[frame], (frame + 1) * kMovesPerFrame - 1);
+  }
+
+  const auto& stats = window.GetPointerMoveStats();
+  EXPECT_EQ(stats.moves, static_cast<uint64_t>(kFrames * kMovesPerFrame));
+  EXPECT_EQ(stats.forwarded, static_cast<uint64_t>(kFrames + 1));
+  EXPECT_EQ(stats.coalesced, stats.moves - 1);
+  window.SetWebApp(nullptr);
+}
+
+TEST_F(TouchEventTestSuite, clickFlushesPendingMove) {
+  CursorEnabledWindow window;
+  window.SetWebApp(web_app_);
+
+  std::vector<float> forwarded;
+  EXPECT_CALL(*web_view_, ForwardWebOSEvent(_))
+      .WillRepeatedly([&](WebOSEvent* event) {
+        forwarded.push_back(static_cast<WebOSMouseEvent*>(event)->GetX());
+      });
+
+  WebOSMouseEvent first(WebOSEvent::MouseMove, 10, 10);
+  WebOSMouseEvent second(WebOSEvent::MouseMove, 20, 10);
+  WebOSMouseEvent third(WebOSEvent::MouseMove, 30, 10);
+  EXPECT_FALSE(window.HandleWebOSEvent(&first));
+  EXPECT_TRUE(window.HandleWebOSEvent(&second));
+  EXPECT_TRUE(window.HandleWebOSEvent(&third));
+  EXPECT_TRUE(forwarded.empty());
+
+  // The merged move reaches the engine before the click does.
+  WebOSMouseEvent press(WebOSEvent::MouseButtonPress, 30, 10);
+  window.HandleWebOSEvent(&press);
+  ASSERT_EQ(forwarded.size(), 1u);
+  EXPECT_EQ(forwarded[0], 30);
+
+  // Nothing is left for the frame swap.
+  WebOSEvent swap(WebOSEvent::Swap);
+  window.HandleWebOSEvent(&swap);
+  EXPECT_EQ(forwarded.size(), 1u);
+  window.SetWebApp(nullptr);
+}
+
+TEST_F(TouchEventTestSuite, inputLatencyUntilPageSwap) {
+  auto* service = WebAppManagerServiceLuna::Instance();
+  Json::Value request;
+  request["enable"] = true;
+  request["reset"] = true;
+  ASSERT_TRUE(service->getInputLatency(request)["returnValue"].asBool());
+
+  CursorEnabledWindow window;
+  window.SetWebApp(web_app_);
+  WebOSKeyEvent key(WebOSEvent::KeyPress, 13);
+  WebOSMouseEvent first(WebOSEvent::MouseMove, 10, 10);
+  WebOSMouseEvent second(WebOSEvent::MouseMove, 20, 10);
+  window.HandleWebOSEvent(&key);
+  window.HandleWebOSEvent(&first);
+  window.HandleWebOSEvent(&second);
+  // Resolved by the swap of the page, not the one of the window.
+  web_app_->DidSwapPageCompositorFrame();
+
+  Json::Value query;
+  query["appId"] = "bareapp";
+  query["reset"] = true;
+  Json::Value reply = service->getInputLatency(query);
+  ASSERT_TRUE(reply["returnValue"].asBool());
+  ASSERT_EQ(reply["apps"].size(), 1u);
+  const Json::Value& events = reply["apps"][0]["events"];
+  EXPECT_EQ(events["key"]["count"].asUInt64(), 1u);
+  // Merged moves are measured as well.
+  EXPECT_EQ(events["mouseMove"]["count"].asUInt64(), 2u);
+  EXPECT_FALSE(events.isMember("wheel"));
+
+  Json::Value invalid;
+  invalid["sampleInterval"] = 0;
+  EXPECT_FALSE(service->getInputLatency(invalid)["returnValue"].asBool());
+
+  request.clear();
+  request["enable"] = false;
+  reply = service->getInputLatency(request);
+  EXPECT_FALSE(reply["enabled"].asBool());
+  EXPECT_EQ(reply["apps"].size(), 0u);
+  window.SetWebApp(nullptr);
+}
@@ -0,0 +1,207 @@
+// Copyright (c) 2021 LG Electronics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+
+#include <stdlib.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <cstdio>
+#include <fstream>
+#include <set>
+#include <sstream>
+#include <string>
+#include <thread>
+
+#include <gtest/gtest.h>
+#include <json/json.h>
+
+#include "allocation_counter.h"
+#include "base_mock_initializer.h"
+#include "platform_module_factory_impl_mock.h"
+#include "trace_recorder.h"
+#include "utils.h"
+#include "web_app_manager_service_luna.h"
+#include "web_app_manager_tracer.h"
+
+namespace {
+
+class TraceRecorderTest : public ::testing::Test {
+ protected:
+  void SetUp() override { TraceRecorder::Clear(); }
+  void TearDown() override {
+    TraceRecorder::SetEnabled(false);
+    TraceRecorder::Clear();
+  }
+
+  Json::Value Dump() {
+    std::stringstream out;
+    TraceRecorder::WriteJson(out);
+    Json::Value json;
+    EXPECT_TRUE(util::StringToJson(out.str(), json)) << out.str();
+    return json;
+  }
+};
+
+void TracedFunction() {
+  PMTRACE_FUNCTION;
+  PMTRACE_SCOPE("scope");
+  PMTRACE("instant");
+}
+
+}  // namespace
+
+TEST_F(TraceRecorderTest, DisabledRecordsNothing) {
+  TracedFunction();
+  PMTRACE_COUNTER("counter", 1);
+  EXPECT_EQ(Dump()["traceEvents"].size(), 0u);
+}
+
+TEST_F(TraceRecorderTest, NoAllocationsWhileTracing) {
+  TraceRecorder::SetEnabled(true);
+  AllocationCounter counter;
+  for (size_t i = 0; i < TraceRecorder::kEventsPerThread; ++i) {
+    TracedFunction();
+    PMTRACE_BEFORE("before");
+    PMTRACE_AFTER("before");
+    PMTRACE_COUNTER("counter", static_cast<int64_t>(i));
+  }
+  EXPECT_EQ(counter.Count(), 0u);
+}
+
+TEST_F(TraceRecorderTest, ChromeTraceEventJson) {
+  TraceRecorder::SetEnabled(true);
+  TracedFunction();
+  PMTRACE_COUNTER("pages", 3);
+  TraceRecorder::SetEnabled(false);
+
+  Json::Value json = Dump();
+  const Json::Value& events = json["traceEvents"];
+  ASSERT_EQ(events.size(), 6u);
+  EXPECT_EQ(events[0]["name"].asString(), "TracedFunction");
+  EXPECT_EQ(events[0]["ph"].asString(), "B");
+  EXPECT_EQ(events[0]["cat"].asString(), __FILE__);
+  EXPECT_EQ(events[1]["name"].asString(), "scope");
+  EXPECT_EQ(events[2]["name"].asString(), "instant");
+  EXPECT_EQ(events[2]["ph"].asString(), "i");
+  EXPECT_EQ(events[3]["ph"].asString(), "E");
+  EXPECT_EQ(events[4]["name"].asString(), "TracedFunction");
+  EXPECT_EQ(events[4]["ph"].asString(), "E");
+  EXPECT_EQ(events[5]["ph"].asString(), "C");
+  EXPECT_EQ(events[5]["args"]["value"].asInt64(), 3);
+  EXPECT_EQ(events[0]["pid"].asInt(), getpid());
+  for (Json::ArrayIndex i = 1; i < events.size(); ++i) {
+    EXPECT_GE(events[i]["ts"].asInt64(), events[i - 1]["ts"].asInt64());
+  }
+}
+
+TEST_F(TraceRecorderTest, KeepsLatestEventsPerThread) {
+  TraceRecorder::SetEnabled(true);
+  for (size_t i = 0; i < TraceRecorder::kEventsPerThread + 10; ++i) {
+    PMTRACE_COUNTER("counter", static_cast<int64_t>(i));
+  }
+  std::thread([] { PMTRACE("other thread"); }).join();
+
+  Json::Value json = Dump();
+  const Json::Value& events = json["traceEvents"];
+  ASSERT_EQ(events.size(), TraceRecorder::kEventsPerThread + 1);
+  std::set<int> tids;
+  int64_t first_counter = -1;
+  for (const Json::Value& event : events) {
+    tids.insert(event["tid"].asInt());
+    if (first_counter < 0 && event["ph"] == "C") {
+      first_counter = event["args"]["value"].asInt64();
+    }
+  }
+  EXPECT_EQ(tids.size(), 2u);
+  EXPECT_EQ(first_counter, 10);
+}
+
+TEST_F(TraceRecorderTest, DumpWhileRecording) {
+  std::atomic<bool> stop{false};
+  std::atomic<int64_t> recorded{0};
+  TraceRecorder::SetEnabled(true);
+  std::thread writer([&] {
+    for (int64_t i = 0; !stop.load(std::memory_order_relaxed); ++i) {
+      TraceRecorder::Counter(i % 2 ? "odd" : "even", i);
+      recorded.store(i, std::memory_order_relaxed);
+      // Undoes the pause of WriteJson, so slots are overwritten while they
+      // are read.
+      if (!TraceRecorder::IsEnabled()) {
+        TraceRecorder::SetEnabled(true);
+      }
+    }
+  });
+
+  // The ring has wrapped, every dump reads slots that are being rewritten.
+  while (recorded.load(std::memory_order_relaxed) <
+         static_cast<int64_t>(TraceRecorder::kEventsPerThread)) {
+    std::this_thread::yield();
+  }
+  for (int dump = 0; dump < 20; ++dump) {
+    Json::Value json = Dump();
+    // An event is written out whole or not at all.
+    for (const Json::Value& event : json["traceEvents"]) {
+      const int64_t value = event["args"]["value"].asInt64();
+      EXPECT_EQ(event["name"].asString(), value % 2 ? "odd" : "even");
+    }
+  }
+  stop = true;
+  writer.join();
+}
+
+TEST_F(TraceRecorderTest, DumpTraceLunaMethod) {
+  char path[] = "/tmp/wam-trace-XXXXXX";
+  const int fd = mkstemp(path);
+  ASSERT_GE(fd, 0);
+  close(fd);
+  PlatformModuleFactoryImplMock::SetDefaultConfig({{"WAM_TRACE_PATH", path}});
+  BaseMockInitializer<NiceWebViewMock, NiceWebAppWindowMock,
+                      PlatformModuleFactoryImplMock>
+      mock_initializer;
+  PlatformModuleFactoryImplMock::SetDefaultConfig({});
+
+  auto* service = WebAppManagerServiceLuna::Instance();
+  Json::Value request;
+  request["enable"] = true;
+  Json::Value reply = service->dumpTrace(request);
+  ASSERT_TRUE(reply["returnValue"].asBool());
+  EXPECT_TRUE(reply["enabled"].asBool());
+  EXPECT_FALSE(reply.isMember("path"));
+
+  PMTRACE("luna");
+  reply = service->dumpTrace(Json::Value(Json::objectValue));
+  ASSERT_TRUE(reply["returnValue"].asBool());
+  EXPECT_EQ(reply["path"].asString(), path);
+  EXPECT_EQ(reply["events"].asUInt64(), 1u);
+  EXPECT_TRUE(reply["enabled"].asBool());
+
+  std::ifstream in(path);
+  std::stringstream content;
+  content << in.rdbuf();
+  Json::Value json;
+  ASSERT_TRUE(util::StringToJson(content.str(), json));
+  EXPECT_EQ(json["traceEvents"][0]["name"].asString(), "luna");
+  unlink(path);
+
+  // Callers cannot choose the file.
+  request.clear();
+  request["path"] = "/tmp/wam-trace-elsewhere.json";
+  reply = service->dumpTrace(request);
+  EXPECT_FALSE(reply["returnValue"].asBool());
+  EXPECT_EQ(reply["errorCode"].asInt(), kErrCodeInvalidParam);
+  EXPECT_NE(access("/tmp/wam-trace-elsewhere.json", F_OK), 0);
+}
@@ -115,6 +115,24 @@ TEST(UrlTest, SetQuery) {
       https_url.ToString());
 }
 
+TEST(UrlTest, SetQueryOnCopy) {
+  wam::Url https_url(kHttpsWithPortUri);
+  wam::Url copy = https_url;
+  copy.SetQuery({{"a", "1"}});
+  copy.SetQuery({{"b", "2"}});
+  EXPECT_EQ("?b=2", copy.Query());
+  EXPECT_EQ("google.com", copy.Host());
+  EXPECT_EQ("8080", copy.Port());
+  EXPECT_EQ("#somefragment", copy.Fragment());
+  EXPECT_EQ("https://google.com:8080/notexist/virtual/path?b=2#somefragment",
+            copy.ToString());
+
+  copy.SetQuery({});
+  EXPECT_EQ("", copy.Query());
+  EXPECT_EQ("?test=value", https_url.Query());
+  EXPECT_EQ(kHttpsWithPortUri, https_url.ToString());
+}
+
 TEST(UrlTest, Fragment) {
   wam::Url https_url(kHttpsWithQueryAndFragmentUri);
   EXPECT_EQ("#somefragment", https_url.Fragment());
@@ -32,6 +32,8 @@ const std::map<std::string, std::string> kEnvironmentVariables = {
     {"WEBAPPFACTORY_PLUGIN_PATH", "/usr/lib/webappmanager/alternate_plugins"},
     {"WAM_ERROR_PAGE", "https://www.lg.com/uk/support"},
     {"USER_SCRIPT_PATH", "webOSUserScripts/userScriptModified.js"},
+    {"WAM_TRACE_PATH", "/var/log/wam-trace.json"},
+    {"WAM_METRICS_EXPORT_PATH", "/run/wam/metrics.sock"},
     {"WAM_NAME", "Testing"}};
 
 }  // namespace
@@ -143,6 +145,24 @@ TEST_F(WebAppManagerConfigTest, checkUserScriptPathIfDefined) {
                config_with_set_variables_.GetUserScriptPath().c_str());
 }
 
+TEST_F(WebAppManagerConfigTest, checkTracePathIfNotDefined) {
+  EXPECT_EQ("/tmp/wam-trace.json", config_with_no_variables_.GetTracePath());
+}
+
+TEST_F(WebAppManagerConfigTest, checkTracePathIfDefined) {
+  EXPECT_EQ("/var/log/wam-trace.json",
+            config_with_set_variables_.GetTracePath());
+}
+
+TEST_F(WebAppManagerConfigTest, checkMetricsExportPathIfNotDefined) {
+  EXPECT_TRUE(config_with_no_variables_.GetMetricsExportPath().empty());
+}
+
+TEST_F(WebAppManagerConfigTest, checkMetricsExportPathIfDefined) {
+  EXPECT_EQ("/run/wam/metrics.sock",
+            config_with_set_variables_.GetMetricsExportPath());
+}
+
 TEST_F(WebAppManagerConfigTest, checkNameIfNotDefined) {
   EXPECT_STREQ("", config_with_no_variables_.GetName().c_str());
 }
@@ -14,7 +14,16 @@
 //
 // SPDX-License-Identifier: Apache-2.0
 
+#include <stdlib.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <chrono>
+#include <memory>
 #include <string>
+#include <thread>
+
+#include <glib.h>
 
 #include <gmock/gmock.h>
 #include <gtest/gtest.h>
@@ -33,6 +42,7 @@ namespace {
 
 using ::testing::_;
 using ::testing::HasSubstr;
+using ::testing::InvokeWithoutArgs;
 using ::testing::Return;
 
 const std::string kAppDescString = R"({
@@ -99,6 +109,40 @@ class WebViewFactoryMock : public WebViewFactory {
 
 WebViewFactoryMock::WebViewFactoryMock() : web_view_(new NiceWebViewMock()) {}
 
+class UserScriptPage : public WebPageBlink {
+ public:
+  using WebPageBlink::SetupStaticUserScripts;
+  using WebPageBlink::WebPageBlink;
+};
+
+// Reads |script_path_| as a static user script, and creates
+// |recreated_view_| when the view is recreated after a crash.
+class ScriptedPage : public WebPageBlink {
+ public:
+  using WebPageBlink::RecreateWebView;
+  using WebPageBlink::WebPageBlink;
+
+  std::string script_path_;
+  WebView* recreated_view_ = nullptr;
+
+ protected:
+  WebView* CreatePageView() override {
+    if (!created_) {
+      created_ = true;
+      return WebPageBlink::CreatePageView();
+    }
+    return recreated_view_;
+  }
+
+  void SetupStaticUserScripts() override {
+    WebPageBlink::SetupStaticUserScripts();
+    AddUserScriptUrl(wam::Url::FromLocalFile(script_path_));
+  }
+
+ private:
+  bool created_ = false;
+};
+
 }  // namespace
 
 class WebPageBlinkTestSuite : public ::testing::Test {
@@ -218,3 +262,114 @@ TEST_F(WebPageBlinkTestSuite, addUserScript) {
     ASSERT_FALSE(result);
   }
 }
+
+TEST_F(WebPageBlinkTestSuite, LoadDeferredAcrossCancelledUserScriptReads) {
+  // The user script reads only run asynchronously on the owner of the main
+  // context.
+  ASSERT_TRUE(g_main_context_acquire(nullptr));
+  bool loaded = false;
+  EXPECT_CALL(*factory->web_view_, LoadUrl(HasSubstr("index.html")))
+      .WillOnce(InvokeWithoutArgs([&loaded] { loaded = true; }));
+
+  UserScriptPage web_page(wam::Url(description->EntryPoint()), *description,
+                          params.c_str(), std::move(factory));
+  web_page.Init();
+  web_page.Load();
+  EXPECT_FALSE(loaded);
+  // Drops the read of the custom user script that Load() waits for.
+  web_page.SetupStaticUserScripts();
+
+  const auto deadline =
+      std::chrono::steady_clock::now() + std::chrono::seconds(5);
+  while (!loaded && std::chrono::steady_clock::now() < deadline) {
+    if (!g_main_context_iteration(nullptr, false)) {
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+  }
+  EXPECT_TRUE(loaded);
+  g_main_context_release(nullptr);
+}
+
+TEST_F(WebPageBlinkTestSuite, ReloadAfterCrashWaitsForUserScripts) {
+  char path[] = "/tmp/wam-user-script-XXXXXX";
+  const int fd = mkstemp(path);
+  ASSERT_GE(fd, 0);
+  constexpr char kScript[] = "window.crashTestScript = true;";
+  ASSERT_EQ(write(fd, kScript, sizeof(kScript) - 1),
+            static_cast<ssize_t>(sizeof(kScript) - 1));
+  close(fd);
+
+  ASSERT_TRUE(g_main_context_acquire(nullptr));
+  auto* recreated_view = new NiceWebViewMock();
+  bool loaded = false;
+  {
+    ::testing::InSequence sequence;
+    EXPECT_CALL(*recreated_view, AddUserScript(HasSubstr("crashTestScript")))
+        .Times(1);
+    EXPECT_CALL(*recreated_view, LoadUrl(HasSubstr("index.html")))
+        .WillOnce(InvokeWithoutArgs([&loaded] { loaded = true; }));
+  }
+
+  ScriptedPage web_page(wam::Url(description->EntryPoint()), *description,
+                        params.c_str(), std::move(factory));
+  web_page.script_path_ = path;
+  web_page.recreated_view_ = recreated_view;
+  web_page.Init();
+  // What RenderProcessCrashed() and WebAppManager::ProcessCrashed() do.
+  web_page.RecreateWebView();
+  web_page.ReloadDefaultPage();
+  EXPECT_FALSE(loaded);
+
+  const auto deadline =
+      std::chrono::steady_clock::now() + std::chrono::seconds(5);
+  while (!loaded && std::chrono::steady_clock::now() < deadline) {
+    if (!g_main_context_iteration(nullptr, false)) {
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+  }
+  EXPECT_TRUE(loaded);
+  g_main_context_release(nullptr);
+  unlink(path);
+}
+
+TEST_F(WebPageBlinkTestSuite, UserScriptFifoIsNotRead) {
+  char dir[] = "/tmp/wam-user-script-XXXXXX";
+  ASSERT_NE(mkdtemp(dir), nullptr);
+  const std::string fifo = std::string(dir) + "/fifo.js";
+  ASSERT_EQ(mkfifo(fifo.c_str(), 0600), 0);
+
+  ASSERT_TRUE(g_main_context_acquire(nullptr));
+  bool loaded = false;
+  EXPECT_CALL(*factory->web_view_, LoadUrl(HasSubstr("index.html")))
+      .WillOnce(InvokeWithoutArgs([&loaded] { loaded = true; }));
+
+  ScriptedPage web_page(wam::Url(description->EntryPoint()), *description,
+                        params.c_str(), std::move(factory));
+  web_page.script_path_ = fifo;
+  web_page.Init();
+  web_page.Load();
+
+  // Opening the FIFO would block the file I/O worker, and the load with it.
+  const auto deadline =
+      std::chrono::steady_clock::now() + std::chrono::seconds(5);
+  while (!loaded && std::chrono::steady_clock::now() < deadline) {
+    if (!g_main_context_iteration(nullptr, false)) {
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+  }
+  EXPECT_TRUE(loaded);
+  g_main_context_release(nullptr);
+  unlink(fifo.c_str());
+  rmdir(dir);
+}
+
+TEST_F(WebPageBlinkTestSuite, UpdatePreferencesOnceOnInit) {
+  EXPECT_CALL(*factory->web_view_, SetPreferences(_)).Times(1);
+  EXPECT_CALL(*factory->web_view_, SetLocalStorageEnabled(_)).Times(0);
+  EXPECT_CALL(*factory->web_view_, SetAllowFakeBoldText(_)).Times(0);
+  EXPECT_CALL(*factory->web_view_, UpdatePreferences()).Times(1);
+
+  WebPageBlink web_page(wam::Url(description->EntryPoint()), *description,
+                        params.c_str(), std::move(factory));
+  web_page.Init();
+}
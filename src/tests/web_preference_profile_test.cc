@@ -0,0 +1,97 @@
+// Copyright (c) 2021 LG Electronics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#include <gtest/gtest.h>
+
+#include "application_description.h"
+#include "web_preference_profile.h"
+
+namespace {
+
+using Preference = WebPreferenceProfile::Preference;
+
+WebPreferenceProfile::Key MakeKey(const std::string& trust_level,
+                                  bool disallow_scrolling = false) {
+  WebPreferenceProfile::Key key;
+  key.trust_level = trust_level;
+  key.disallow_scrolling = disallow_scrolling;
+  return key;
+}
+
+}  // namespace
+
+TEST(WebPreferenceProfileTest, SharedPerKey) {
+  auto first = WebPreferenceProfile::Get(MakeKey("default"));
+  auto second = WebPreferenceProfile::Get(MakeKey("default"));
+  auto trusted = WebPreferenceProfile::Get(MakeKey("trusted"));
+
+  EXPECT_EQ(first.get(), second.get());
+  EXPECT_NE(first.get(), trusted.get());
+}
+
+TEST(WebPreferenceProfileTest, ValuesFollowKey) {
+  auto profile = WebPreferenceProfile::Create(MakeKey("default", true));
+  EXPECT_TRUE(profile->Has(Preference::kLocalStorageEnabled));
+  EXPECT_TRUE(profile->Value(Preference::kLocalStorageEnabled));
+  EXPECT_TRUE(profile->Has(Preference::kAllowFakeBoldText));
+  EXPECT_FALSE(profile->Value(Preference::kAllowFakeBoldText));
+  EXPECT_TRUE(profile->Value(Preference::kDisallowScrollingInMainFrame));
+  EXPECT_FALSE(profile->Has(Preference::kAllowLocalResourceLoad));
+
+  auto trusted = WebPreferenceProfile::Create(MakeKey("trusted"));
+  EXPECT_TRUE(trusted->Has(Preference::kAllowLocalResourceLoad));
+  EXPECT_TRUE(trusted->Value(Preference::kAllowLocalResourceLoad));
+  EXPECT_EQ(trusted->Entries().size(), WebPreferenceProfile::kPreferenceCount);
+}
+
+TEST(WebPreferenceProfileTest, KeyFromDescription) {
+  auto desc = ApplicationDescription::FromJsonString(R"({
+    "id": "bareapp",
+    "trustLevel": "trusted",
+    "doNotTrack": true,
+    "disallowScrollingInMainFrame": true,
+    "thirdPartyCookiesPolicy": "deny"
+  })");
+  ASSERT_TRUE(desc);
+
+  WebPreferenceProfile::Key key = WebPreferenceProfile::KeyFor(*desc);
+  EXPECT_EQ(key.trust_level, "trusted");
+  EXPECT_TRUE(key.do_not_track);
+  EXPECT_TRUE(key.disallow_scrolling);
+  EXPECT_FALSE(key.allow_third_party_cookies);
+}
+
+TEST(WebPreferenceProfileTest, DiffOnlyChangedPreferences) {
+  auto base = WebPreferenceProfile::Create(MakeKey("default"));
+  auto scrolling = WebPreferenceProfile::Create(MakeKey("default", true));
+
+  EXPECT_EQ(base->Diff(nullptr).size(), base->Entries().size());
+  EXPECT_TRUE(base->Diff(base.get()).empty());
+
+  WebPreferenceProfile::Changes changes = scrolling->Diff(base.get());
+  ASSERT_EQ(changes.size(), 2u);
+  EXPECT_EQ(changes[0].preference, Preference::kDisallowScrollbarsInMainFrame);
+  EXPECT_TRUE(changes[0].value);
+  EXPECT_EQ(changes[1].preference, Preference::kDisallowScrollingInMainFrame);
+  EXPECT_TRUE(changes[1].value);
+
+  // The trusted profile only adds local resource loading on top.
+  auto trusted = WebPreferenceProfile::Create(MakeKey("trusted"));
+  changes = trusted->Diff(base.get());
+  ASSERT_EQ(changes.size(), 1u);
+  EXPECT_EQ(changes[0].preference, Preference::kAllowLocalResourceLoad);
+  EXPECT_TRUE(base->Diff(trusted.get()).empty());
+}
@@ -0,0 +1,159 @@
+// Copyright (c) 2021 LG Electronics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#include "atom.h"
+
+#include <deque>
+#include <utility>
+#include <vector>
+
+namespace {
+
+class AtomTable {
+ public:
+  static AtomTable* Instance() {
+    // not a leak -- atoms may be released from static destructors
+    static AtomTable* instance = new AtomTable();
+    return instance;
+  }
+
+  uint32_t Intern(std::string_view str) {
+    auto found = ids_.find(str);
+    if (found != ids_.end()) {
+      return found->second;
+    }
+
+    uint32_t id;
+    if (free_ids_.empty()) {
+      id = static_cast<uint32_t>(entries_.size());
+      entries_.emplace_back();
+    } else {
+      id = free_ids_.back();
+      free_ids_.pop_back();
+    }
+    // |entries_| is a deque, so the strings the keys of |ids_| view don't
+    // move when it grows.
+    entries_[id].str = str;
+    ids_.emplace(entries_[id].str, id);
+    return id;
+  }
+
+  std::optional<uint32_t> Find(std::string_view str) const {
+    auto found = ids_.find(str);
+    if (found == ids_.end()) {
+      return std::nullopt;
+    }
+    return found->second;
+  }
+
+  void Acquire(uint32_t id) { ++entries_[id].refs; }
+
+  void Release(uint32_t id) {
+    Entry& entry = entries_[id];
+    if (--entry.refs) {
+      return;
+    }
+    ids_.erase(entry.str);
+    entry.str = std::string();
+    free_ids_.push_back(id);
+  }
+
+  const std::string& String(uint32_t id) const { return entries_[id].str; }
+  size_t Size() const { return ids_.size(); }
+
+ private:
+  struct Entry {
+    std::string str;
+    uint32_t refs = 0;
+  };
+
+  // Id 0 stands for the empty string and is never interned.
+  AtomTable() : entries_(1) {}
+
+  std::deque<Entry> entries_;
+  std::vector<uint32_t> free_ids_;
+  std::unordered_map<std::string_view, uint32_t> ids_;
+};
+
+}  // namespace
+
+Atom::Atom(std::string_view str)
+    : id_(str.empty() ? 0 : AtomTable::Instance()->Intern(str)) {
+  Acquire();
+}
+
+Atom::Atom(const Atom& other) : id_(other.id_) {
+  Acquire();
+}
+
+Atom::Atom(Atom&& other) noexcept : id_(std::exchange(other.id_, 0)) {}
+
+Atom& Atom::operator=(const Atom& other) {
+  other.Acquire();
+  Release();
+  id_ = other.id_;
+  return *this;
+}
+
+Atom& Atom::operator=(Atom&& other) noexcept {
+  if (this != &other) {
+    Release();
+    id_ = std::exchange(other.id_, 0);
+  }
+  return *this;
+}
+
+Atom::~Atom() {
+  Release();
+}
+
+std::optional<Atom> Atom::Find(std::string_view str) {
+  if (str.empty()) {
+    return Atom();
+  }
+  std::optional<uint32_t> id = AtomTable::Instance()->Find(str);
+  if (!id) {
+    return std::nullopt;
+  }
+  return FromId(*id);
+}
+
+size_t Atom::TableSize() {
+  return AtomTable::Instance()->Size();
+}
+
+const std::string& Atom::String() const {
+  return AtomTable::Instance()->String(id_);
+}
+
+Atom Atom::FromId(uint32_t id) {
+  Atom atom;
+  atom.id_ = id;
+  atom.Acquire();
+  return atom;
+}
+
+void Atom::Acquire() const {
+  if (id_) {
+    AtomTable::Instance()->Acquire(id_);
+  }
+}
+
+void Atom::Release() const {
+  if (id_) {
+    AtomTable::Instance()->Release(id_);
+  }
+}
@@ -0,0 +1,71 @@
+// Copyright (c) 2021 LG Electronics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef UTIL_ATOM_H_
+#define UTIL_ATOM_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+// Process-wide interned string, such as an app or instance id. Equal
+// strings get the same 32-bit id, so atoms compare and hash in O(1). An
+// interned string is kept as long as an Atom refers to it; its id may be
+// given to another string afterwards. The default Atom is the empty string.
+// The table isn't synchronized, atoms are meant for the main thread.
+class Atom {
+ public:
+  struct Hash {
+    size_t operator()(const Atom& atom) const { return atom.Id(); }
+  };
+
+  Atom() = default;
+  explicit Atom(std::string_view str);
+  Atom(const Atom& other);
+  Atom(Atom&& other) noexcept;
+  Atom& operator=(const Atom& other);
+  Atom& operator=(Atom&& other) noexcept;
+  ~Atom();
+
+  // Returns the atom of |str| if it is interned, without interning it.
+  static std::optional<Atom> Find(std::string_view str);
+  // Number of interned strings, the empty one aside.
+  static size_t TableSize();
+
+  uint32_t Id() const { return id_; }
+  const std::string& String() const;
+  bool IsEmpty() const { return id_ == 0; }
+
+  bool operator==(const Atom& other) const { return id_ == other.id_; }
+
+ private:
+  static Atom FromId(uint32_t id);
+
+  void Acquire() const;
+  void Release() const;
+
+  uint32_t id_ = 0;
+};
+
+template <typename T>
+using AtomMap = std::unordered_map<Atom, T, Atom::Hash>;
+template <typename T>
+using AtomMultimap = std::unordered_multimap<Atom, T, Atom::Hash>;
+
+#endif  // UTIL_ATOM_H_
@@ -16,18 +16,64 @@
 
 #include "bcp47.h"
 
+#include <algorithm>
 #include <memory>
-#include <regex>
 #include <string>
 
+namespace {
+
+bool IsLower(char c) {
+  return c >= 'a' && c <= 'z';
+}
+
+bool IsUpper(char c) {
+  return c >= 'A' && c <= 'Z';
+}
+
+bool IsDigit(char c) {
+  return c >= '0' && c <= '9';
+}
+
+// Matches [A-z], which also takes the few punctuation characters between
+// the upper and lower case letters.
+bool IsScriptChar(char c) {
+  return c >= 'A' && c <= 'z';
+}
+
+template <typename Predicate>
+bool AllOf(std::string_view subtag, Predicate predicate) {
+  return std::all_of(subtag.cbegin(), subtag.cend(), predicate);
+}
+
+// Removes the subtag up to the next '-' from |tag| and returns it.
+std::string_view NextSubtag(std::string_view& tag) {
+  const size_t end = tag.find('-');
+  std::string_view subtag = tag.substr(0, end);
+  tag.remove_prefix(end == std::string_view::npos ? tag.size() : end + 1);
+  return subtag;
+}
+
+}  // namespace
+
 BCP47::BCP47() = default;
 BCP47::~BCP47() = default;
 
 std::unique_ptr<BCP47> BCP47::FromString(const std::string& bcp47_string) {
-  if (bcp47_string.empty()) {
+  Pieces pieces;
+  if (!Parse(bcp47_string, pieces)) {
     return nullptr;
   }
 
+  auto result = std::unique_ptr<BCP47>(new BCP47());
+
+  result->language_ = pieces.language;
+  result->script_ = pieces.script;
+  result->region_ = pieces.region;
+
+  return result;
+}
+
+bool BCP47::Parse(std::string_view bcp47_string, Pieces& pieces) {
   // We should parse language tag according to rfc5646
   // In general the tag format is: language - script - region
   // language - 2*3ALPHA - shortest ISO 639 code
@@ -36,25 +82,49 @@ std::unique_ptr<BCP47> BCP47::FromString(const std::string& bcp47_string) {
 
   // Actual values of all pocible pieces located at
   // https://www.iana.org/assignments/language-subtag-registry/language-subtag-registry
-  // But we will just use regex for parsing
-
-  // first group - mandatory 2 or 3 letters - represents language
-  // second group - optional 4 letters - represents script
-  // third group - optional 2 letters OR 3 digits - represents region
-  std::regex rfc5646_regex(
-      R"(^([a-z]{2,3})(?:[\-]{1}([A-z]{4}))?(?:[\-]{1}([A-Z]{2}|[0-9]{3}))?$)");
-  std::smatch match;
-  if (!std::regex_match(bcp47_string, match, rfc5646_regex)) {
-    return nullptr;
+  // The subtags are only checked for their form, the same as
+  // ^([a-z]{2,3})(?:-([A-z]{4}))?(?:-([A-Z]{2}|[0-9]{3}))?$ would.
+  pieces = Pieces();
+  if (bcp47_string.empty() || bcp47_string.back() == '-') {
+    return false;
   }
 
-  auto result = std::unique_ptr<BCP47>(new BCP47());
+  std::string_view tag = bcp47_string;
+  std::string_view language = NextSubtag(tag);
+  if (language.size() < 2 || language.size() > 3 ||
+      !AllOf(language, IsLower)) {
+    return false;
+  }
 
-  result->language_ = match[1];
-  result->script_ = match[2];
-  result->region_ = match[3];
+  std::string_view script;
+  std::string_view subtag = NextSubtag(tag);
+  if (subtag.size() == 4) {
+    if (!AllOf(subtag, IsScriptChar)) {
+      return false;
+    }
+    script = subtag;
+    subtag = NextSubtag(tag);
+  }
 
-  return result;
+  std::string_view region;
+  if (!subtag.empty()) {
+    if (!(subtag.size() == 2 && AllOf(subtag, IsUpper)) &&
+        !(subtag.size() == 3 && AllOf(subtag, IsDigit))) {
+      return false;
+    }
+    region = subtag;
+    subtag = NextSubtag(tag);
+  }
+
+  // Empty or extra subtags.
+  if (!subtag.empty() || !tag.empty()) {
+    return false;
+  }
+
+  pieces.language = language;
+  pieces.script = script;
+  pieces.region = region;
+  return true;
 }
 
 bool BCP47::HasLanguage() const {
@@ -19,10 +19,21 @@
 
 #include <memory>
 #include <string>
+#include <string_view>
 
 class BCP47 {
  public:
+  // Subtags of a language tag, pointing into the parsed string.
+  struct Pieces {
+    std::string_view language;
+    std::string_view script;
+    std::string_view region;
+  };
+
   static std::unique_ptr<BCP47> FromString(const std::string& bcp47_string);
+  // Same as FromString(), without allocating. Returns false if
+  // |bcp47_string| is not a valid tag.
+  static bool Parse(std::string_view bcp47_string, Pieces& pieces);
 
   bool HasLanguage() const;
   bool HasScript() const;
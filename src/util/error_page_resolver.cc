@@ -0,0 +1,102 @@
+// Copyright (c) 2021 LG Electronics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#include "error_page_resolver.h"
+
+#include <sys/stat.h>
+
+#include <algorithm>
+#include <filesystem>
+
+#include "utils.h"
+
+std::string ErrorPageResolver::Resolve(const std::string& error_page,
+                                      const std::string& language) {
+  Key key(error_page, language);
+  auto found = entries_.find(key);
+  if (found != entries_.end()) {
+    if (IsValid(found->second)) {
+      ++stats_.hits;
+      return found->second.path;
+    }
+    entries_.erase(found);
+  }
+
+  ++stats_.misses;
+  // Only a few error pages and languages are in use at a time, so there is
+  // no need for anything smarter than starting over.
+  if (entries_.size() >= kMaxEntries) {
+    entries_.clear();
+  }
+  auto inserted =
+      entries_.emplace(std::move(key), Lookup(error_page, language)).first;
+  stats_.entries = entries_.size();
+  return inserted->second.path;
+}
+
+void ErrorPageResolver::Clear() {
+  entries_.clear();
+  stats_.entries = 0;
+}
+
+ErrorPageResolver::DirStamp ErrorPageResolver::StampOf(const std::string& dir) {
+  DirStamp stamp;
+  stamp.path = dir;
+  struct stat st;
+  if (!stat(dir.c_str(), &st) && S_ISDIR(st.st_mode)) {
+    stamp.device = st.st_dev;
+    stamp.inode = st.st_ino;
+    stamp.mtime_ns = static_cast<int64_t>(st.st_mtim.tv_sec) * 1000000000 +
+                     st.st_mtim.tv_nsec;
+  }
+  return stamp;
+}
+
+bool ErrorPageResolver::IsValid(const Entry& entry) {
+  return std::all_of(
+      entry.stamps.cbegin(), entry.stamps.cend(),
+      [](const DirStamp& stamp) { return StampOf(stamp.path) == stamp; });
+}
+
+ErrorPageResolver::Entry ErrorPageResolver::Lookup(
+    const std::string& error_page,
+    const std::string& language) {
+  namespace fs = std::filesystem;
+
+  Entry entry;
+  const fs::path search_path = fs::path(error_page).parent_path();
+  for (const auto& candidate : util::GetErrorPagePaths(error_page, language)) {
+    // A missing directory shows up in the modification time of its nearest
+    // existing parent once it is created.
+    fs::path dir = fs::path(candidate).parent_path();
+    DirStamp stamp = StampOf(dir.string());
+    while (stamp.mtime_ns < 0 && dir != search_path &&
+           dir.has_relative_path()) {
+      dir = dir.parent_path();
+      stamp = StampOf(dir.string());
+    }
+    if (std::find(entry.stamps.cbegin(), entry.stamps.cend(), stamp) ==
+        entry.stamps.cend()) {
+      entry.stamps.push_back(std::move(stamp));
+    }
+
+    if (util::DoesPathExist(candidate)) {
+      entry.path = candidate;
+      break;
+    }
+  }
+  return entry;
+}
@@ -0,0 +1,87 @@
+// Copyright (c) 2021 LG Electronics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef UTIL_ERROR_PAGE_RESOLVER_H_
+#define UTIL_ERROR_PAGE_RESOLVER_H_
+
+#include <sys/types.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+// Resolves the localized variant of the error page for a language and keeps
+// the result per (error page, language). An entry records the directories
+// its candidates were looked up in, or their nearest existing parent, and is
+// resolved again as soon as one of them is modified, i.e. a variant was
+// added or removed. Revalidation takes a few stat() calls, without building
+// the candidate list again.
+class ErrorPageResolver {
+ public:
+  struct Stats {
+    uint64_t hits = 0;
+    uint64_t misses = 0;
+    size_t entries = 0;
+  };
+
+  static constexpr size_t kMaxEntries = 32;
+
+  ErrorPageResolver() = default;
+
+  ErrorPageResolver(const ErrorPageResolver&) = delete;
+  ErrorPageResolver& operator=(const ErrorPageResolver&) = delete;
+
+  // Returns the path of the first existing candidate for the local
+  // |error_page| file, see util::GetErrorPagePaths(), or an empty string if
+  // there is none. The path is returned by value, the cached entry goes
+  // away with the next miss that fills the cache up or a Clear().
+  std::string Resolve(const std::string& error_page,
+                      const std::string& language);
+  void Clear();
+
+  const Stats& GetStats() const { return stats_; }
+
+ private:
+  struct DirStamp {
+    std::string path;
+    dev_t device = 0;
+    ino_t inode = 0;
+    // -1 if the directory doesn't exist.
+    int64_t mtime_ns = -1;
+
+    bool operator==(const DirStamp&) const = default;
+  };
+
+  struct Entry {
+    std::string path;
+    std::vector<DirStamp> stamps;
+  };
+
+  using Key = std::pair<std::string, std::string>;
+
+  static DirStamp StampOf(const std::string& dir);
+  static bool IsValid(const Entry& entry);
+  static Entry Lookup(const std::string& error_page,
+                      const std::string& language);
+
+  std::map<Key, Entry> entries_;
+  Stats stats_;
+};
+
+#endif  // UTIL_ERROR_PAGE_RESOLVER_H_
@@ -0,0 +1,112 @@
+// Copyright (c) 2021 LG Electronics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#include "file_content_cache.h"
+
+#include <sys/stat.h>
+
+#include <fstream>
+#include <iterator>
+#include <utility>
+
+FileContentCache::FileContentCache(size_t max_bytes) : max_bytes_(max_bytes) {}
+
+FileContentCache::Content FileContentCache::Get(const std::string& path) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  struct stat st;
+  if (stat(path.c_str(), &st) || !S_ISREG(st.st_mode)) {
+    auto found = entries_.find(path);
+    if (found != entries_.end()) {
+      Erase(found);
+    }
+    return nullptr;
+  }
+
+  FileId id;
+  id.device = st.st_dev;
+  id.inode = st.st_ino;
+  id.mtime_ns =
+      static_cast<int64_t>(st.st_mtim.tv_sec) * 1000000000 + st.st_mtim.tv_nsec;
+  id.size = st.st_size;
+
+  auto found = entries_.find(path);
+  if (found != entries_.end()) {
+    if (found->second.id == id) {
+      ++stats_.hits;
+      lru_.splice(lru_.begin(), lru_, found->second.lru);
+      return found->second.content;
+    }
+    Erase(found);
+  }
+
+  ++stats_.misses;
+  std::ifstream file(path, std::ios::binary);
+  if (!file.is_open()) {
+    return nullptr;
+  }
+  Content content = std::make_shared<const std::string>(
+      std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+
+  // The file may change while it is read; such a content is not cached as
+  // it can't be matched with |id| anymore.
+  if (content->size() > max_bytes_ ||
+      content->size() != static_cast<size_t>(id.size)) {
+    return content;
+  }
+
+  lru_.push_front(path);
+  entries_.emplace(path, Entry{id, content, lru_.begin()});
+  ++stats_.entries;
+  stats_.bytes += content->size();
+  EvictToFit();
+
+  return content;
+}
+
+void FileContentCache::Invalidate(const std::string& path) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto found = entries_.find(path);
+  if (found != entries_.end()) {
+    Erase(found);
+  }
+}
+
+void FileContentCache::Clear() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  entries_.clear();
+  lru_.clear();
+  stats_.entries = 0;
+  stats_.bytes = 0;
+}
+
+FileContentCache::Stats FileContentCache::GetStats() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return stats_;
+}
+
+void FileContentCache::Erase(EntryMap::iterator it) {
+  stats_.bytes -= it->second.content->size();
+  --stats_.entries;
+  lru_.erase(it->second.lru);
+  entries_.erase(it);
+}
+
+void FileContentCache::EvictToFit() {
+  while (stats_.bytes > max_bytes_ && !lru_.empty()) {
+    Erase(entries_.find(lru_.back()));
+    ++stats_.evictions;
+  }
+}
@@ -0,0 +1,93 @@
+// Copyright (c) 2021 LG Electronics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef UTIL_FILE_CONTENT_CACHE_H_
+#define UTIL_FILE_CONTENT_CACHE_H_
+
+#include <sys/types.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+// Keeps the content of small files, such as user scripts, which are read
+// by many pages. Every lookup revalidates the entry with a stat() against
+// the device, inode, modification time and size the content was read with,
+// so an edited or replaced file is read again. The buffers are immutable
+// and shared, so pages can keep them after the entry is evicted. Lookups
+// may come from the file I/O thread.
+class FileContentCache {
+ public:
+  using Content = std::shared_ptr<const std::string>;
+
+  struct Stats {
+    uint64_t hits = 0;
+    uint64_t misses = 0;
+    uint64_t evictions = 0;
+    size_t entries = 0;
+    size_t bytes = 0;
+  };
+
+  static constexpr size_t kDefaultMaxBytes = 4 * 1024 * 1024;
+
+  explicit FileContentCache(size_t max_bytes = kDefaultMaxBytes);
+
+  FileContentCache(const FileContentCache&) = delete;
+  FileContentCache& operator=(const FileContentCache&) = delete;
+
+  // Returns null if |path| is not a readable regular file. Files larger than
+  // the size bound are returned but not kept.
+  Content Get(const std::string& path);
+  void Invalidate(const std::string& path);
+  void Clear();
+
+  Stats GetStats() const;
+  size_t MaxBytes() const { return max_bytes_; }
+
+ private:
+  struct FileId {
+    dev_t device = 0;
+    ino_t inode = 0;
+    int64_t mtime_ns = 0;
+    off_t size = 0;
+
+    bool operator==(const FileId&) const = default;
+  };
+
+  struct Entry {
+    FileId id;
+    Content content;
+    // Position in |lru_|, the most recently used path is at the front.
+    std::list<std::string>::iterator lru;
+  };
+
+  using EntryMap = std::unordered_map<std::string, Entry>;
+
+  void Erase(EntryMap::iterator it);
+  void EvictToFit();
+
+  const size_t max_bytes_;
+  mutable std::mutex mutex_;
+  EntryMap entries_;
+  std::list<std::string> lru_;
+  Stats stats_;
+};
+
+#endif  // UTIL_FILE_CONTENT_CACHE_H_
@@ -0,0 +1,228 @@
+// Copyright (c) 2021 LG Electronics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+
+#include "file_io_service.h"
+
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <fstream>
+#include <iterator>
+#include <mutex>
+
+#include <glib.h>
+
+#include "main_loop_watchdog.h"
+
+struct FileIoService::TaskGroup::State {
+  std::atomic<bool> cancelled{false};
+  // Only used on the thread of the main context.
+  size_t pending = 0;
+};
+
+struct FileIoService::Job {
+  Task task;
+  Reply reply;
+  std::shared_ptr<TaskGroup::State> group;
+};
+
+// Shared with the worker thread and the reply sources, which may be
+// dispatched after the service is gone.
+struct FileIoService::State {
+  GMainContext* context;
+
+  std::mutex mutex;
+  std::condition_variable wakeup;
+  bool running = true;
+  std::deque<Job> tasks;
+  std::deque<Job> replies;
+  // Attached while |replies| isn't empty.
+  GSource* reply_source = nullptr;
+};
+
+FileIoService::TaskGroup::TaskGroup() : state_(std::make_shared<State>()) {}
+
+FileIoService::TaskGroup::~TaskGroup() {
+  Cancel();
+}
+
+void FileIoService::TaskGroup::Cancel() {
+  state_->cancelled.store(true, std::memory_order_release);
+  // The group can be used again; the work posted so far stays cancelled.
+  state_ = std::make_shared<State>();
+}
+
+size_t FileIoService::TaskGroup::Pending() const {
+  return state_->pending;
+}
+
+// static
+FileIoService* FileIoService::Instance() {
+  static FileIoService* instance = new FileIoService();
+  return instance;
+}
+
+FileIoService::FileIoService(GMainContext* context)
+    : state_(std::make_shared<State>()) {
+  state_->context =
+      g_main_context_ref(context ? context : g_main_context_default());
+  thread_ = std::thread(Run, state_);
+}
+
+FileIoService::~FileIoService() {
+  {
+    std::lock_guard<std::mutex> lock(state_->mutex);
+    state_->running = false;
+    if (state_->reply_source) {
+      g_source_destroy(state_->reply_source);
+      g_source_unref(state_->reply_source);
+      state_->reply_source = nullptr;
+    }
+  }
+  state_->wakeup.notify_all();
+  thread_.join();
+
+  std::deque<Job> dropped;
+  dropped.swap(state_->tasks);
+  std::move(state_->replies.begin(), state_->replies.end(),
+            std::back_inserter(dropped));
+  state_->replies.clear();
+  for (const Job& job : dropped) {
+    if (job.group) {
+      --job.group->pending;
+    }
+  }
+  g_main_context_unref(state_->context);
+}
+
+void FileIoService::PostTaskAndReply(Task task,
+                                     Reply reply,
+                                     TaskGroup* group) {
+  if (!g_main_context_is_owner(state_->context)) {
+    // Nothing could call the reply until the context runs, e.g. during the
+    // startup, so the work is done right away.
+    if (!group || !group->state_->cancelled.load(std::memory_order_relaxed)) {
+      task();
+      reply();
+    }
+    return;
+  }
+
+  Job job{std::move(task), std::move(reply), nullptr};
+  if (group) {
+    job.group = group->state_;
+    ++job.group->pending;
+  }
+  {
+    std::lock_guard<std::mutex> lock(state_->mutex);
+    state_->tasks.push_back(std::move(job));
+  }
+  state_->wakeup.notify_one();
+}
+
+void FileIoService::ReadFile(
+    const std::string& path,
+    std::function<void(std::optional<std::string>)> reply,
+    TaskGroup* group) {
+  PostTaskAndReplyWithResult<std::optional<std::string>>(
+      [path]() -> std::optional<std::string> {
+        std::ifstream file(path, std::ios::binary);
+        if (!file.is_open()) {
+          return std::nullopt;
+        }
+        return std::string(std::istreambuf_iterator<char>(file),
+                           std::istreambuf_iterator<char>());
+      },
+      std::move(reply), group);
+}
+
+void FileIoService::PathExists(const std::string& path,
+                               std::function<void(bool)> reply,
+                               TaskGroup* group) {
+  PostTaskAndReplyWithResult<bool>(
+      [path] { return !access(path.c_str(), F_OK); }, std::move(reply),
+      group);
+}
+
+// static
+void FileIoService::Run(std::shared_ptr<State> state) {
+  auto on_replies = [](gpointer data) -> gboolean {
+    DispatchReplies(**static_cast<std::shared_ptr<State>*>(data));
+    return G_SOURCE_REMOVE;
+  };
+  auto release_state = [](gpointer data) {
+    delete static_cast<std::shared_ptr<State>*>(data);
+  };
+
+  std::unique_lock<std::mutex> lock(state->mutex);
+  while (true) {
+    state->wakeup.wait(
+        lock, [&state] { return !state->running || !state->tasks.empty(); });
+    if (!state->running) {
+      return;
+    }
+
+    Job job = std::move(state->tasks.front());
+    state->tasks.pop_front();
+    lock.unlock();
+    if (!job.group || !job.group->cancelled.load(std::memory_order_acquire)) {
+      job.task();
+    }
+    job.task = nullptr;
+    lock.lock();
+    // A cancelled job still goes back to update the pending count; only the
+    // thread of the main context may touch the group.
+    state->replies.push_back(std::move(job));
+    if (!state->running) {
+      return;
+    }
+    if (!state->reply_source) {
+      GSource* source = g_idle_source_new();
+      g_source_set_callback(source, on_replies,
+                            new std::shared_ptr<State>(state), release_state);
+      state->reply_source = source;
+      g_source_attach(source, state->context);
+    }
+  }
+}
+
+// static
+void FileIoService::DispatchReplies(State& state) {
+  std::deque<Job> replies;
+  {
+    std::lock_guard<std::mutex> lock(state.mutex);
+    replies.swap(state.replies);
+    if (state.reply_source) {
+      g_source_unref(state.reply_source);
+      state.reply_source = nullptr;
+    }
+  }
+
+  MainLoopWatchdog::Scope scope("File I/O reply");
+  for (Job& job : replies) {
+    if (job.group) {
+      --job.group->pending;
+      if (job.group->cancelled.load(std::memory_order_relaxed)) {
+        continue;
+      }
+    }
+    job.reply();
+  }
+}
@@ -0,0 +1,111 @@
+// Copyright (c) 2021 LG Electronics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+
+#ifndef UTIL_FILE_IO_SERVICE_H_
+#define UTIL_FILE_IO_SERVICE_H_
+
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <string>
+#include <thread>
+#include <utility>
+
+typedef struct _GMainContext GMainContext;
+
+// Runs blocking file system work, such as reading a file or checking that a
+// path exists, on a worker thread and calls the replies back on the GLib
+// main context the service was created for. The work runs one task at a
+// time, so the replies come in the order the work was posted. Work posted
+// from a thread which doesn't run the context, e.g. before the main loop
+// starts, is done inline instead, as its reply couldn't be called anyway.
+class FileIoService {
+ public:
+  using Task = std::function<void()>;
+  using Reply = std::function<void()>;
+
+  // Drops the replies of the work posted with it once it is cancelled or
+  // destroyed, so the owner, e.g. a page, can go away while a read is still
+  // running. Tasks which haven't started yet are skipped as well. Must be
+  // used on the thread of the main context.
+  class TaskGroup {
+   public:
+    TaskGroup();
+    ~TaskGroup();
+
+    TaskGroup(const TaskGroup&) = delete;
+    TaskGroup& operator=(const TaskGroup&) = delete;
+
+    void Cancel();
+    // Work posted with the group whose reply hasn't been called yet.
+    size_t Pending() const;
+
+   private:
+    friend class FileIoService;
+    struct State;
+
+    std::shared_ptr<State> state_;
+  };
+
+  // The service of the default main context. Never destroyed.
+  static FileIoService* Instance();
+
+  // A null |context| is the default main context.
+  explicit FileIoService(GMainContext* context = nullptr);
+  // Waits for the running task; the work and the replies still queued are
+  // dropped.
+  ~FileIoService();
+
+  FileIoService(const FileIoService&) = delete;
+  FileIoService& operator=(const FileIoService&) = delete;
+
+  void PostTaskAndReply(Task task, Reply reply, TaskGroup* group = nullptr);
+
+  template <typename T>
+  void PostTaskAndReplyWithResult(std::function<T()> task,
+                                  std::function<void(T)> reply,
+                                  TaskGroup* group = nullptr) {
+    auto result = std::make_shared<std::optional<T>>();
+    PostTaskAndReply(
+        [task = std::move(task), result] { result->emplace(task()); },
+        [reply = std::move(reply), result] {
+          reply(std::move(**result));
+        },
+        group);
+  }
+
+  // Replies with the content of |path|, or nothing if it can't be read.
+  void ReadFile(const std::string& path,
+                std::function<void(std::optional<std::string>)> reply,
+                TaskGroup* group = nullptr);
+  void PathExists(const std::string& path,
+                  std::function<void(bool)> reply,
+                  TaskGroup* group = nullptr);
+
+ private:
+  struct Job;
+  struct State;
+
+  static void Run(std::shared_ptr<State> state);
+  static void DispatchReplies(State& state);
+
+  std::shared_ptr<State> state_;
+  std::thread thread_;
+};
+
+#endif  // UTIL_FILE_IO_SERVICE_H_
@@ -0,0 +1,78 @@
+// Copyright (c) 2021 LG Electronics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef UTIL_FRAME_COALESCED_VALUE_H_
+#define UTIL_FRAME_COALESCED_VALUE_H_
+
+#include <optional>
+#include <utility>
+
+// Rate limits the updates of a value pushed to an external consumer, such as
+// the compositor, to one per frame. The first update in a frame is sent at
+// once, later ones only keep the latest value, which is sent on the next
+// frame. Updates equal to the value the consumer already has are dropped.
+template <typename T>
+class FrameCoalescedValue {
+ public:
+  // Returns true if |value| is to be sent now; Sent() returns it then.
+  bool Update(T value) {
+    if (pending_) {
+      if (sent_ == value) {
+        pending_.reset();
+      } else {
+        pending_ = std::move(value);
+      }
+      return false;
+    }
+    if (sent_ == value) {
+      return false;
+    }
+    if (sent_in_frame_) {
+      pending_ = std::move(value);
+      return false;
+    }
+    sent_ = std::move(value);
+    sent_in_frame_ = true;
+    return true;
+  }
+
+  // Starts a new frame. Returns true if the pending value is to be sent now;
+  // Sent() returns it then.
+  bool NextFrame() {
+    sent_in_frame_ = false;
+    if (!pending_) {
+      return false;
+    }
+    sent_ = std::move(pending_);
+    pending_.reset();
+    sent_in_frame_ = true;
+    return true;
+  }
+
+  // Forgets the sent value, for when the consumer changed it on its own.
+  // The next update is sent even if it is equal to the last one.
+  void Invalidate() { sent_.reset(); }
+
+  bool HasPending() const { return pending_.has_value(); }
+  const T& Sent() const { return *sent_; }
+
+ private:
+  std::optional<T> sent_;
+  std::optional<T> pending_;
+  bool sent_in_frame_ = false;
+};
+
+#endif  // UTIL_FRAME_COALESCED_VALUE_H_
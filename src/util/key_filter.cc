@@ -0,0 +1,39 @@
+// Copyright (c) 2021 LG Electronics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#include "key_filter.h"
+
+#include <algorithm>
+
+KeyFilter::KeyFilter(
+    const std::unordered_map<int, std::pair<int, int>>& table) {
+  entries_.reserve(table.size());
+  for (const auto& [from, to] : table) {
+    entries_.push_back({from, to.first, to.second});
+  }
+  std::sort(entries_.begin(), entries_.end(),
+            [](const Entry& a, const Entry& b) { return a.from < b.from; });
+}
+
+const KeyFilter::Entry* KeyFilter::Find(int key_code) const {
+  auto found = std::lower_bound(
+      entries_.begin(), entries_.end(), key_code,
+      [](const Entry& entry, int key) { return entry.from < key; });
+  if (found == entries_.end() || found->from != key_code) {
+    return nullptr;
+  }
+  return &*found;
+}
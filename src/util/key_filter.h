@@ -0,0 +1,50 @@
+// Copyright (c) 2021 LG Electronics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef UTIL_KEY_FILTER_H_
+#define UTIL_KEY_FILTER_H_
+
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+// Key code remapping of an app, compiled from its key filter table into a
+// flat array sorted by the source key code. Looking a key up is a binary
+// search over a few contiguous entries, without any allocation, as it is
+// done for every key event.
+class KeyFilter {
+ public:
+  struct Entry {
+    int from;
+    int to;
+    int modifier;
+  };
+
+  KeyFilter() = default;
+  // |table| maps a key code to the key code and modifier it is replaced by.
+  explicit KeyFilter(const std::unordered_map<int, std::pair<int, int>>& table);
+
+  // Returns null if |key_code| is not remapped.
+  const Entry* Find(int key_code) const;
+
+  bool IsEmpty() const { return entries_.empty(); }
+  const std::vector<Entry>& Entries() const { return entries_; }
+
+ private:
+  std::vector<Entry> entries_;
+};
+
+#endif  // UTIL_KEY_FILTER_H_
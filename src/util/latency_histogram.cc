@@ -0,0 +1,80 @@
+// Copyright (c) 2021 LG Electronics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+
+#include "latency_histogram.h"
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+
+void LatencyHistogram::Add(int64_t value_us) {
+  value_us = std::max<int64_t>(value_us, 0);
+  min_us_ = count_ ? std::min(min_us_, value_us) : value_us;
+  max_us_ = std::max(max_us_, value_us);
+  sum_us_ += value_us;
+  ++count_;
+  ++buckets_[BucketIndex(value_us)];
+}
+
+int64_t LatencyHistogram::Percentile(double percentile) const {
+  if (!count_) {
+    return 0;
+  }
+  const uint64_t rank = std::clamp<uint64_t>(
+      static_cast<uint64_t>(std::ceil(count_ * percentile / 100.0)), 1,
+      count_);
+  uint64_t seen = 0;
+  for (size_t i = 0; i < kBucketCount; ++i) {
+    seen += buckets_[i];
+    if (seen >= rank) {
+      return std::min(BucketUpperBound(i), max_us_);
+    }
+  }
+  return max_us_;
+}
+
+// static
+size_t LatencyHistogram::BucketIndex(int64_t value_us) {
+  if (value_us < kSubBuckets) {
+    return static_cast<size_t>(std::max<int64_t>(value_us, 0));
+  }
+  const int exponent = std::bit_width(static_cast<uint64_t>(value_us)) - 1;
+  if (exponent >= kMaxExponent) {
+    return kBucketCount - 1;
+  }
+  const int shift = exponent - kSubBucketBits;
+  const int64_t sub_bucket = (value_us >> shift) - kSubBuckets;
+  return (shift + 1) * kSubBuckets + sub_bucket;
+}
+
+// static
+int64_t LatencyHistogram::BucketLowerBound(size_t index) {
+  if (index < 2 * kSubBuckets) {
+    return static_cast<int64_t>(index);
+  }
+  const int shift = static_cast<int>(index / kSubBuckets) - 1;
+  return (kSubBuckets + static_cast<int64_t>(index % kSubBuckets)) << shift;
+}
+
+// static
+int64_t LatencyHistogram::BucketUpperBound(size_t index) {
+  if (index < 2 * kSubBuckets) {
+    return static_cast<int64_t>(index);
+  }
+  const int shift = static_cast<int>(index / kSubBuckets) - 1;
+  return BucketLowerBound(index) + (int64_t{1} << shift) - 1;
+}
@@ -0,0 +1,63 @@
+// Copyright (c) 2021 LG Electronics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+
+#ifndef UTIL_LATENCY_HISTOGRAM_H_
+#define UTIL_LATENCY_HISTOGRAM_H_
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+// Latency histogram with HDR-style buckets: values below kSubBuckets are
+// counted exactly, and every power of two range above is split into
+// kSubBuckets linear buckets. Values keep a relative precision of 1/8 up
+// to 2^kMaxExponent microseconds (about 71 minutes), larger ones land in
+// the last bucket.
+class LatencyHistogram {
+ public:
+  static constexpr int kSubBucketBits = 3;
+  static constexpr int64_t kSubBuckets = int64_t{1} << kSubBucketBits;
+  static constexpr int kMaxExponent = 32;
+  static constexpr size_t kBucketCount =
+      (kMaxExponent - kSubBucketBits + 1) * kSubBuckets;
+
+  void Add(int64_t value_us);
+  void Reset() { *this = LatencyHistogram(); }
+
+  uint64_t Count() const { return count_; }
+  int64_t Sum() const { return sum_us_; }
+  int64_t Min() const { return count_ ? min_us_ : 0; }
+  int64_t Max() const { return max_us_; }
+  int64_t Mean() const { return count_ ? sum_us_ / count_ : 0; }
+  // Upper bound of the bucket holding the |percentile|th value, never more
+  // than the largest value recorded.
+  int64_t Percentile(double percentile) const;
+
+  uint64_t BucketValue(size_t index) const { return buckets_[index]; }
+  static size_t BucketIndex(int64_t value_us);
+  static int64_t BucketLowerBound(size_t index);
+  static int64_t BucketUpperBound(size_t index);
+
+ private:
+  uint64_t count_ = 0;
+  int64_t sum_us_ = 0;
+  int64_t min_us_ = 0;
+  int64_t max_us_ = 0;
+  std::array<uint64_t, kBucketCount> buckets_{};
+};
+
+#endif  // UTIL_LATENCY_HISTOGRAM_H_
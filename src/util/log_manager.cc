@@ -16,16 +16,96 @@
 
 #include "log_manager.h"
 
-static bool debug_events_enable = false;
-static bool debug_bundle_messages_enable = false;
-static bool debug_mouse_move_enable = false;
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <optional>
+
+namespace {
+
+bool debug_events_enable = false;
+bool debug_bundle_messages_enable = false;
+bool debug_mouse_move_enable = false;
+
+// Replaced as a whole on every change, so that the threads which log read
+// a consistent set of levels with one atomic load.
+struct Levels {
+  // Unset follows the level of the backend.
+  std::optional<LogManager::Level> default_level;
+  // Few entries, so a linear search is cheaper than hashing the message id.
+  std::vector<LogManager::CategoryLevel> categories;
+};
+
+// Serializes the changes. The levels are never freed, as other threads may
+// still read replaced ones, also while exiting; they only change through
+// logControl, so there are few.
+std::mutex levels_mutex;
+auto* all_levels = new std::vector<std::unique_ptr<const Levels>>(1);
+std::atomic<const Levels*> published_levels{
+    (all_levels->front() = std::make_unique<Levels>()).get()};
+
+const Levels& CurrentLevels() {
+  return *published_levels.load(std::memory_order_acquire);
+}
+
+template <typename Change>
+void UpdateLevels(Change change) {
+  std::lock_guard<std::mutex> lock(levels_mutex);
+  auto updated = std::make_unique<Levels>(CurrentLevels());
+  change(*updated);
+  published_levels.store(updated.get(), std::memory_order_release);
+  all_levels->push_back(std::move(updated));
+}
+
+#ifdef DISABLE_PMLOG
+LogManager::Level BackendLevel() {
+  return LogManager::Level::kDebug;
+}
+#else
+// The level of the WAM PmLog context, which PmLogCtl can change at runtime.
+LogManager::Level BackendLevel() {
+  int level = kPmLogLevel_Debug;
+  if (PmLogGetContextLevel(GetWAMPmLogContext(), &level) != kPmLogErr_None) {
+    return LogManager::Level::kDebug;
+  }
+  // The least severe level the context still lets through.
+  if (level < kPmLogLevel_Critical) {
+    return LogManager::Level::kNone;
+  }
+  if (level < kPmLogLevel_Error) {
+    return LogManager::Level::kCritical;
+  }
+  if (level < kPmLogLevel_Warning) {
+    return LogManager::Level::kError;
+  }
+  if (level < kPmLogLevel_Info) {
+    return LogManager::Level::kWarning;
+  }
+  if (level < kPmLogLevel_Debug) {
+    return LogManager::Level::kInfo;
+  }
+  return LogManager::Level::kDebug;
+}
+#endif
+
+}  // namespace
 
 void LogManager::SetLogControl(const std::string& keys,
-                               const std::string& value) {
+                               const std::string& value,
+                               const std::string& category) {
   LOG_DEBUG("[LogManager::setLogControl] keys : %s, value : %s", keys.c_str(),
             value.c_str());
 
-  if (keys == "all") {
+  if (keys == "level") {
+    Level level;
+    if (value == "default") {
+      ClearCategoryLevel(category);
+    } else if (LevelFromName(value, level)) {
+      SetLevel(level, category);
+    }
+  } else if (keys == "all") {
     if (value == "on") {
       debug_events_enable = true;
       debug_bundle_messages_enable = true;
@@ -65,3 +145,81 @@ bool LogManager::GetDebugBundleMessagesEnabled() {
 bool LogManager::GetDebugMouseMoveEnabled() {
   return debug_mouse_move_enable;
 }
+
+bool LogManager::IsLevelEnabled(Level level, const char* msgid) {
+  const Levels& current = CurrentLevels();
+  if (msgid) {
+    for (const CategoryLevel& entry : current.categories) {
+      if (!strcmp(entry.category.c_str(), msgid)) {
+        return level <= entry.level;
+      }
+    }
+  }
+  return level <= current.default_level.value_or(BackendLevel());
+}
+
+void LogManager::SetLevel(Level level, const std::string& category) {
+  UpdateLevels([&](Levels& levels) {
+    if (category.empty()) {
+      levels.default_level = level;
+      return;
+    }
+    auto found = std::find_if(
+        levels.categories.begin(), levels.categories.end(),
+        [&](const CategoryLevel& entry) { return entry.category == category; });
+    if (found != levels.categories.end()) {
+      found->level = level;
+    } else {
+      levels.categories.push_back({category, level});
+    }
+  });
+}
+
+void LogManager::ClearCategoryLevel(const std::string& category) {
+  UpdateLevels([&](Levels& levels) {
+    if (category.empty()) {
+      levels.default_level.reset();
+      return;
+    }
+    std::erase_if(levels.categories, [&](const CategoryLevel& entry) {
+      return entry.category == category;
+    });
+  });
+}
+
+LogManager::Level LogManager::GetDefaultLevel() {
+  return CurrentLevels().default_level.value_or(BackendLevel());
+}
+
+std::vector<LogManager::CategoryLevel> LogManager::GetCategoryLevels() {
+  return CurrentLevels().categories;
+}
+
+const char* LogManager::LevelName(Level level) {
+  switch (level) {
+    case Level::kNone:
+      return "none";
+    case Level::kCritical:
+      return "critical";
+    case Level::kError:
+      return "error";
+    case Level::kWarning:
+      return "warning";
+    case Level::kInfo:
+      return "info";
+    case Level::kDebug:
+      return "debug";
+  }
+  return "";
+}
+
+bool LogManager::LevelFromName(const std::string& name, Level& level) {
+  for (Level candidate : {Level::kNone, Level::kCritical, Level::kError,
+                          Level::kWarning, Level::kInfo, Level::kDebug}) {
+    if (name == LevelName(candidate)) {
+      level = candidate;
+      return true;
+    }
+  }
+  return false;
+}
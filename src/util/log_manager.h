@@ -46,6 +46,15 @@
 #define LOG_INFO_WITH_CLOCK_TO_CUSTOM_CONTEXT(...) \
   do {                                             \
   } while (0)
+#define LOG_INFO_RATE_LIMITED(...) \
+  do {                             \
+  } while (0)
+#define LOG_WARNING_RATE_LIMITED(...) \
+  do {                                \
+  } while (0)
+#define LOG_ERROR_RATE_LIMITED(...) \
+  do {                              \
+  } while (0)
 
 #else
 
@@ -57,16 +66,98 @@
 #include "log_manager_pmlog.h"
 #endif
 
+#include "log_rate_limiter.h"
+
+// The arguments of a message are only evaluated if its level is enabled for
+// its message id.
+#define LOG_IF_ENABLED(__level, __msgid, __log)                            \
+  do {                                                                     \
+    if (LogManager::IsLevelEnabled(LogManager::Level::__level, __msgid)) { \
+      __log;                                                               \
+    }                                                                      \
+  } while (0)
+
+#define LOG_INFO(__msgid, ...) \
+  LOG_IF_ENABLED(kInfo, __msgid, LOG_BACKEND_INFO(__msgid, __VA_ARGS__))
+#define LOG_INFO_WITH_CLOCK(__msgid, ...) \
+  LOG_IF_ENABLED(kInfo, __msgid,          \
+                 LOG_BACKEND_INFO_WITH_CLOCK(__msgid, __VA_ARGS__))
+#define LOG_DEBUG(...) \
+  LOG_IF_ENABLED(kDebug, nullptr, LOG_BACKEND_DEBUG(__VA_ARGS__))
+#define LOG_WARNING(__msgid, ...) \
+  LOG_IF_ENABLED(kWarning, __msgid, LOG_BACKEND_WARNING(__msgid, __VA_ARGS__))
+#define LOG_ERROR(__msgid, ...) \
+  LOG_IF_ENABLED(kError, __msgid, LOG_BACKEND_ERROR(__msgid, __VA_ARGS__))
+#define LOG_CRITICAL(__msgid, ...) \
+  LOG_IF_ENABLED(kCritical, __msgid, LOG_BACKEND_CRITICAL(__msgid, __VA_ARGS__))
+
+// Lets at most |__burst| messages of the call site through at once, and
+// |__rate| per second after that. The number of dropped messages is logged
+// before the next one that gets through.
+#define LOG_RATE_LIMITED(__level, __backend, __rate, __burst, __msgid, ...)  \
+  do {                                                                       \
+    if (LogManager::IsLevelEnabled(LogManager::Level::__level, __msgid)) {   \
+      static LogRateLimiter __limiter(__rate, __burst);                      \
+      uint64_t __suppressed = 0;                                             \
+      if (__limiter.Allow(&__suppressed)) {                                  \
+        if (__suppressed) {                                                  \
+          __backend(__msgid, 1,                                              \
+                    PMLOGKFV("SUPPRESSED", "%llu",                           \
+                             static_cast<unsigned long long>(__suppressed)), \
+                    "Suppressed messages");                                  \
+        }                                                                    \
+        __backend(__msgid, __VA_ARGS__);                                     \
+      }                                                                      \
+    }                                                                        \
+  } while (0)
+
+#define LOG_INFO_RATE_LIMITED(__rate, __burst, __msgid, ...)          \
+  LOG_RATE_LIMITED(kInfo, LOG_BACKEND_INFO, __rate, __burst, __msgid, \
+                   __VA_ARGS__)
+#define LOG_WARNING_RATE_LIMITED(__rate, __burst, __msgid, ...)             \
+  LOG_RATE_LIMITED(kWarning, LOG_BACKEND_WARNING, __rate, __burst, __msgid, \
+                   __VA_ARGS__)
+#define LOG_ERROR_RATE_LIMITED(__rate, __burst, __msgid, ...)           \
+  LOG_RATE_LIMITED(kError, LOG_BACKEND_ERROR, __rate, __burst, __msgid, \
+                   __VA_ARGS__)
+
 #endif
 
 #include <string>
+#include <vector>
 
 class LogManager {
  public:
-  static void SetLogControl(const std::string& keys, const std::string& value);
+  enum class Level { kNone, kCritical, kError, kWarning, kInfo, kDebug };
+
+  struct CategoryLevel {
+    std::string category;
+    Level level;
+  };
+
+  // Handles the "event", "bundleMessage", "mouseMove" and "all" debug
+  // switches, and "level" which sets the level of |category|, a message id,
+  // or the default one if |category| is empty. The "default" value drops
+  // the level of |category|, or the default level, which then follows the
+  // level of the backend (the PmLog context).
+  static void SetLogControl(const std::string& keys,
+                            const std::string& value,
+                            const std::string& category = {});
   static bool GetDebugEventsEnabled();
   static bool GetDebugBundleMessagesEnabled();
   static bool GetDebugMouseMoveEnabled();
+
+  // |msgid| may be null, for messages without one. Thread safe, the levels
+  // can change while other threads log.
+  static bool IsLevelEnabled(Level level, const char* msgid);
+  static void SetLevel(Level level, const std::string& category = {});
+  // An empty |category| clears the default level.
+  static void ClearCategoryLevel(const std::string& category);
+  static Level GetDefaultLevel();
+  static std::vector<CategoryLevel> GetCategoryLevels();
+
+  static const char* LevelName(Level level);
+  static bool LevelFromName(const std::string& name, Level& level);
 };
 
 #endif  // UTIL_LOG_MANAGER_H_
@@ -14,15 +14,62 @@
 //
 // SPDX-License-Identifier: Apache-2.0
 
+#include <signal.h>
 #include <stdarg.h>
+#include <unistd.h>
 
 #include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iterator>
 #include <unordered_map>
 
 #include "log_manager_console.h"
+#include "log_ring_buffer.h"
 
 namespace {
 
+constexpr int kCrashSignals[] = {SIGABRT, SIGBUS, SIGFPE, SIGILL, SIGSEGV};
+struct sigaction previous_actions[std::size(kCrashSignals)];
+LogRingBuffer* async_log = nullptr;
+
+void FlushOnCrash(int signal) {
+  async_log->FlushFromSignalHandler();
+  for (size_t i = 0; i < std::size(kCrashSignals); ++i) {
+    if (kCrashSignals[i] == signal) {
+      sigaction(signal, &previous_actions[i], nullptr);
+    }
+  }
+  raise(signal);
+}
+
+void FlushOnExit() {
+  async_log->Flush();
+}
+
+// Lines are written by a background thread unless WAM_SYNC_LOG is set.
+LogRingBuffer* AsyncLog() {
+  // not a leak -- the writer thread runs until the process exits
+  static LogRingBuffer* instance = [] {
+    const char* sync = getenv("WAM_SYNC_LOG");
+    if (sync && strcmp(sync, "0")) {
+      return static_cast<LogRingBuffer*>(nullptr);
+    }
+    async_log = new LogRingBuffer(STDERR_FILENO);
+    async_log->Start();
+    atexit(FlushOnExit);
+
+    struct sigaction action = {};
+    action.sa_handler = FlushOnCrash;
+    sigemptyset(&action.sa_mask);
+    for (size_t i = 0; i < std::size(kCrashSignals); ++i) {
+      sigaction(kCrashSignals[i], &action, &previous_actions[i]);
+    }
+    return async_log;
+  }();
+  return instance;
+}
+
 // Source: /usr/include/PmLogLib.h
 enum PmLogLevelSubstitution {
   kPmLogLevel_None = -1,     /* no output */
@@ -57,20 +104,27 @@ const char* ValueOrEmpty(const char* value) {
 }  // namespace
 
 void LogMsgImpl(const char* level, const char* msgid, const char* fmt, ...) {
-  fprintf(stderr, "[%s] %s ", ValueOrEmpty(level), ValueOrEmpty(msgid));
-
   va_list args;
   va_start(args, fmt);
-  vfprintf(stderr, fmt, args);
+  if (LogRingBuffer* log = AsyncLog()) {
+    log->AppendV(level, msgid, fmt, args);
+  } else {
+    fprintf(stderr, "[%s] %s ", ValueOrEmpty(level), ValueOrEmpty(msgid));
+    vfprintf(stderr, fmt, args);
+    fprintf(stderr, "\n");
+  }
   va_end(args);
-
-  fprintf(stderr, "\n");
 }
 
 void LogString(int32_t level,
                const char* msgid,
                const char* kvpairs,
                const char* message) {
+  if (LogRingBuffer* log = AsyncLog()) {
+    log->Append(GetLogLevelName(level).c_str(), msgid, "%s %s",
+                ValueOrEmpty(kvpairs), ValueOrEmpty(message));
+    return;
+  }
   fprintf(stderr, "[%s] %s %s %s\n", GetLogLevelName(level).c_str(),
           ValueOrEmpty(msgid), ValueOrEmpty(kvpairs), ValueOrEmpty(message));
 }
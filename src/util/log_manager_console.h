@@ -50,12 +50,13 @@ void LogString(int32_t level,
 #define LogCritical(msgid, kv_count, ...) \
   LogMsg("CRITICAL", msgid, kv_count, __VA_ARGS__)
 
-#define LOG_INFO(__msgid, ...) LogInfo(__msgid, __VA_ARGS__)
-#define LOG_INFO_WITH_CLOCK(__msgid, ...) LogInfo(__msgid, __VA_ARGS__)
-#define LOG_DEBUG(...) LogDebug(__VA_ARGS__)
-#define LOG_WARNING(__msgid, ...) LogWarning(__msgid, __VA_ARGS__)
-#define LOG_ERROR(__msgid, ...) LogError(__msgid, __VA_ARGS__)
-#define LOG_CRITICAL(__msgid, ...) LogCritical(__msgid, __VA_ARGS__)
+// Unfiltered, log_manager.h wraps them into the LOG_* macros.
+#define LOG_BACKEND_INFO(__msgid, ...) LogInfo(__msgid, __VA_ARGS__)
+#define LOG_BACKEND_INFO_WITH_CLOCK(__msgid, ...) LogInfo(__msgid, __VA_ARGS__)
+#define LOG_BACKEND_DEBUG(...) LogDebug(__VA_ARGS__)
+#define LOG_BACKEND_WARNING(__msgid, ...) LogWarning(__msgid, __VA_ARGS__)
+#define LOG_BACKEND_ERROR(__msgid, ...) LogError(__msgid, __VA_ARGS__)
+#define LOG_BACKEND_CRITICAL(__msgid, ...) LogCritical(__msgid, __VA_ARGS__)
 
 #define LOG_STRING(_context, __level, __msgid, ...) \
   ::LogString(__level, __msgid, ##__VA_ARGS__)
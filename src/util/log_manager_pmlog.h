@@ -30,18 +30,19 @@
       GetWAMPmLogContext(), __msgid, 3, PMLOGKS("PerfType", "AppLaunch"), \
       PMLOGKS("PerfGroup", __appid), PMLOGKS(LOG_APP_ID, __appid), "")
 
-// Use these to log using PmLogLib v3 API
-#define LOG_INFO(__msgid, ...) \
+// Use these to log using PmLogLib v3 API. Unfiltered, log_manager.h wraps
+// them into the LOG_* macros.
+#define LOG_BACKEND_INFO(__msgid, ...) \
   PmLogInfo(GetWAMPmLogContext(), __msgid __VA_OPT__(, ) __VA_ARGS__)
-#define LOG_INFO_WITH_CLOCK(__msgid, ...) \
+#define LOG_BACKEND_INFO_WITH_CLOCK(__msgid, ...) \
   PmLogInfoWithClock(GetWAMPmLogContext(), __msgid __VA_OPT__(, ) __VA_ARGS__)
-#define LOG_DEBUG(...) \
+#define LOG_BACKEND_DEBUG(...) \
   PmLogDebug(GetWAMPmLogContext() __VA_OPT__(, ) __VA_ARGS__)
-#define LOG_WARNING(__msgid, ...) \
+#define LOG_BACKEND_WARNING(__msgid, ...) \
   PmLogWarning(GetWAMPmLogContext(), __msgid __VA_OPT__(, ) __VA_ARGS__)
-#define LOG_ERROR(__msgid, ...) \
+#define LOG_BACKEND_ERROR(__msgid, ...) \
   PmLogError(GetWAMPmLogContext(), __msgid __VA_OPT__(, ) __VA_ARGS__)
-#define LOG_CRITICAL(__msgid, ...) \
+#define LOG_BACKEND_CRITICAL(__msgid, ...) \
   PmLogCritical(GetWAMPmLogContext(), __msgid __VA_OPT__(, ) __VA_ARGS__)
 
 #define LOG_STRING(__context_id, __level, __msgid, ...) \
@@ -57,6 +57,8 @@
 #define MSGID_POST_RUNNING_APPS     "MSGID_POST_RUNNING_APPS" /* Post Running app Change */
 #define MSGID_WAM_DEBUG     "GENERAL" /* General */
 #define MSGID_LUNA_API      "LUNA_API" /* About luna api */
+#define MSGID_MAIN_LOOP_STALL "MAIN_LOOP_STALL" /* Main loop did not dispatch for too long */
+#define MSGID_STARTUP_PROFILE "STARTUP_PROFILE" /* Duration of a WAM startup phase */
 #define MSGID_DEEPLINKING      "DEEPLINKING" /* handle deeplinking launch/relaunch */
 #define MSGID_VKB_EVENT     "VKB_EVENT" /* Received vkb event */
 
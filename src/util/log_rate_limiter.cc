@@ -0,0 +1,60 @@
+// Copyright (c) 2021 LG Electronics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+
+#include "log_rate_limiter.h"
+
+#include <algorithm>
+#include <chrono>
+
+namespace {
+
+int64_t SteadyClockMs() {
+  return std::chrono::duration_cast<std::chrono::milliseconds>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+LogRateLimiter::Clock now_ms = &SteadyClockMs;
+
+}  // namespace
+
+LogRateLimiter::LogRateLimiter(double rate, double burst)
+    : rate_per_ms_(std::max(rate, 0.0) / 1000.0),
+      burst_(std::max(burst, 1.0)),
+      tokens_(burst_) {}
+
+bool LogRateLimiter::Allow(uint64_t* suppressed) {
+  const int64_t now = now_ms();
+  if (last_refill_ms_ >= 0 && now > last_refill_ms_) {
+    tokens_ =
+        std::min(burst_, tokens_ + (now - last_refill_ms_) * rate_per_ms_);
+  }
+  last_refill_ms_ = now;
+
+  if (tokens_ < 1.0) {
+    ++suppressed_;
+    return false;
+  }
+  tokens_ -= 1.0;
+  *suppressed = suppressed_;
+  suppressed_ = 0;
+  return true;
+}
+
+void LogRateLimiter::SetClockForTesting(Clock testing_clock) {
+  now_ms = testing_clock ? testing_clock : &SteadyClockMs;
+}
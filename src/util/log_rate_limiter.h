@@ -0,0 +1,47 @@
+// Copyright (c) 2021 LG Electronics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+
+#ifndef UTIL_LOG_RATE_LIMITER_H_
+#define UTIL_LOG_RATE_LIMITER_H_
+
+#include <cstdint>
+
+// Token bucket of one logging call site: it holds up to |burst| tokens and
+// gets |rate| tokens per second, a message takes one. Not synchronized, the
+// call sites log from the main thread.
+class LogRateLimiter {
+ public:
+  // Monotonic time in milliseconds.
+  using Clock = int64_t (*)();
+
+  LogRateLimiter(double rate, double burst);
+
+  // Returns false if the message has to be dropped. Otherwise |suppressed|
+  // is set to the number of messages dropped since the last one let through.
+  bool Allow(uint64_t* suppressed);
+
+  static void SetClockForTesting(Clock clock);
+
+ private:
+  const double rate_per_ms_;
+  const double burst_;
+  double tokens_;
+  int64_t last_refill_ms_ = -1;
+  uint64_t suppressed_ = 0;
+};
+
+#endif  // UTIL_LOG_RATE_LIMITER_H_
@@ -0,0 +1,234 @@
+// Copyright (c) 2021 LG Electronics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+
+#include "log_ring_buffer.h"
+
+#include <errno.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+
+namespace {
+
+// Lines copied out of the ring before one write().
+constexpr size_t kBatchSlots = 16;
+
+size_t RoundUpToPowerOfTwo(size_t value) {
+  size_t result = 1;
+  while (result < value) {
+    result <<= 1;
+  }
+  return result;
+}
+
+void WriteAll(int fd, const char* data, size_t length) {
+  while (length) {
+    ssize_t written = write(fd, data, length);
+    if (written < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      return;
+    }
+    data += written;
+    length -= written;
+  }
+}
+
+}  // namespace
+
+LogRingBuffer::LogRingBuffer(int fd, size_t slot_count)
+    : fd_(fd),
+      slot_count_(RoundUpToPowerOfTwo(std::max<size_t>(slot_count, 2))),
+      slots_(std::make_unique<Slot[]>(slot_count_)),
+      batch_(std::make_unique<char[]>(kBatchSlots * kSlotSize)) {}
+
+LogRingBuffer::~LogRingBuffer() {
+  if (writer_.joinable()) {
+    {
+      std::lock_guard<std::mutex> lock(wake_mutex_);
+      stopping_ = true;
+    }
+    wake_.notify_one();
+    writer_.join();
+  }
+  Flush();
+}
+
+void LogRingBuffer::Start() {
+  if (!writer_.joinable()) {
+    writer_ = std::thread(&LogRingBuffer::WriterLoop, this);
+  }
+}
+
+void LogRingBuffer::Flush() {
+  std::lock_guard<std::mutex> lock(write_mutex_);
+  while (draining_.exchange(true, std::memory_order_acquire)) {
+    std::this_thread::yield();
+  }
+  Drain();
+  draining_.store(false, std::memory_order_release);
+}
+
+void LogRingBuffer::FlushFromSignalHandler() {
+  if (draining_.exchange(true, std::memory_order_acquire)) {
+    return;
+  }
+  Drain();
+  draining_.store(false, std::memory_order_release);
+}
+
+void LogRingBuffer::Append(const char* level,
+                           const char* msgid,
+                           const char* fmt,
+                           ...) {
+  va_list args;
+  va_start(args, fmt);
+  AppendV(level, msgid, fmt, args);
+  va_end(args);
+}
+
+void LogRingBuffer::AppendV(const char* level,
+                            const char* msgid,
+                            const char* fmt,
+                            va_list args) {
+  const bool producer = IsProducer();
+  Slot local;
+  Slot* slot = &local;
+  uint64_t head = 0;
+
+  if (producer) {
+    head = head_.load(std::memory_order_relaxed);
+    uint64_t tail = tail_.load(std::memory_order_acquire);
+    if (head - tail >= slot_count_) {
+      // The writer may consume the line at the same time, which makes room
+      // as well.
+      if (tail_.compare_exchange_strong(tail, tail + 1,
+                                        std::memory_order_acq_rel)) {
+        dropped_.fetch_add(1, std::memory_order_relaxed);
+      }
+    }
+    slot = &slots_[head & (slot_count_ - 1)];
+  }
+
+  // Keeps the last byte for the new line.
+  constexpr size_t kCapacity = kSlotSize - 1;
+  int length = snprintf(slot->data, kCapacity, "[%s] %s ", level ? level : "",
+                        msgid ? msgid : "");
+  size_t used = std::min<size_t>(std::max(length, 0), kCapacity - 1);
+  length = vsnprintf(slot->data + used, kCapacity - used, fmt, args);
+  if (length >= 0 && used + length >= kCapacity) {
+    truncated_.fetch_add(1, std::memory_order_relaxed);
+    used = kCapacity - 1;
+  } else {
+    used += std::max(length, 0);
+  }
+  slot->data[used++] = '\n';
+  slot->length = used;
+
+  if (!producer) {
+    synchronous_.fetch_add(1, std::memory_order_relaxed);
+    WriteSynchronously(*slot);
+    return;
+  }
+
+  head_.store(head + 1, std::memory_order_release);
+  // Wakes the writer early once the ring is half full, without paying for a
+  // notification on every line.
+  if (head + 1 - tail_.load(std::memory_order_relaxed) == slot_count_ / 2) {
+    wake_.notify_one();
+  }
+}
+
+LogRingBuffer::Stats LogRingBuffer::GetStats() const {
+  Stats stats;
+  stats.appended = head_.load(std::memory_order_relaxed);
+  stats.dropped = dropped_.load(std::memory_order_relaxed);
+  stats.truncated = truncated_.load(std::memory_order_relaxed);
+  stats.synchronous = synchronous_.load(std::memory_order_relaxed);
+  return stats;
+}
+
+size_t LogRingBuffer::Pending() const {
+  return head_.load(std::memory_order_acquire) -
+         tail_.load(std::memory_order_acquire);
+}
+
+bool LogRingBuffer::IsProducer() {
+  const std::thread::id self = std::this_thread::get_id();
+  std::thread::id producer = producer_.load(std::memory_order_relaxed);
+  if (producer == self) {
+    return true;
+  }
+  if (producer != std::thread::id()) {
+    return false;
+  }
+  return producer_.compare_exchange_strong(producer, self) ||
+         producer == self;
+}
+
+void LogRingBuffer::WriteSynchronously(const Slot& line) {
+  // Older lines go first, so the output keeps the order of the calls as far
+  // as possible.
+  Flush();
+  WriteAll(fd_, line.data, line.length);
+}
+
+void LogRingBuffer::Drain() {
+  size_t batched = 0;
+  for (;;) {
+    uint64_t tail = tail_.load(std::memory_order_acquire);
+    if (tail == head_.load(std::memory_order_acquire)) {
+      break;
+    }
+    const Slot& slot = slots_[tail & (slot_count_ - 1)];
+    const size_t length = std::min<size_t>(slot.length, kSlotSize);
+    char* out = batch_.get() + batched;
+    memcpy(out, slot.data, length);
+    if (!tail_.compare_exchange_strong(tail, tail + 1,
+                                       std::memory_order_acq_rel)) {
+      // Dropped by the producer while it was copied.
+      continue;
+    }
+    batched += length;
+    if (batched > (kBatchSlots - 1) * kSlotSize) {
+      WriteAll(fd_, batch_.get(), batched);
+      batched = 0;
+    }
+  }
+  if (batched) {
+    WriteAll(fd_, batch_.get(), batched);
+  }
+}
+
+void LogRingBuffer::WriterLoop() {
+  for (;;) {
+    {
+      std::unique_lock<std::mutex> lock(wake_mutex_);
+      wake_.wait_for(lock, std::chrono::milliseconds(kWriterIntervalMs),
+                     [this] {
+                       return stopping_ || Pending() >= slot_count_ / 2;
+                     });
+      if (stopping_) {
+        return;
+      }
+    }
+    Flush();
+  }
+}
@@ -0,0 +1,116 @@
+// Copyright (c) 2021 LG Electronics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+
+#ifndef UTIL_LOG_RING_BUFFER_H_
+#define UTIL_LOG_RING_BUFFER_H_
+
+#include <stdarg.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+// Moves the writing of log lines off the logging thread. Lines are formatted
+// once into preallocated slots of a ring, and a background thread writes
+// them to |fd| in batches. The ring has a single producer, the first thread
+// that appends; other threads write their lines synchronously. When the ring
+// is full the oldest line is dropped and counted.
+class LogRingBuffer {
+ public:
+  struct Stats {
+    uint64_t appended = 0;
+    uint64_t dropped = 0;
+    uint64_t truncated = 0;
+    uint64_t synchronous = 0;
+  };
+
+  static constexpr size_t kDefaultSlotCount = 1024;
+  static constexpr size_t kSlotSize = 512;
+  static constexpr int kWriterIntervalMs = 20;
+
+  explicit LogRingBuffer(int fd = STDERR_FILENO,
+                         size_t slot_count = kDefaultSlotCount);
+  ~LogRingBuffer();
+
+  LogRingBuffer(const LogRingBuffer&) = delete;
+  LogRingBuffer& operator=(const LogRingBuffer&) = delete;
+
+  // Starts the writer thread. Without it lines are only written by Flush().
+  void Start();
+  // Writes every pending line before returning. Callable from any thread.
+  void Flush();
+  // Best effort flush for a crash handler: doesn't lock, and skips the
+  // flush if a writer is in the middle of a batch.
+  void FlushFromSignalHandler();
+
+  // Appends "[|level|] |msgid| " followed by |fmt| and a new line. Lines
+  // longer than a slot are truncated.
+  void Append(const char* level, const char* msgid, const char* fmt, ...)
+      __attribute__((format(printf, 4, 5)));
+  void AppendV(const char* level,
+               const char* msgid,
+               const char* fmt,
+               va_list args);
+
+  Stats GetStats() const;
+  size_t SlotCount() const { return slot_count_; }
+  size_t Pending() const;
+
+ private:
+  struct Slot {
+    uint32_t length;
+    char data[kSlotSize];
+  };
+
+  bool IsProducer();
+  void WriteSynchronously(const Slot& line);
+  // Writes the pending lines, |write_mutex_| or |draining_| must be held.
+  void Drain();
+  void WriterLoop();
+
+  const int fd_;
+  const size_t slot_count_;
+  std::unique_ptr<Slot[]> slots_;
+
+  // |head_| is only moved by the producer. |tail_| is moved by the writer,
+  // and by the producer when it drops the oldest line; a writer that loses
+  // the race on |tail_| discards the line it copied, as the producer may
+  // have been overwriting it.
+  std::atomic<uint64_t> head_{0};
+  std::atomic<uint64_t> tail_{0};
+  std::atomic<std::thread::id> producer_{};
+
+  std::atomic<uint64_t> dropped_{0};
+  std::atomic<uint64_t> truncated_{0};
+  std::atomic<uint64_t> synchronous_{0};
+
+  std::mutex write_mutex_;
+  std::atomic<bool> draining_{false};
+  std::unique_ptr<char[]> batch_;
+
+  std::mutex wake_mutex_;
+  std::condition_variable wake_;
+  bool stopping_ = false;
+  std::thread writer_;
+};
+
+#endif  // UTIL_LOG_RING_BUFFER_H_
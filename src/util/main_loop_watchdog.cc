@@ -0,0 +1,346 @@
+// Copyright (c) 2021 LG Electronics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+
+#include "main_loop_watchdog.h"
+
+#include <errno.h>
+#include <execinfo.h>
+#include <pthread.h>
+#include <signal.h>
+#include <string.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdlib>
+#include <mutex>
+#include <optional>
+#include <utility>
+
+#include <glib.h>
+
+#include "log_manager.h"
+#include "metrics_registry.h"
+
+namespace {
+
+// Ignored by default, so a stray one does no harm.
+constexpr int kSampleSignal = SIGURG;
+constexpr int kMaxFrames = 64;
+constexpr size_t kMaxLabelLength = 128;
+constexpr auto kSampleTimeout = std::chrono::milliseconds(100);
+
+// Only changed by the loop thread.
+std::atomic<const char*> current_label{nullptr};
+
+// Filled by the loop thread from the signal handler, which is only sent
+// when a backtrace is wanted.
+std::mutex sample_mutex;
+char sample_label[kMaxLabelLength];
+void* sample_frames[kMaxFrames];
+std::atomic<int> sample_size{-1};
+
+struct Sample {
+  std::string label;
+  std::vector<std::string> backtrace;
+};
+
+CounterFamily stalls("wam_main_loop_stalls_total",
+                     "Main loop stalls by the label of what was running",
+                     "source");
+HistogramFamily stall_seconds("wam_main_loop_stall_seconds",
+                              "Duration of the main loop stalls",
+                              "",
+                              {0.1, 0.25, 0.5, 1, 2.5, 5, 10, 30});
+
+int64_t NowMs() {
+  return std::chrono::duration_cast<std::chrono::milliseconds>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+void SampleSignalHandler(int) {
+  const int saved_errno = errno;
+  size_t length = 0;
+  if (const char* label = current_label.load(std::memory_order_relaxed)) {
+    for (; length + 1 < kMaxLabelLength && label[length]; ++length) {
+      sample_label[length] = label[length];
+    }
+  }
+  sample_label[length] = '\0';
+  const int size = backtrace(sample_frames, kMaxFrames);
+  sample_size.store(size, std::memory_order_release);
+  errno = saved_errno;
+}
+
+// Reads the label of the running scope from another thread. The loop is
+// not interrupted: a signal would make the call it is blocked in, such as
+// poll(), return early.
+std::string CurrentLabel() {
+  const char* label = current_label.load(std::memory_order_acquire);
+  if (!label) {
+    return std::string();
+  }
+  return std::string(label, strnlen(label, kMaxLabelLength - 1));
+}
+
+bool InstallSampleHandler() {
+  // backtrace() loads libgcc on its first call, never do it in the handler.
+  void* frame;
+  backtrace(&frame, 1);
+
+  struct sigaction action = {};
+  action.sa_handler = SampleSignalHandler;
+  action.sa_flags = SA_RESTART;
+  sigemptyset(&action.sa_mask);
+  return !sigaction(kSampleSignal, &action, nullptr);
+}
+
+// Takes the label of the running scope and a backtrace on the loop
+// |thread|; nothing if it doesn't handle the signal in time.
+std::optional<Sample> TakeSample(pthread_t thread) {
+  std::lock_guard<std::mutex> lock(sample_mutex);
+  sample_size.store(-1, std::memory_order_relaxed);
+  if (pthread_kill(thread, kSampleSignal)) {
+    return std::nullopt;
+  }
+  const auto deadline = std::chrono::steady_clock::now() + kSampleTimeout;
+  int size;
+  while ((size = sample_size.load(std::memory_order_acquire)) < 0) {
+    if (std::chrono::steady_clock::now() > deadline) {
+      return std::nullopt;
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+
+  Sample sample;
+  sample.label = sample_label;
+  char** symbols = size ? backtrace_symbols(sample_frames, size) : nullptr;
+  if (symbols) {
+    // The first frames are the signal handler and the trampoline.
+    for (int i = std::min(size, 2); i < size; ++i) {
+      sample.backtrace.emplace_back(symbols[i]);
+    }
+    free(symbols);
+  }
+  return sample;
+}
+
+}  // namespace
+
+// Shared with the ping sources, which may be dispatched after the watchdog
+// is gone.
+struct MainLoopWatchdog::State {
+  GMainContext* context;
+  Options options;
+  // Whether backtraces can be taken.
+  bool sampling = false;
+  pthread_t loop_thread;
+
+  std::mutex mutex;
+  std::condition_variable wakeup;
+  bool running = false;
+  GSource* ping = nullptr;
+  int64_t ping_sent_ms = 0;
+  int64_t pong_ms = 0;
+  int64_t next_ping_ms = 0;
+  // Label of the stall reported for the pending ping.
+  std::optional<std::string> stall_label;
+  uint64_t stall_count = 0;
+  StallCallback stall_callback;
+};
+
+MainLoopWatchdog::Scope::Scope(const char* label)
+    : previous_(current_label.exchange(label, std::memory_order_acq_rel)) {}
+
+MainLoopWatchdog::Scope::~Scope() {
+  current_label.store(previous_, std::memory_order_release);
+}
+
+MainLoopWatchdog::MainLoopWatchdog(GMainContext* context)
+    : state_(std::make_shared<State>()) {
+  state_->context =
+      g_main_context_ref(context ? context : g_main_context_default());
+}
+
+MainLoopWatchdog::~MainLoopWatchdog() {
+  Stop();
+  g_main_context_unref(state_->context);
+}
+
+bool MainLoopWatchdog::Start(const Options& options) {
+  if (IsRunning() || options.threshold_ms <= 0 || options.interval_ms <= 0) {
+    return false;
+  }
+
+  state_->options = options;
+  state_->sampling = options.capture_backtrace && InstallSampleHandler();
+  state_->loop_thread = pthread_self();
+  state_->running = true;
+  state_->next_ping_ms = NowMs();
+  thread_ = std::thread(&MainLoopWatchdog::Run, state_);
+  return true;
+}
+
+void MainLoopWatchdog::Stop() {
+  if (!IsRunning()) {
+    return;
+  }
+  {
+    std::lock_guard<std::mutex> lock(state_->mutex);
+    state_->running = false;
+    if (state_->ping) {
+      g_source_destroy(state_->ping);
+      g_source_unref(state_->ping);
+      state_->ping = nullptr;
+    }
+    state_->stall_label.reset();
+  }
+  state_->wakeup.notify_all();
+  thread_.join();
+}
+
+uint64_t MainLoopWatchdog::StallCount() const {
+  std::lock_guard<std::mutex> lock(state_->mutex);
+  return state_->stall_count;
+}
+
+void MainLoopWatchdog::SetStallCallbackForTesting(StallCallback callback) {
+  std::lock_guard<std::mutex> lock(state_->mutex);
+  state_->stall_callback = std::move(callback);
+}
+
+// static
+void MainLoopWatchdog::Run(std::shared_ptr<State> state) {
+  auto on_ping = [](gpointer data) -> gboolean {
+    State& state = **static_cast<std::shared_ptr<State>*>(data);
+    {
+      std::lock_guard<std::mutex> lock(state.mutex);
+      if (state.ping && state.running) {
+        g_source_unref(state.ping);
+        state.ping = nullptr;
+        state.pong_ms = NowMs();
+        state.next_ping_ms = state.pong_ms + state.options.interval_ms;
+        state.loop_thread = pthread_self();
+      }
+    }
+    state.wakeup.notify_all();
+    return G_SOURCE_REMOVE;
+  };
+  auto release_state = [](gpointer data) {
+    delete static_cast<std::shared_ptr<State>*>(data);
+  };
+
+  std::unique_lock<std::mutex> lock(state->mutex);
+  while (state->running) {
+    const int64_t now = NowMs();
+    int64_t wait_ms = state->options.interval_ms;
+
+    if (state->ping) {
+      const int64_t waited_ms = now - state->ping_sent_ms;
+      if (!state->stall_label && waited_ms >= state->options.threshold_ms) {
+        Stall stall;
+        stall.duration_ms = waited_ms;
+        const bool sampling = state->sampling;
+        const pthread_t thread = state->loop_thread;
+        lock.unlock();
+        std::optional<Sample> sample;
+        if (sampling) {
+          sample = TakeSample(thread);
+        }
+        if (sample) {
+          stall.label = std::move(sample->label);
+          stall.backtrace = std::move(sample->backtrace);
+        } else {
+          stall.label = CurrentLabel();
+        }
+        lock.lock();
+        if (!state->running) {
+          break;
+        }
+        state->stall_label = stall.label;
+        ++state->stall_count;
+        StallCallback callback = state->stall_callback;
+        lock.unlock();
+        Report(stall);
+        if (callback) {
+          callback(stall);
+        }
+        lock.lock();
+        continue;
+      }
+      if (!state->stall_label) {
+        wait_ms = state->options.threshold_ms - waited_ms;
+      }
+    } else {
+      if (state->stall_label) {
+        Stall stall;
+        stall.duration_ms = state->pong_ms - state->ping_sent_ms;
+        stall.recovered = true;
+        stall.label = std::move(*state->stall_label);
+        state->stall_label.reset();
+        StallCallback callback = state->stall_callback;
+        lock.unlock();
+        Report(stall);
+        if (callback) {
+          callback(stall);
+        }
+        lock.lock();
+        continue;
+      }
+      if (now >= state->next_ping_ms) {
+        GSource* source = g_idle_source_new();
+        g_source_set_priority(source, G_PRIORITY_HIGH);
+        g_source_set_callback(source, on_ping,
+                              new std::shared_ptr<State>(state),
+                              release_state);
+        state->ping = source;
+        state->ping_sent_ms = now;
+        g_source_attach(source, state->context);
+        wait_ms = state->options.threshold_ms;
+      } else {
+        wait_ms = state->next_ping_ms - now;
+      }
+    }
+
+    state->wakeup.wait_for(lock, std::chrono::milliseconds(wait_ms));
+  }
+}
+
+// static
+void MainLoopWatchdog::Report(const Stall& stall) {
+  const std::string& source = stall.label.empty() ? "unknown" : stall.label;
+  if (stall.recovered) {
+    stall_seconds.Get().Observe(stall.duration_ms / 1000.0);
+    LOG_WARNING(MSGID_MAIN_LOOP_STALL, 2,
+                PMLOGKFV("DURATION_MS", "%lld",
+                         static_cast<long long>(stall.duration_ms)),
+                PMLOGKS("SOURCE", source.c_str()),
+                "Main loop recovered from stall");
+    return;
+  }
+
+  stalls.WithLabel(source).Increment();
+  LOG_WARNING(MSGID_MAIN_LOOP_STALL, 2,
+              PMLOGKFV("WAITED_MS", "%lld",
+                       static_cast<long long>(stall.duration_ms)),
+              PMLOGKS("SOURCE", source.c_str()), "Main loop stalled");
+  for (const std::string& frame : stall.backtrace) {
+    LOG_INFO(MSGID_MAIN_LOOP_STALL, 1, PMLOGKS("FRAME", frame.c_str()), "");
+  }
+}
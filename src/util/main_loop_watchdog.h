@@ -0,0 +1,100 @@
+// Copyright (c) 2021 LG Electronics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+
+#ifndef UTIL_MAIN_LOOP_WATCHDOG_H_
+#define UTIL_MAIN_LOOP_WATCHDOG_H_
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+typedef struct _GMainContext GMainContext;
+
+// Watches a GLib main loop from its own thread. The loop is pinged with a
+// high priority idle source every |interval_ms|; a ping not dispatched
+// within |threshold_ms| means a stall. It is reported right away, with the
+// label of the Scope that is running and, optionally, a backtrace of the
+// loop thread, so a loop that never gets back is reported as well. Once
+// the loop answers, the stall is reported again with its duration. Stalls
+// are logged and counted in the wam_main_loop_stall metrics.
+class MainLoopWatchdog {
+ public:
+  struct Options {
+    int threshold_ms = 250;
+    int interval_ms = 100;
+    bool capture_backtrace = false;
+  };
+
+  struct Stall {
+    // Time waited so far, or the whole duration once |recovered|.
+    int64_t duration_ms = 0;
+    bool recovered = false;
+    std::string label;
+    // Only taken when the stall is detected.
+    std::vector<std::string> backtrace;
+  };
+
+  using StallCallback = std::function<void(const Stall&)>;
+
+  // Labels what the main loop dispatches until the end of the scope;
+  // scopes nest. The watchdog thread reads |label| while the loop is
+  // stalled in the scope, so it has to stay valid at least as long as the
+  // scope, and is best a string literal. Only the backtraces interrupt the
+  // loop thread, with a signal.
+  class Scope {
+   public:
+    explicit Scope(const char* label);
+    ~Scope();
+
+    Scope(const Scope&) = delete;
+    Scope& operator=(const Scope&) = delete;
+
+   private:
+    const char* previous_;
+  };
+
+  // A null |context| is the default main context.
+  explicit MainLoopWatchdog(GMainContext* context = nullptr);
+  ~MainLoopWatchdog();
+
+  MainLoopWatchdog(const MainLoopWatchdog&) = delete;
+  MainLoopWatchdog& operator=(const MainLoopWatchdog&) = delete;
+
+  // Must be called on the thread running the loop.
+  bool Start(const Options& options);
+  void Stop();
+  bool IsRunning() const { return thread_.joinable(); }
+
+  uint64_t StallCount() const;
+  // Called on the watchdog thread when a stall is detected and when the loop
+  // recovers from it.
+  void SetStallCallbackForTesting(StallCallback callback);
+
+ private:
+  struct State;
+
+  static void Run(std::shared_ptr<State> state);
+  static void Report(const Stall& stall);
+
+  std::shared_ptr<State> state_;
+  std::thread thread_;
+};
+
+#endif  // UTIL_MAIN_LOOP_WATCHDOG_H_
@@ -0,0 +1,257 @@
+// Copyright (c) 2021 LG Electronics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+
+#include "metrics_registry.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <charconv>
+#include <cstdio>
+#include <cstring>
+
+namespace {
+
+void AppendSample(std::string_view name,
+                  std::string_view suffix,
+                  const std::string& labels,
+                  std::string_view value,
+                  std::string& out) {
+  out.append(name).append(suffix);
+  if (!labels.empty()) {
+    out.append("{").append(labels).append("}");
+  }
+  out.append(" ").append(value).append("\n");
+}
+
+// Shortest form reading back as |value|.
+std::string FormatDouble(double value) {
+  char buffer[32];
+  auto result = std::to_chars(buffer, buffer + sizeof(buffer), value);
+  return std::string(buffer, result.ptr);
+}
+
+bool WriteAll(int fd, const std::string& text) {
+  size_t written = 0;
+  while (written < text.size()) {
+    ssize_t result = write(fd, text.data() + written, text.size() - written);
+    if (result < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      return false;
+    }
+    written += result;
+  }
+  return true;
+}
+
+bool WriteToSocket(const std::string& path, const std::string& text) {
+  sockaddr_un address{};
+  if (path.size() >= sizeof(address.sun_path)) {
+    return false;
+  }
+  address.sun_family = AF_UNIX;
+  memcpy(address.sun_path, path.c_str(), path.size() + 1);
+
+  int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+  if (fd < 0) {
+    return false;
+  }
+  bool result =
+      !connect(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) &&
+      WriteAll(fd, text);
+  close(fd);
+  return result;
+}
+
+// Written aside and renamed, so that readers never see a partial file.
+bool WriteToFile(const std::string& path, const std::string& text) {
+  const std::string temp_path = path + ".tmp";
+  int fd = open(temp_path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC,
+                0644);
+  if (fd < 0) {
+    return false;
+  }
+  bool result = WriteAll(fd, text);
+  result = close(fd) == 0 && result;
+  if (!result || rename(temp_path.c_str(), path.c_str())) {
+    unlink(temp_path.c_str());
+    return false;
+  }
+  return true;
+}
+
+}  // namespace
+
+MetricsRegistry::Family::Family(std::string_view name,
+                                std::string_view help,
+                                const char* type,
+                                std::string_view label_name)
+    : registry_(MetricsRegistry::Instance()),
+      name_(name),
+      help_(help),
+      type_(type),
+      label_name_(label_name) {
+  std::lock_guard<std::mutex> lock(registry_.mutex_);
+  registry_.families_.push_back(this);
+}
+
+MetricsRegistry::Family::~Family() {
+  std::lock_guard<std::mutex> lock(registry_.mutex_);
+  auto& families = registry_.families_;
+  families.erase(std::remove(families.begin(), families.end(), this),
+                 families.end());
+}
+
+std::string MetricsRegistry::Family::FormatLabel(
+    std::string_view value) const {
+  std::string label = label_name_ + "=\"";
+  for (char c : value) {
+    switch (c) {
+      case '\\':
+        label += "\\\\";
+        break;
+      case '"':
+        label += "\\\"";
+        break;
+      case '\n':
+        label += "\\n";
+        break;
+      default:
+        label += c;
+    }
+  }
+  label += '"';
+  return label;
+}
+
+// static
+MetricsRegistry& MetricsRegistry::Instance() {
+  // Never destroyed, families registered statically outlive main().
+  static MetricsRegistry* registry = new MetricsRegistry();
+  return *registry;
+}
+
+int MetricsRegistry::AddCollector(Collector collector) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  const int id = next_collector_id_++;
+  collectors_.emplace(id, std::move(collector));
+  return id;
+}
+
+void MetricsRegistry::RemoveCollector(int id) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  collectors_.erase(id);
+}
+
+std::string MetricsRegistry::ToPrometheusText() {
+  std::vector<Collector> collectors;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (const auto& [id, collector] : collectors_) {
+      collectors.push_back(collector);
+    }
+  }
+  for (const Collector& collector : collectors) {
+    collector();
+  }
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  std::vector<const Family*> families(families_.begin(), families_.end());
+  std::sort(families.begin(), families.end(),
+            [](const Family* a, const Family* b) {
+              return a->name_ < b->name_;
+            });
+
+  std::string out;
+  for (const Family* family : families) {
+    out.append("# HELP ").append(family->name_).append(" ");
+    for (char c : family->help_) {
+      if (c == '\\') {
+        out += "\\\\";
+      } else if (c == '\n') {
+        out += "\\n";
+      } else {
+        out += c;
+      }
+    }
+    out.append("\n# TYPE ").append(family->name_).append(" ");
+    out.append(family->type_).append("\n");
+    family->WriteFamily(out);
+  }
+  return out;
+}
+
+bool MetricsRegistry::Export(const std::string& path) {
+  const std::string text = ToPrometheusText();
+  struct stat st;
+  if (!stat(path.c_str(), &st) && S_ISSOCK(st.st_mode)) {
+    return WriteToSocket(path, text);
+  }
+  return WriteToFile(path, text);
+}
+
+void MetricCounter::Write(std::string_view name,
+                          const std::string& labels,
+                          std::string& out) const {
+  AppendSample(name, "", labels, std::to_string(Value()), out);
+}
+
+void MetricGauge::Write(std::string_view name,
+                        const std::string& labels,
+                        std::string& out) const {
+  AppendSample(name, "", labels, std::to_string(Value()), out);
+}
+
+MetricHistogram::MetricHistogram(const Bounds* bounds)
+    : bounds_(bounds),
+      buckets_(new std::atomic<uint64_t>[bounds->size() + 1]()) {}
+
+void MetricHistogram::Observe(double value) {
+  const size_t index =
+      std::lower_bound(bounds_->begin(), bounds_->end(), value) -
+      bounds_->begin();
+  buckets_[index].fetch_add(1, std::memory_order_relaxed);
+  double sum = sum_.load(std::memory_order_relaxed);
+  while (!sum_.compare_exchange_weak(sum, sum + value,
+                                     std::memory_order_relaxed)) {
+  }
+  count_.fetch_add(1, std::memory_order_relaxed);
+}
+
+void MetricHistogram::Write(std::string_view name,
+                            const std::string& labels,
+                            std::string& out) const {
+  const std::string prefix = labels.empty() ? labels : labels + ",";
+  uint64_t cumulative = 0;
+  for (size_t i = 0; i <= bounds_->size(); ++i) {
+    cumulative += BucketValue(i);
+    const std::string bound =
+        i < bounds_->size() ? FormatDouble((*bounds_)[i]) : "+Inf";
+    AppendSample(name, "_bucket", prefix + "le=\"" + bound + "\"",
+                 std::to_string(cumulative), out);
+  }
+  AppendSample(name, "_sum", labels, FormatDouble(Sum()), out);
+  // The count follows the buckets so that it never runs behind +Inf.
+  AppendSample(name, "_count", labels, std::to_string(cumulative), out);
+}
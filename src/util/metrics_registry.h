@@ -0,0 +1,248 @@
+// Copyright (c) 2021 LG Electronics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+
+#ifndef UTIL_METRICS_REGISTRY_H_
+#define UTIL_METRICS_REGISTRY_H_
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+// Process wide registry of counters, gauges and histograms, exported in
+// the Prometheus text format. Metrics are families registered statically:
+//
+//   MetricFamily<MetricCounter> app_launches(
+//       "wam_app_launches_total", "Apps launched", "app_id");
+//   app_launches.WithLabel(app_id).Increment();
+//
+// Recording is a relaxed atomic update and never takes a lock. Looking up
+// or adding a label value does, so hot paths should keep the reference
+// WithLabel() returns; children are never freed while the family lives.
+class MetricsRegistry {
+ public:
+  class Family {
+   public:
+    Family(const Family&) = delete;
+    Family& operator=(const Family&) = delete;
+
+    const std::string& Name() const { return name_; }
+
+   protected:
+    Family(std::string_view name,
+           std::string_view help,
+           const char* type,
+           std::string_view label_name);
+    virtual ~Family();
+
+    // Appends the samples of the family, called with the registry locked.
+    virtual void WriteFamily(std::string& out) const = 0;
+    bool HasLabel() const { return !label_name_.empty(); }
+    // Formats `label_name="value"` with |value| escaped.
+    std::string FormatLabel(std::string_view value) const;
+
+    MetricsRegistry& registry_;
+
+   private:
+    friend class MetricsRegistry;
+
+    const std::string name_;
+    const std::string help_;
+    const char* const type_;
+    const std::string label_name_;
+  };
+
+  using Collector = std::function<void()>;
+
+  static MetricsRegistry& Instance();
+
+  MetricsRegistry(const MetricsRegistry&) = delete;
+  MetricsRegistry& operator=(const MetricsRegistry&) = delete;
+
+  // Collectors update gauges derived from other state; they run on the
+  // exporting thread right before every export.
+  int AddCollector(Collector collector);
+  void RemoveCollector(int id);
+
+  std::string ToPrometheusText();
+  // Sends the text to the UNIX stream socket at |path| if there is one,
+  // otherwise replaces the file at |path|.
+  bool Export(const std::string& path);
+
+  // Holds the lock label lookups and exports take.
+  std::unique_lock<std::mutex> LockForTesting() {
+    return std::unique_lock<std::mutex>(mutex_);
+  }
+
+ private:
+  template <class T>
+  friend class MetricFamily;
+
+  MetricsRegistry() = default;
+
+  std::mutex mutex_;
+  std::vector<Family*> families_;
+  std::map<int, Collector> collectors_;
+  int next_collector_id_ = 0;
+};
+
+class MetricCounter {
+ public:
+  void Increment(uint64_t delta = 1) {
+    value_.fetch_add(delta, std::memory_order_relaxed);
+  }
+  uint64_t Value() const { return value_.load(std::memory_order_relaxed); }
+
+  void Write(std::string_view name,
+             const std::string& labels,
+             std::string& out) const;
+
+ private:
+  std::atomic<uint64_t> value_{0};
+};
+
+class MetricGauge {
+ public:
+  void Set(int64_t value) { value_.store(value, std::memory_order_relaxed); }
+  void Add(int64_t delta) {
+    value_.fetch_add(delta, std::memory_order_relaxed);
+  }
+  int64_t Value() const { return value_.load(std::memory_order_relaxed); }
+
+  void Write(std::string_view name,
+             const std::string& labels,
+             std::string& out) const;
+
+ private:
+  std::atomic<int64_t> value_{0};
+};
+
+// Histogram with fixed upper bucket bounds, shared by all the children of
+// a family.
+class MetricHistogram {
+ public:
+  using Bounds = std::vector<double>;
+
+  explicit MetricHistogram(const Bounds* bounds);
+
+  void Observe(double value);
+  uint64_t Count() const { return count_.load(std::memory_order_relaxed); }
+  double Sum() const { return sum_.load(std::memory_order_relaxed); }
+  // Samples up to the |index|th bound, not cumulative.
+  uint64_t BucketValue(size_t index) const {
+    return buckets_[index].load(std::memory_order_relaxed);
+  }
+
+  void Write(std::string_view name,
+             const std::string& labels,
+             std::string& out) const;
+
+ private:
+  const Bounds* bounds_;
+  // One more than |bounds_| for the values above the last bound.
+  std::unique_ptr<std::atomic<uint64_t>[]> buckets_;
+  std::atomic<uint64_t> count_{0};
+  std::atomic<double> sum_{0};
+};
+
+template <class T>
+class MetricFamily : public MetricsRegistry::Family {
+ public:
+  // Families without |label_name| have one child, Get(). Histogram
+  // families take their bucket bounds with the second constructor.
+  MetricFamily(std::string_view name,
+               std::string_view help,
+               std::string_view label_name = {})
+      : Family(name, help, TypeName(), label_name), unlabeled_(MakeChild()) {}
+
+  MetricFamily(std::string_view name,
+               std::string_view help,
+               std::string_view label_name,
+               MetricHistogram::Bounds bounds)
+      : Family(name, help, TypeName(), label_name),
+        bounds_(std::move(bounds)),
+        unlabeled_(MakeChild()) {}
+
+  ~MetricFamily() override = default;
+
+  T& Get() { return *unlabeled_; }
+
+  T& WithLabel(std::string_view value) {
+    std::lock_guard<std::mutex> lock(registry_.mutex_);
+    auto found = children_.find(value);
+    if (found == children_.end()) {
+      found = children_.emplace(std::string(value), MakeChild()).first;
+    }
+    return *found->second;
+  }
+
+  // Must not race with recording on the child of |value|.
+  void RemoveLabel(std::string_view value) {
+    std::lock_guard<std::mutex> lock(registry_.mutex_);
+    auto found = children_.find(value);
+    if (found != children_.end()) {
+      children_.erase(found);
+    }
+  }
+
+ protected:
+  void WriteFamily(std::string& out) const override {
+    if (!HasLabel()) {
+      unlabeled_->Write(Name(), std::string(), out);
+    }
+    for (const auto& [value, child] : children_) {
+      child->Write(Name(), FormatLabel(value), out);
+    }
+  }
+
+ private:
+  static constexpr const char* TypeName() {
+    if constexpr (std::is_same_v<T, MetricCounter>) {
+      return "counter";
+    } else if constexpr (std::is_same_v<T, MetricGauge>) {
+      return "gauge";
+    } else {
+      return "histogram";
+    }
+  }
+
+  std::unique_ptr<T> MakeChild() const {
+    if constexpr (std::is_same_v<T, MetricHistogram>) {
+      return std::make_unique<T>(&bounds_);
+    } else {
+      return std::make_unique<T>();
+    }
+  }
+
+  const MetricHistogram::Bounds bounds_;
+  const std::unique_ptr<T> unlabeled_;
+  std::map<std::string, std::unique_ptr<T>, std::less<>> children_;
+};
+
+using CounterFamily = MetricFamily<MetricCounter>;
+using GaugeFamily = MetricFamily<MetricGauge>;
+using HistogramFamily = MetricFamily<MetricHistogram>;
+
+#endif  // UTIL_METRICS_REGISTRY_H_
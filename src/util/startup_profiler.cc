@@ -0,0 +1,209 @@
+// Copyright (c) 2021 LG Electronics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#include "startup_profiler.h"
+
+#include <chrono>
+#include <utility>
+
+#include <glib.h>
+#include <json/json.h>
+
+#include "log_manager.h"
+#include "main_loop_watchdog.h"
+
+namespace {
+
+int64_t SteadyClockUs() {
+  return std::chrono::duration_cast<std::chrono::microseconds>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+}  // namespace
+
+struct StartupProfiler::IdleTasks::State {};
+
+StartupProfiler::Scope::Scope(const char* name)
+    : id_(StartupProfiler::Instance()->Begin(name)) {}
+
+StartupProfiler::Scope::~Scope() {
+  StartupProfiler::Instance()->End(id_);
+}
+
+StartupProfiler::IdleTasks::IdleTasks() : state_(std::make_shared<State>()) {}
+
+StartupProfiler::IdleTasks::~IdleTasks() = default;
+
+void StartupProfiler::IdleTasks::Cancel() {
+  // The phases posted so far refer to the old state.
+  state_ = std::make_shared<State>();
+}
+
+// static
+StartupProfiler* StartupProfiler::Instance() {
+  static StartupProfiler* instance = new StartupProfiler();
+  return instance;
+}
+
+StartupProfiler::StartupProfiler(GMainContext* context)
+    : context_(
+          g_main_context_ref(context ? context : g_main_context_default())),
+      clock_(&SteadyClockUs) {}
+
+StartupProfiler::~StartupProfiler() {
+  if (idle_source_) {
+    g_source_destroy(idle_source_);
+  }
+  g_main_context_unref(context_);
+}
+
+void StartupProfiler::Start() {
+  started_ = true;
+  complete_ = false;
+  critical_path_us_ = -1;
+  depth_ = 0;
+  phases_.clear();
+  origin_us_ = clock_();
+}
+
+StartupProfiler::PhaseId StartupProfiler::Begin(const char* name) {
+  if (!IsRecording()) {
+    return kInvalidPhase;
+  }
+
+  Phase phase;
+  phase.name = name;
+  phase.start_us = clock_() - origin_us_;
+  phase.depth = depth_++;
+  phase.idle = in_idle_phase_;
+  phases_.push_back(std::move(phase));
+  return phases_.size() - 1;
+}
+
+void StartupProfiler::End(PhaseId id) {
+  if (id == kInvalidPhase || id >= phases_.size() ||
+      phases_[id].duration_us >= 0) {
+    return;
+  }
+
+  Phase& phase = phases_[id];
+  phase.duration_us = clock_() - origin_us_ - phase.start_us;
+  --depth_;
+}
+
+void StartupProfiler::CriticalPathDone() {
+  if (!IsRecording() || critical_path_us_ >= 0) {
+    return;
+  }
+
+  critical_path_us_ = clock_() - origin_us_;
+  MaybeComplete();
+}
+
+void StartupProfiler::PostIdlePhase(const char* name,
+                                    std::function<void()> task,
+                                    IdleTasks* tasks) {
+  IdlePhase phase{name, std::move(task), tasks != nullptr, {}};
+  if (tasks) {
+    phase.owner = tasks->state_;
+  }
+  idle_phases_.push_back(std::move(phase));
+
+  if (!idle_source_) {
+    idle_source_ = g_idle_source_new();
+    g_source_set_callback(idle_source_, &StartupProfiler::RunIdlePhase, this,
+                          nullptr);
+    g_source_attach(idle_source_, context_);
+    g_source_unref(idle_source_);
+  }
+}
+
+bool StartupProfiler::IsRecording() const {
+  return started_ && !complete_;
+}
+
+Json::Value StartupProfiler::ToJson() const {
+  Json::Value phases(Json::arrayValue);
+  for (const Phase& phase : phases_) {
+    Json::Value item;
+    item["name"] = phase.name;
+    item["stage"] = phase.idle ? "idle" : "critical";
+    item["depth"] = phase.depth;
+    item["startUs"] = static_cast<Json::Int64>(phase.start_us);
+    item["durationUs"] = static_cast<Json::Int64>(phase.duration_us);
+    phases.append(std::move(item));
+  }
+
+  Json::Value result;
+  result["complete"] = complete_;
+  result["criticalPathUs"] = static_cast<Json::Int64>(critical_path_us_);
+  result["phases"] = std::move(phases);
+  return result;
+}
+
+void StartupProfiler::SetClockForTesting(Clock clock) {
+  clock_ = clock ? clock : &SteadyClockUs;
+}
+
+// static
+int StartupProfiler::RunIdlePhase(void* data) {
+  auto* profiler = static_cast<StartupProfiler*>(data);
+  IdlePhase phase = std::move(profiler->idle_phases_.front());
+  profiler->idle_phases_.pop_front();
+
+  if (!phase.owned || !phase.owner.expired()) {
+    MainLoopWatchdog::Scope scope(phase.name);
+    profiler->in_idle_phase_ = true;
+    const PhaseId id = profiler->Begin(phase.name);
+    phase.task();
+    profiler->End(id);
+    profiler->in_idle_phase_ = false;
+  }
+
+  if (!profiler->idle_phases_.empty()) {
+    return G_SOURCE_CONTINUE;
+  }
+  profiler->idle_source_ = nullptr;
+  profiler->MaybeComplete();
+  return G_SOURCE_REMOVE;
+}
+
+void StartupProfiler::Log() const {
+  LOG_INFO(MSGID_STARTUP_PROFILE, 1,
+           PMLOGKFV("CRITICAL_PATH_US", "%lld",
+                    static_cast<long long>(critical_path_us_)),
+           "Startup complete");
+  for (const Phase& phase : phases_) {
+    LOG_INFO(MSGID_STARTUP_PROFILE, 5, PMLOGKS("PHASE", phase.name.c_str()),
+             PMLOGKS("STAGE", phase.idle ? "idle" : "critical"),
+             PMLOGKFV("DEPTH", "%d", phase.depth),
+             PMLOGKFV("START_US", "%lld",
+                      static_cast<long long>(phase.start_us)),
+             PMLOGKFV("DURATION_US", "%lld",
+                      static_cast<long long>(phase.duration_us)),
+             "");
+  }
+}
+
+void StartupProfiler::MaybeComplete() {
+  if (!IsRecording() || critical_path_us_ < 0 || !idle_phases_.empty()) {
+    return;
+  }
+
+  complete_ = true;
+  Log();
+}
@@ -0,0 +1,155 @@
+// Copyright (c) 2021 LG Electronics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef UTIL_STARTUP_PROFILER_H_
+#define UTIL_STARTUP_PROFILER_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+typedef struct _GMainContext GMainContext;
+typedef struct _GSource GSource;
+
+namespace Json {
+class Value;
+}
+
+// Records how long each phase of the WAM startup takes. The startup has two
+// stages: the critical path, which ends once WAM can accept the first
+// launch, and the idle phases, which are posted to run when the main loop
+// has nothing else to do. The profile is logged once both are done, and
+// recording stops then. Must be used on the main thread.
+class StartupProfiler {
+ public:
+  // Monotonic time in microseconds.
+  using Clock = int64_t (*)();
+  using PhaseId = size_t;
+
+  struct Phase {
+    std::string name;
+    // Since the profiler was started.
+    int64_t start_us = 0;
+    int64_t duration_us = -1;
+    // Number of phases the phase is nested in.
+    int depth = 0;
+    bool idle = false;
+  };
+
+  // Records the phase |name| until the end of the scope; scopes nest.
+  class Scope {
+   public:
+    explicit Scope(const char* name);
+    ~Scope();
+
+    Scope(const Scope&) = delete;
+    Scope& operator=(const Scope&) = delete;
+
+   private:
+    PhaseId id_;
+  };
+
+  // Drops the idle phases posted with it that haven't run yet once it is
+  // cancelled or destroyed, so their owner can go away before the main
+  // loop gets idle.
+  class IdleTasks {
+   public:
+    IdleTasks();
+    ~IdleTasks();
+
+    IdleTasks(const IdleTasks&) = delete;
+    IdleTasks& operator=(const IdleTasks&) = delete;
+
+    void Cancel();
+
+   private:
+    friend class StartupProfiler;
+    struct State;
+
+    std::shared_ptr<State> state_;
+  };
+
+  static constexpr PhaseId kInvalidPhase = static_cast<PhaseId>(-1);
+
+  // The profiler of the default main context. Never destroyed.
+  static StartupProfiler* Instance();
+
+  // A null |context| is the default main context.
+  explicit StartupProfiler(GMainContext* context = nullptr);
+  ~StartupProfiler();
+
+  StartupProfiler(const StartupProfiler&) = delete;
+  StartupProfiler& operator=(const StartupProfiler&) = delete;
+
+  // Starts recording. Phases outside of Start() and the end of the startup
+  // aren't recorded, e.g. the configuration being reloaded later.
+  void Start();
+  // Returns kInvalidPhase if nothing is recorded.
+  PhaseId Begin(const char* name);
+  void End(PhaseId id);
+  // WAM can accept launches from now on.
+  void CriticalPathDone();
+
+  // Runs |task| as the phase |name| once the main loop is idle. The task
+  // runs also if the profiler doesn't record.
+  void PostIdlePhase(const char* name,
+                     std::function<void()> task,
+                     IdleTasks* tasks = nullptr);
+
+  bool IsRecording() const;
+  bool IsComplete() const { return complete_; }
+  const std::vector<Phase>& Phases() const { return phases_; }
+  // Duration of the critical path, or -1 if it hasn't ended yet.
+  int64_t CriticalPathUs() const { return critical_path_us_; }
+  Json::Value ToJson() const;
+
+  void SetClockForTesting(Clock clock);
+
+ private:
+  struct IdlePhase {
+    const char* name;
+    std::function<void()> task;
+    // Phases posted without IdleTasks always run.
+    bool owned;
+    std::weak_ptr<IdleTasks::State> owner;
+  };
+
+  // Runs one idle phase per dispatch, so that the loop handles the events
+  // which came in meanwhile before the next one.
+  static int RunIdlePhase(void* data);
+
+  void Log() const;
+  void MaybeComplete();
+
+  GMainContext* context_;
+  Clock clock_;
+  int64_t origin_us_ = 0;
+  bool started_ = false;
+  bool complete_ = false;
+  bool in_idle_phase_ = false;
+  int depth_ = 0;
+  int64_t critical_path_us_ = -1;
+  std::vector<Phase> phases_;
+  std::deque<IdlePhase> idle_phases_;
+  // Attached while |idle_phases_| isn't empty.
+  GSource* idle_source_ = nullptr;
+};
+
+#endif  // UTIL_STARTUP_PROFILER_H_
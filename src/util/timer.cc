@@ -18,7 +18,10 @@
 
 #include <glib.h>
 
+#include "main_loop_watchdog.h"
+
 static int TimeoutCallback(void* data) {
+  MainLoopWatchdog::Scope scope("Timer");
   Timer* timer = static_cast<Timer*>(data);
   bool is_repeating = timer->IsRepeating();
   timer->HandleCallback();
@@ -26,6 +29,7 @@ static int TimeoutCallback(void* data) {
 }
 
 static int TimeoutCallbackDestroy(void* data) {
+  MainLoopWatchdog::Scope scope("Timer");
   Timer* timer = static_cast<Timer*>(data);
   timer->HandleCallback();
   delete timer;
@@ -18,41 +18,35 @@
 
 #include <glib.h>
 
-namespace {
-
-std::string GetSubString(const std::string& str,
-                         std::size_t start,
-                         std::size_t end) {
-  return str.substr(
-      start, end == std::string::npos ? str.size() - start : end - start);
-}
-
-}  // namespace
-
 namespace wam {
 
-Url::Url(const std::string& uri) {
-  ParseUri(uri);
+Url::Url(const std::string& uri) : spec_(uri), parsed_size_(uri.size()) {
+  ParseUri();
 }
 
 void Url::SetQuery(const UrlQuery& query) {
-  query_.clear();
+  spec_.resize(parsed_size_);
   for (const auto& q : query) {
     gchar* escaped_key = g_uri_escape_string(q.first.c_str(), nullptr, true);
     gchar* escaped_val = g_uri_escape_string(q.second.c_str(), nullptr, true);
-    query_ += query_.empty() ? '?' : '&';
-    query_ += std::string(escaped_key) + "=" + escaped_val;
+    spec_ += spec_.size() == parsed_size_ ? '?' : '&';
+    spec_.append(escaped_key).append("=").append(escaped_val);
     g_free(escaped_key);
     g_free(escaped_val);
   }
+  query_ = Range{parsed_size_, spec_.size() - parsed_size_};
 }
 
 std::string Url::ToString() const {
-  return uri_ + query_ + fragment_;
+  std::string result;
+  result.reserve(base_.size + query_.size + fragment_.size);
+  result.append(View(base_)).append(Query()).append(Fragment());
+  return result;
 }
 
 std::string Url::ToLocalFile() const {
-  g_autofree gchar* cpath = g_filename_from_uri(uri_.c_str(), nullptr, nullptr);
+  const std::string base(View(base_));
+  g_autofree gchar* cpath = g_filename_from_uri(base.c_str(), nullptr, nullptr);
   return cpath ? std::string(cpath) : std::string();
 }
 
@@ -62,7 +56,7 @@ Url Url::FromLocalFile(const std::string& path) {
 }
 
 bool Url::IsLocalFile() const {
-  return scheme_ == "file";
+  return Scheme() == "file";
 }
 
 std::string Url::FileName() const {
@@ -77,10 +71,15 @@ std::string Url::FileName() const {
   return local.substr(found + 1, local.size() - found);
 }
 
-void Url::ParseUri(const std::string& uri) {
+Url::Range Url::MakeRange(size_t begin, size_t end, size_t size) {
+  return Range{begin, (end == std::string::npos ? size : end) - begin};
+}
+
+void Url::ParseUri() {
+  const std::string& uri = spec_;
   auto scheme_delimiter = uri.find(':');
   if (scheme_delimiter != std::string::npos) {
-    scheme_ = uri.substr(0, scheme_delimiter);
+    scheme_ = Range{0, scheme_delimiter};
   }
 
   auto authority_start = uri.find("//");
@@ -96,36 +95,34 @@ void Url::ParseUri(const std::string& uri) {
       host_start = user_info_end + 1;
     }
     auto host_end = uri.find_first_of(":/?#", host_start);
-    if (host_start != std::string::npos) {
-      host_ = GetSubString(uri, host_start, host_end);
-    }
+    host_ = MakeRange(host_start, host_end, uri.size());
     if (host_end != std::string::npos && uri[host_end] == ':') {
-      port_ = GetSubString(uri, host_end + 1, authority_end);
+      port_ = MakeRange(host_end + 1, authority_end, uri.size());
     }
   }
 
   auto path_end = uri.find_first_of("?#", authority_end);
-  // Save part of the original uri without query and fragment.
-  uri_ = GetSubString(uri, 0, path_end);
+  // Part of the original uri without query and fragment.
+  base_ = MakeRange(0, path_end, uri.size());
 
   if (authority_start == std::string::npos) {
     if (uri.size() > scheme_delimiter) {
-      path_ = uri.substr(scheme_delimiter + 1, uri.size() - scheme_delimiter);
+      path_ = MakeRange(scheme_delimiter + 1, uri.size(), uri.size());
     }
   } else if (authority_end != std::string::npos) {
     if (uri[authority_end] == '/') {
-      path_ = GetSubString(uri, authority_end, path_end);
+      path_ = MakeRange(authority_end, path_end, uri.size());
     }
 
     auto query_start = uri.find("?", authority_end);
     if (query_start != std::string::npos) {
       auto query_end = uri.find("#", query_start);
-      query_ = GetSubString(uri, query_start, query_end);
+      query_ = MakeRange(query_start, query_end, uri.size());
     }
 
     auto fragment_start = uri.find("#", authority_end);
     if (fragment_start != std::string::npos) {
-      fragment_ = GetSubString(uri, fragment_start, uri.size());
+      fragment_ = MakeRange(fragment_start, uri.size(), uri.size());
     }
   }
 }
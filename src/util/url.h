@@ -17,24 +17,28 @@
 #ifndef UTIL_URL_H_
 #define UTIL_URL_H_
 
+#include <cstddef>
 #include <string>
+#include <string_view>
 #include <utility>
 #include <vector>
 
 namespace wam {
 
+// Keeps the parsed uri in a single buffer; the components are views into it
+// and stay valid as long as the Url is alive and SetQuery() isn't called.
 class Url {
  public:
   typedef std::vector<std::pair<std::string, std::string>> UrlQuery;
   explicit Url(const std::string& uri);
   ~Url() = default;
 
-  std::string Scheme() const { return scheme_; }
-  std::string Host() const { return host_; }
-  std::string Port() const { return port_; }
-  std::string Path() const { return path_; }
-  std::string Query() const { return query_; }
-  std::string Fragment() const { return fragment_; }
+  std::string_view Scheme() const { return View(scheme_); }
+  std::string_view Host() const { return View(host_); }
+  std::string_view Port() const { return View(port_); }
+  std::string_view Path() const { return View(path_); }
+  std::string_view Query() const { return View(query_); }
+  std::string_view Fragment() const { return View(fragment_); }
 
   void SetQuery(const UrlQuery& query);
   std::string ToString() const;
@@ -44,14 +48,30 @@ class Url {
   std::string FileName() const;
 
  private:
-  void ParseUri(const std::string& uri);
-  std::string uri_;
-  std::string scheme_;
-  std::string host_;
-  std::string port_;
-  std::string path_;
-  std::string query_;
-  std::string fragment_;
+  // Offsets rather than views, so copies of the Url don't need fixing up.
+  struct Range {
+    size_t begin = 0;
+    size_t size = 0;
+  };
+
+  static Range MakeRange(size_t begin, size_t end, size_t size);
+  std::string_view View(Range range) const {
+    return std::string_view(spec_).substr(range.begin, range.size);
+  }
+
+  void ParseUri();
+
+  // The parsed uri, followed by the query set with SetQuery() if any.
+  std::string spec_;
+  size_t parsed_size_ = 0;
+  // Part of the uri without query and fragment.
+  Range base_;
+  Range scheme_;
+  Range host_;
+  Range port_;
+  Range path_;
+  Range query_;
+  Range fragment_;
 };
 
 }  // namespace wam
@@ -18,11 +18,11 @@
 
 #include <unistd.h>
 
+#include <algorithm>
 #include <cstdlib>
 #include <filesystem>
 #include <fstream>
 #include <limits>
-#include <regex>
 #include <sstream>
 #include <string>
 #include <vector>
@@ -35,6 +35,20 @@
 
 #include "bcp47.h"
 
+namespace {
+
+// \w of the regular expressions the parsers below replace.
+bool IsWordChar(char c) {
+  return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') ||
+         (c >= '0' && c <= '9') || c == '_';
+}
+
+bool IsDigit(char c) {
+  return c >= '0' && c <= '9';
+}
+
+}  // namespace
+
 namespace util {
 
 std::string GetString(const char* value) {
@@ -53,7 +67,8 @@ std::vector<std::string> GetErrorPagePaths(
   fs::path error_page_path(error_page_location);
   std::string filename = error_page_path.filename().string();
   std::string search_path = error_page_path.parent_path().string();
-  auto bcp47_pieces = BCP47::FromString(language);
+  BCP47::Pieces pieces;
+  const bool has_pieces = BCP47::Parse(language, pieces);
 
   // search order:
   // searchPath/resources/<language>/<script>/<region>/html/fileName
@@ -64,31 +79,31 @@ std::vector<std::string> GetErrorPagePaths(
 
   std::vector<std::string> result;
   result.reserve(5);
-  if (bcp47_pieces) {
-    if (bcp47_pieces->HasScript()) {
+  if (has_pieces) {
+    if (!pieces.script.empty()) {
       std::stringstream ss;
       ss << search_path << "/resources/";
-      ss << bcp47_pieces->Language() << "/";
-      ss << bcp47_pieces->Script();
+      ss << pieces.language << "/";
+      ss << pieces.script;
 
-      if (bcp47_pieces->HasRegion()) {
-        ss << "/" << bcp47_pieces->Region();
+      if (!pieces.region.empty()) {
+        ss << "/" << pieces.region;
       }
 
       ss << "/html/" << filename;
       result.emplace_back(ss.str());
     }
-    if (bcp47_pieces->HasRegion()) {
+    if (!pieces.region.empty()) {
       std::stringstream ss;
       ss << search_path << "/resources/";
-      ss << bcp47_pieces->Language() << "/";
-      ss << bcp47_pieces->Region() << "/html/";
+      ss << pieces.language << "/";
+      ss << pieces.region << "/html/";
       ss << filename;
       result.emplace_back(ss.str());
     }
     std::stringstream ss;
     ss << search_path << "/resources/";
-    ss << bcp47_pieces->Language() << "/html/";
+    ss << pieces.language << "/html/";
     ss << filename;
     result.emplace_back(ss.str());
   }
@@ -99,27 +114,61 @@ std::vector<std::string> GetErrorPagePaths(
 }
 
 std::string GetHostname(const std::string& url) {
-  if (url.empty()) {
-    return std::string();
-  }
-
-  // source https://datatracker.ietf.org/doc/html/rfc3986#appendix-B
+  return std::string(ParseHostname(url));
+}
 
-  std::regex rfc3986_regex(
-      R"(^(([^:\/?#]+):)?(\/\/([^\/?#]*))?([^?#]*)(\?([^#]*))?(#(.*))?)");
-  std::regex authority_regex(R"(^(?:[\w\:]+[@])?([\w.]+)(?:[:])?(?:[0-9]+)?)");
-  std::smatch matches;
+std::string_view ParseHostname(std::string_view url) {
+  // Follows the regular expression of
+  // https://datatracker.ietf.org/doc/html/rfc3986#appendix-B
+  // ^(([^:/?#]+):)?(//([^/?#]*))?([^?#]*)(\?([^#]*))?(#(.*))?
+  // where the fragment can't contain line terminators.
+  const size_t fragment = url.find('#');
+  if (fragment != std::string_view::npos &&
+      url.find_first_of("\r\n", fragment) != std::string_view::npos) {
+    return {};
+  }
 
-  if (!std::regex_match(url, matches, rfc3986_regex)) {
-    return std::string();
+  const size_t scheme_end = url.find_first_of(":/?#");
+  if (scheme_end != 0 && scheme_end != std::string_view::npos &&
+      url[scheme_end] == ':') {
+    url.remove_prefix(scheme_end + 1);
+  }
+  if (url.substr(0, 2) != "//") {
+    return {};
+  }
+  url.remove_prefix(2);
+  std::string_view authority = url.substr(0, url.find_first_of("/?#"));
+
+  // Then matches the authority with
+  // ^(?:[\w:]+@)?([\w.]+):?[0-9]*$
+  const size_t at = authority.find('@');
+  if (at != std::string_view::npos) {
+    std::string_view user_info = authority.substr(0, at);
+    if (user_info.empty() ||
+        !std::all_of(user_info.cbegin(), user_info.cend(),
+                     [](char c) { return IsWordChar(c) || c == ':'; })) {
+      return {};
+    }
+    authority.remove_prefix(at + 1);
   }
 
-  std::string authority = matches[4];
-  if (!std::regex_match(authority, matches, authority_regex)) {
-    return std::string();
+  const size_t host_size =
+      std::find_if_not(authority.cbegin(), authority.cend(),
+                       [](char c) { return IsWordChar(c) || c == '.'; }) -
+      authority.cbegin();
+  std::string_view host = authority.substr(0, host_size);
+  std::string_view port = authority.substr(host_size);
+  if (host.empty()) {
+    return {};
+  }
+  if (!port.empty() && port.front() == ':') {
+    port.remove_prefix(1);
+  }
+  if (!std::all_of(port.cbegin(), port.cend(), IsDigit)) {
+    return {};
   }
 
-  return matches[1];
+  return host;
 }
 
 bool DoesPathExist(const std::string& path) {
@@ -18,6 +18,7 @@
 #define UTIL_UTILS_H_
 
 #include <string>
+#include <string_view>
 #include <vector>
 
 #include <json/json.h>
@@ -30,6 +31,8 @@ std::vector<std::string> GetErrorPagePaths(
     const std::string& error_page_location,
     const std::string& language = {});
 std::string GetHostname(const std::string& url);
+// Same as GetHostname(), the result points into |url|.
+std::string_view ParseHostname(std::string_view url);
 
 bool DoesPathExist(const std::string& path);
 std::string ReadFile(const std::string& path);
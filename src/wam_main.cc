@@ -26,11 +26,18 @@
 #include "log_manager.h"
 #include "platform/platform_factory.h"
 #include "platform_module_factory_impl.h"
+#include "startup_profiler.h"
 #include "utils.h"
+#include "web_app_factory_manager_impl.h"
 #include "web_app_manager.h"
 #include "web_app_manager_service_luna.h"
 
+// From the start of main() until the runtime asks for the browser client.
+static StartupProfiler::PhaseId webos_main_phase =
+    StartupProfiler::kInvalidPhase;
+
 static void ChangeUserIDGroupID() {
+  StartupProfiler::Scope scope("ChangeUserIDGroupID");
   std::string uid, gid;
   uid = util::GetEnvVar("WAM_UID");
   gid = util::GetEnvVar("WAM_GID");
@@ -59,14 +66,22 @@ static void ChangeUserIDGroupID() {
 }
 
 static void StartWebAppManager() {
+  StartupProfiler::Scope scope("StartWebAppManager");
   ChangeUserIDGroupID();
 
   WebAppManagerServiceLuna* luna_service = WebAppManagerServiceLuna::Instance();
   assert(luna_service);
+  StartupProfiler::PhaseId registration =
+      StartupProfiler::Instance()->Begin("RegisterLunaService");
   [[maybe_unused]] bool result = luna_service->StartService();
   assert(result);
+  StartupProfiler::Instance()->End(registration);
   WebAppManager::Instance()->SetPlatformModules(
       std::make_unique<PlatformModuleFactoryImpl>());
+
+  // A launch coming first loads the plugin it needs on demand.
+  StartupProfiler::Instance()->PostIdlePhase(
+      "PreloadPlugins", [] { WebAppFactoryManagerImpl::Instance(); });
 }
 
 class WebOSMainDelegateWAM : public webos::WebOSMainDelegate {
@@ -75,10 +90,19 @@ class WebOSMainDelegateWAM : public webos::WebOSMainDelegate {
     webos::Runtime::GetInstance()->SetPlatformFactory(
         std::make_unique<PlatformFactory>());
   }
-  void AboutToCreateContentBrowserClient() override { StartWebAppManager(); }
+  void AboutToCreateContentBrowserClient() override {
+    StartupProfiler* profiler = StartupProfiler::Instance();
+    profiler->End(webos_main_phase);
+    StartWebAppManager();
+    profiler->CriticalPathDone();
+  }
 };
 
 int main(int argc, const char** argv) {
+  StartupProfiler* profiler = StartupProfiler::Instance();
+  profiler->Start();
+  webos_main_phase = profiler->Begin("WebOSMain");
+
   WebOSMainDelegateWAM delegate;
   webos::WebOSMain webos_main(&delegate);
   return webos_main.Run(argc, argv);
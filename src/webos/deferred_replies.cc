@@ -0,0 +1,194 @@
+// Copyright (c) 2021 LG Electronics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+
+#include "deferred_replies.h"
+
+#include <map>
+#include <memory>
+#include <utility>
+
+#include <glib.h>
+#include <json/json.h>
+#include <luna-service2/lunaservice.h>
+
+#include "file_io_service.h"
+#include "log_manager.h"
+#include "utils.h"
+
+const char DeferredReplies::kBusyReply[] =
+    R"({"returnValue":false,"errorText":"Too many pending requests"})";
+const char DeferredReplies::kTimeoutReply[] =
+    R"({"returnValue":false,"errorText":"Request timed out"})";
+
+struct DeferredReplies::State {
+  struct Pending {
+    LSHandle* handle;
+    LSMessage* message;
+    ServiceMetrics::CallId call;
+    GSource* timeout;
+    Sent sent;
+    // The work of Reply::Compute(), skipped if the request is answered
+    // before it starts.
+    std::unique_ptr<FileIoService::TaskGroup> work;
+  };
+
+  GMainContext* context;
+  Bus bus;
+  size_t max_in_flight = kDefaultMaxInFlight;
+  int timeout_ms = kDefaultTimeoutMs;
+  std::map<Id, Pending> pending;
+  Id next_id = 1;
+  // Started with the first deferred work.
+  std::unique_ptr<FileIoService> worker;
+};
+
+// static
+DeferredReplies::Bus DeferredReplies::Bus::Ls2() {
+  Bus bus;
+  bus.ref = [](LSMessage* message) { LSMessageRef(message); };
+  bus.unref = [](LSMessage* message) { LSMessageUnref(message); };
+  bus.reply = [](LSHandle* handle, LSMessage* message,
+                 const std::string& payload) {
+    LSError ls_error;
+    LSErrorInit(&ls_error);
+    const bool sent =
+        LSMessageReply(handle, message, payload.c_str(), &ls_error);
+    if (!sent) {
+      LOG_WARNING(MSGID_LUNA_API, 0, "Failed to send deferred reply: %s",
+                  ls_error.message);
+    }
+    LSErrorFree(&ls_error);
+    return sent;
+  };
+  return bus;
+}
+
+bool DeferredReplies::Reply::Send(const Json::Value& reply) const {
+  std::shared_ptr<State> state = state_.lock();
+  return state && Finish(*state, id_, util::JsonToString(reply),
+                         ServiceMetrics::Succeeded(reply));
+}
+
+void DeferredReplies::Reply::Compute(
+    std::function<Json::Value()> work) const {
+  std::shared_ptr<State> state = state_.lock();
+  if (!state) {
+    return;
+  }
+  auto found = state->pending.find(id_);
+  if (found == state->pending.end()) {
+    return;
+  }
+  if (!state->worker) {
+    state->worker = std::make_unique<FileIoService>(state->context);
+  }
+  std::unique_ptr<FileIoService::TaskGroup>& group = found->second.work;
+  if (!group) {
+    group = std::make_unique<FileIoService::TaskGroup>();
+  }
+  state->worker->PostTaskAndReplyWithResult<Json::Value>(
+      std::move(work),
+      [reply = *this](Json::Value result) { reply.Send(result); },
+      group.get());
+}
+
+DeferredReplies::DeferredReplies(GMainContext* context, Bus bus)
+    : state_(std::make_shared<State>()) {
+  state_->context =
+      g_main_context_ref(context ? context : g_main_context_default());
+  state_->bus = std::move(bus);
+}
+
+DeferredReplies::~DeferredReplies() {
+  while (!state_->pending.empty()) {
+    Finish(*state_, state_->pending.begin()->first, kTimeoutReply, false);
+  }
+  state_->worker.reset();
+  g_main_context_unref(state_->context);
+}
+
+std::optional<DeferredReplies::Reply> DeferredReplies::Defer(
+    LSHandle* handle,
+    LSMessage* message,
+    ServiceMetrics::CallId call,
+    Sent sent) {
+  if (state_->pending.size() >= state_->max_in_flight) {
+    return std::nullopt;
+  }
+
+  struct TimeoutData {
+    std::weak_ptr<State> state;
+    Id id;
+  };
+
+  const Id id = state_->next_id++;
+  state_->bus.ref(message);
+
+  GSource* timeout = g_timeout_source_new(state_->timeout_ms);
+  g_source_set_callback(
+      timeout,
+      [](gpointer data) -> gboolean {
+        auto* timeout_data = static_cast<TimeoutData*>(data);
+        if (std::shared_ptr<State> state = timeout_data->state.lock()) {
+          Finish(*state, timeout_data->id, kTimeoutReply, false);
+        }
+        return G_SOURCE_REMOVE;
+      },
+      new TimeoutData{state_, id},
+      [](gpointer data) { delete static_cast<TimeoutData*>(data); });
+  g_source_attach(timeout, state_->context);
+
+  state_->pending.emplace(
+      id, State::Pending{handle, message, call, timeout, std::move(sent),
+                         nullptr});
+  return Reply(state_, id);
+}
+
+size_t DeferredReplies::InFlight() const {
+  return state_->pending.size();
+}
+
+void DeferredReplies::SetMaxInFlight(size_t max_in_flight) {
+  state_->max_in_flight = max_in_flight;
+}
+
+void DeferredReplies::SetTimeout(int timeout_ms) {
+  state_->timeout_ms = timeout_ms;
+}
+
+// static
+bool DeferredReplies::Finish(State& state,
+                             Id id,
+                             const std::string& payload,
+                             bool succeeded) {
+  auto found = state.pending.find(id);
+  if (found == state.pending.end()) {
+    return false;
+  }
+  State::Pending pending = std::move(found->second);
+  state.pending.erase(found);
+
+  g_source_destroy(pending.timeout);
+  g_source_unref(pending.timeout);
+  ServiceMetrics::Instance().EndCall(pending.call, succeeded);
+  const bool sent = state.bus.reply(pending.handle, pending.message, payload);
+  state.bus.unref(pending.message);
+  if (sent && succeeded && pending.sent) {
+    pending.sent(payload);
+  }
+  return true;
+}
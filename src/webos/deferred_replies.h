@@ -0,0 +1,123 @@
+// Copyright (c) 2021 LG Electronics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+
+#ifndef WEBOS_DEFERRED_REPLIES_H_
+#define WEBOS_DEFERRED_REPLIES_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <string>
+#include <utility>
+
+#include "service_metrics.h"
+
+typedef struct _GMainContext GMainContext;
+typedef struct LSHandle LSHandle;
+typedef struct LSMessage LSMessage;
+
+namespace Json {
+class Value;
+}
+
+// Bus requests answered after their handler returned, so that heavy
+// replies can be built on a worker thread instead of the main loop. Each
+// deferred request keeps a reference on its message until it is answered,
+// gets an error reply if it isn't answered within the timeout, and at most
+// |max_in_flight| requests are deferred at once. Must be used on the thread
+// of the main context; only the work passed to Reply::Compute() runs on the
+// worker.
+class DeferredReplies {
+ private:
+  struct State;
+
+ public:
+  using Id = uint64_t;
+
+  static constexpr size_t kDefaultMaxInFlight = 4;
+  static constexpr int kDefaultTimeoutMs = 5000;
+
+  // The message operations of LS2, replaced by the tests.
+  struct Bus {
+    std::function<void(LSMessage*)> ref;
+    std::function<void(LSMessage*)> unref;
+    std::function<bool(LSHandle*, LSMessage*, const std::string&)> reply;
+
+    static Bus Ls2();
+  };
+
+  // Answers one deferred request. Copies refer to the same request, which
+  // is answered once; the later replies are ignored.
+  class Reply {
+   public:
+    Reply() = default;
+
+    // False if the request was answered already, e.g. after its timeout.
+    bool Send(const Json::Value& reply) const;
+    // Runs |work| on the worker thread and sends what it returns. |work|
+    // must not touch what the main thread owns. It is skipped if the
+    // request is answered, e.g. timed out, before the worker gets to it.
+    void Compute(std::function<Json::Value()> work) const;
+
+   private:
+    friend class DeferredReplies;
+
+    Reply(std::weak_ptr<State> state, Id id)
+        : state_(std::move(state)), id_(id) {}
+
+    std::weak_ptr<State> state_;
+    Id id_ = 0;
+  };
+
+  // A null |context| is the default main context.
+  explicit DeferredReplies(GMainContext* context = nullptr,
+                           Bus bus = Bus::Ls2());
+  // Pending requests get the timeout error.
+  ~DeferredReplies();
+
+  DeferredReplies(const DeferredReplies&) = delete;
+  DeferredReplies& operator=(const DeferredReplies&) = delete;
+
+  // Gets the payload of a successful reply once it is sent.
+  using Sent = std::function<void(const std::string& payload)>;
+
+  // Takes a reference on |message| to answer it later. Nothing is returned
+  // if too many requests are pending already. |call| ends with the reply.
+  std::optional<Reply> Defer(LSHandle* handle,
+                             LSMessage* message,
+                             ServiceMetrics::CallId call =
+                                 ServiceMetrics::kInvalidCallId,
+                             Sent sent = nullptr);
+
+  size_t InFlight() const;
+  void SetMaxInFlight(size_t max_in_flight);
+  void SetTimeout(int timeout_ms);
+
+  // Sent when |message| can't be deferred or isn't answered in time.
+  static const char kBusyReply[];
+  static const char kTimeoutReply[];
+
+ private:
+  static bool Finish(State& state, Id id, const std::string& payload,
+                     bool succeeded);
+
+  std::shared_ptr<State> state_;
+};
+
+#endif  // WEBOS_DEFERRED_REPLIES_H_
@@ -16,20 +16,39 @@
 
 #include "device_info_impl.h"
 
+#include <optional>
 #include <string>
 
 #include <glib.h>
 #include <json/value.h>
 #include <lunaprefs.h>
 
+#include "file_io_service.h"
 #include "log_manager.h"
+#include "startup_profiler.h"
 #include "utils.h"
 
 DeviceInfoImpl::DeviceInfoImpl() = default;
 
 void DeviceInfoImpl::Initialize() {
-  const std::string& json_string =
-      util::ReadFile("/var/luna/preferences/localeInfo");
+  // Not needed to accept the first launch; the settings service may even
+  // set the language before.
+  StartupProfiler::Instance()->PostIdlePhase(
+      "DeviceInfoImpl::Initialize",
+      [this] {
+        FileIoService::Instance()->ReadFile(
+            "/var/luna/preferences/localeInfo",
+            [this](std::optional<std::string> json_string) {
+              if (json_string) {
+                ApplyLocaleInfo(*json_string);
+              }
+            },
+            &file_reads_);
+      },
+      &idle_tasks_);
+}
+
+void DeviceInfoImpl::ApplyLocaleInfo(const std::string& json_string) {
   if (json_string.empty()) {
     return;
   }
@@ -53,9 +72,16 @@ void DeviceInfoImpl::Initialize() {
   std::string smartservicecountry(
       locale_json["smartServiceCountryCode3"].asString());
 
-  SetSystemLanguage(language.c_str());
-  SetDeviceInfo("LocalCountry", localcountry.c_str());
-  SetDeviceInfo("SmartServiceCountry", smartservicecountry.c_str());
+  // The settings service may have set newer values while the file was read.
+  auto set_if_unset = [this](const char* name, const std::string& value) {
+    std::string current;
+    if (!GetDeviceInfo(name, current)) {
+      SetDeviceInfo(name, value);
+    }
+  };
+  set_if_unset("SystemLanguage", language);
+  set_if_unset("LocalCountry", localcountry);
+  set_if_unset("SmartServiceCountry", smartservicecountry);
 }
 
 bool DeviceInfoImpl::GetInfoFromLunaPrefs(const char* key,
@@ -17,7 +17,11 @@
 #ifndef WEBOS_DEVICE_INFO_IMPL_H_
 #define WEBOS_DEVICE_INFO_IMPL_H_
 
+#include <string>
+
 #include "device_info.h"
+#include "file_io_service.h"
+#include "startup_profiler.h"
 
 class DeviceInfoImpl : public DeviceInfo {
  public:
@@ -43,6 +47,10 @@ class DeviceInfoImpl : public DeviceInfo {
   std::string hardware_version_ = "0x00000001";
   std::string firmware_version_ = "00.00.01";
 
+  FileIoService::TaskGroup file_reads_;
+  StartupProfiler::IdleTasks idle_tasks_;
+
+  void ApplyLocaleInfo(const std::string& json_string);
   bool GetInfoFromLunaPrefs(const char* key, std::string& value) const;
   void InitDisplayInfo();
   void InitPlatformInfo();
@@ -17,6 +17,7 @@
 #include "palm_service_base.h"
 
 #include "log_manager.h"
+#include "service_metrics.h"
 #include "utils.h"
 
 PalmServiceBase::PalmServiceBase() = default;
@@ -134,6 +135,10 @@ bool PalmServiceBase::Call(LSHandle* handle,
                 PMLOGKS("ERROR", ls_error.message), "");
     return false;
   }
+  // Calls without a reply handler can't be timed.
+  if (context) {
+    ServiceMetrics::Instance().BeginCallout(what, handle, context->token_);
+  }
   return true;
 }
 
@@ -154,6 +159,7 @@ bool LSCalloutContext::Cancel() {
 
   LSErrorSafe ls_error;
 
+  ServiceMetrics::Instance().CancelCallout(service_, token_);
   if (!LSCallCancel(service_, token_, &ls_error)) {
     LOG_WARNING(MSGID_LS2_CANCEL_FAIL, 1, PMLOGKS("ERROR", ls_error.message),
                 "Failed to cancel service call");
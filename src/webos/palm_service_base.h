@@ -18,12 +18,19 @@
 #define WEBOS_PALM_SERVICE_BASE_H_
 
 #include <functional>
+#include <optional>
+#include <string>
+#include <utility>
 
 #include <glib.h>
 #include <json/json.h>
 #include <luna-service2/lunaservice.h>
 
+#include "deferred_replies.h"
 #include "log_manager.h"
+#include "main_loop_watchdog.h"
+#include "reply_cache.h"
+#include "service_metrics.h"
 #include "utils.h"
 
 class LSHandle;
@@ -60,6 +67,7 @@ class LSCallbackHandler {
   Json::Value Called(Json::Value payload) { return func_(payload); }
 
   static bool Callback(LSHandle* handle, LSMessage* message, void* user_data) {
+    MainLoopWatchdog::Scope scope("LS2 reply");
     LSErrorSafe ls_error;
 
     if (!message) {
@@ -72,12 +80,17 @@ class LSCallbackHandler {
 
     Json::Value request;
     if (!util::StringToJson(LSMessageGetPayload(message), request)) {
+      ServiceMetrics::Instance().EndCallout(
+          handle, LSMessageGetResponseToken(message), false);
       if (!LSMessageReply(handle, message, "{\"returnValue\": false}",
                           &ls_error)) {
         return false;
       }
       return true;
     }
+    ServiceMetrics::Instance().EndCallout(handle,
+                                          LSMessageGetResponseToken(message),
+                                          ServiceMetrics::Succeeded(request));
 
     Json::Value reply;
 
@@ -145,14 +158,32 @@ static bool bus_callback_json(LSHandle* handle,
     LOG_WARNING(MSGID_LUNA_API, 0, "Failed to parse request message.");
     return false;
   }
+  MainLoopWatchdog::Scope scope(LSMessageGetMethod(message));
+  const std::string method = util::GetString(LSMessageGetMethod(message));
+  ServiceMetrics& metrics = ServiceMetrics::Instance();
+  const ServiceMetrics::CallId call = metrics.BeginCall(method);
+  CLASS* service = static_cast<CLASS*>(user_data);
+
+  ReplyCache& cache = service->GetReplyCache();
+  std::optional<ReplyCache::Key> key = cache.KeyFor(method, request);
+  if (ReplyCache::Content cached = key ? cache.Get(*key) : nullptr) {
+    metrics.EndCall(call, true);
+    return LSMessageReply(handle, message, cached->c_str(), &ls_error);
+  }
+
   Json::Value reply;
 
-  reply = (static_cast<CLASS*>(user_data)->*FUNCTION)(request);
+  reply = (service->*FUNCTION)(request);
+  const bool succeeded = ServiceMetrics::Succeeded(reply);
+  metrics.EndCall(call, succeeded);
 
-  if (!LSMessageReply(handle, message, util::JsonToString(reply).c_str(),
-                      &ls_error)) {
+  std::string payload = util::JsonToString(reply);
+  if (!LSMessageReply(handle, message, payload.c_str(), &ls_error)) {
     return false;
   }
+  if (key && succeeded) {
+    cache.Put(*key, std::move(payload));
+  }
 
   return true;
 }
@@ -184,18 +215,103 @@ static bool bus_subscription_callback_json(LSHandle* handle,
     LOG_WARNING(MSGID_LUNA_API, 0, "Failed to parse request message.");
     return false;
   }
+  MainLoopWatchdog::Scope scope(LSMessageGetMethod(message));
+  const std::string method = util::GetString(LSMessageGetMethod(message));
+  ServiceMetrics& metrics = ServiceMetrics::Instance();
+  const ServiceMetrics::CallId call = metrics.BeginCall(method);
+  CLASS* service = static_cast<CLASS*>(user_data);
+
+  // Only the plain calls are cached; subscribing ones get the reply
+  // marked as subscribed.
+  ReplyCache& cache = service->GetReplyCache();
+  std::optional<ReplyCache::Key> key =
+      subscribed ? std::nullopt : cache.KeyFor(method, request);
+  if (ReplyCache::Content cached = key ? cache.Get(*key) : nullptr) {
+    metrics.EndCall(call, true);
+    return LSMessageReply(handle, message, cached->c_str(), &ls_error);
+  }
+
   Json::Value reply;
 
-  reply = (static_cast<CLASS*>(user_data)->*FUNCTION)(request, subscribed);
+  reply = (service->*FUNCTION)(request, subscribed);
+  const bool succeeded = ServiceMetrics::Succeeded(reply);
+  metrics.EndCall(call, succeeded);
 
   if (subscribed) {
     reply["subscribed"] = true;
   }
 
-  if (!LSMessageReply(handle, message, util::JsonToString(reply).c_str(),
-                      &ls_error)) {
+  std::string payload = util::JsonToString(reply);
+  if (!LSMessageReply(handle, message, payload.c_str(), &ls_error)) {
+    return false;
+  }
+  if (key && succeeded) {
+    cache.Put(*key, std::move(payload));
+  }
+
+  return true;
+}
+
+/*
+ * same as the first one, but the reply may be sent later: the function gets
+ * a DeferredReplies::Reply to answer with and returns a null value while the
+ * reply is pending
+ */
+template <class CLASS,
+          Json::Value (CLASS::*FUNCTION)(const Json::Value&,
+                                         const DeferredReplies::Reply&)>
+static bool bus_deferred_callback_json(LSHandle* handle,
+                                       LSMessage* message,
+                                       void* user_data) {
+  LSErrorSafe ls_error;
+
+  if (!message) {
+    if (!LSMessageReply(handle, message, "{\"returnValue\": false}",
+                        &ls_error)) {
+      return false;
+    }
+    return true;
+  }
+
+  Json::Value request;
+  if (!util::StringToJson(LSMessageGetPayload(message), request)) {
+    LOG_WARNING(MSGID_LUNA_API, 0, "Failed to parse request message.");
     return false;
   }
+  MainLoopWatchdog::Scope scope(LSMessageGetMethod(message));
+  const std::string method = util::GetString(LSMessageGetMethod(message));
+  ServiceMetrics& metrics = ServiceMetrics::Instance();
+  const ServiceMetrics::CallId call = metrics.BeginCall(method);
+  CLASS* service = static_cast<CLASS*>(user_data);
+
+  ReplyCache& cache = service->GetReplyCache();
+  std::optional<ReplyCache::Key> key = cache.KeyFor(method, request);
+  if (ReplyCache::Content cached = key ? cache.Get(*key) : nullptr) {
+    metrics.EndCall(call, true);
+    return LSMessageReply(handle, message, cached->c_str(), &ls_error);
+  }
+
+  // The service outlives its deferred requests, which are answered at the
+  // latest when it is destroyed.
+  DeferredReplies::Sent sent;
+  if (key) {
+    sent = [&cache, key = *key](const std::string& payload) {
+      cache.Put(key, payload);
+    };
+  }
+  std::optional<DeferredReplies::Reply> deferred =
+      service->GetDeferredReplies().Defer(handle, message, call,
+                                          std::move(sent));
+  if (!deferred) {
+    metrics.EndCall(call, false);
+    return LSMessageReply(handle, message, DeferredReplies::kBusyReply,
+                          &ls_error);
+  }
+
+  Json::Value reply = (service->*FUNCTION)(request, *deferred);
+  if (!reply.isNull()) {
+    deferred->Send(reply);
+  }
 
   return true;
 }
@@ -204,14 +320,19 @@ static bool bus_subscription_callback_json(LSHandle* handle,
  * same as above, but for a void function handling the reply
  */
 template <class CLASS, void (CLASS::*FUNCTION)(const Json::Value&)>
-static bool bus_callback_json(LSHandle* /*handle*/,
+static bool bus_callback_json(LSHandle* handle,
                               LSMessage* message,
                               void* user_data) {
+  MainLoopWatchdog::Scope scope("LS2 reply");
   Json::Value reply;
   if (message) {
-    if (!util::StringToJson(LSMessageGetPayload(message), reply)) {
+    bool parsed = util::StringToJson(LSMessageGetPayload(message), reply);
+    if (!parsed) {
       LOG_WARNING(MSGID_LUNA_API, 0, "Failed to parse reply message.");
     }
+    ServiceMetrics::Instance().EndCallout(
+        handle, LSMessageGetResponseToken(message),
+        parsed && ServiceMetrics::Succeeded(reply));
   }
 
   (static_cast<CLASS*>(user_data)->*FUNCTION)(reply);
@@ -253,6 +374,9 @@ class PalmServiceBase {
 
   virtual void DidConnect() = 0;
 
+  DeferredReplies& GetDeferredReplies() { return deferred_replies_; }
+  ReplyCache& GetReplyCache() { return reply_cache_; }
+
  protected:
   /*
    * helper methods for simple calls that come back into methods using a bit of
@@ -268,24 +392,26 @@ class PalmServiceBase {
             Json::Value parameters,
             HANDLER_CLASS* callback_receiver) {
     LSErrorSafe ls_error;
+    LSMessageToken token = LSMESSAGE_TOKEN_INVALID;
     bool err = false;
     if (parameters.isObject() &&
         (parameters["subscribe"].asBool() || parameters["watch"].asBool())) {
       err =
           LSCall(service_handle_, what, util::JsonToString(parameters).c_str(),
                  bus_callback_json<HANDLER_CLASS, CALLBACK_METHOD>,
-                 callback_receiver, nullptr, &ls_error);
+                 callback_receiver, &token, &ls_error);
     } else {
       err = LSCallOneReply(service_handle_, what,
                            util::JsonToString(parameters).c_str(),
                            bus_callback_json<HANDLER_CLASS, CALLBACK_METHOD>,
-                           callback_receiver, nullptr, &ls_error);
+                           callback_receiver, &token, &ls_error);
     }
     if (!err) {
       LOG_WARNING(MSGID_LUNA_API, 0, "Failed to call in %s Service: %s",
                   service_name_.c_str(), ls_error.message);
       return false;
     }
+    ServiceMetrics::Instance().BeginCallout(what, service_handle_, token);
     return true;
   }
 
@@ -306,6 +432,9 @@ class PalmServiceBase {
             const char* application_id,
             LSCalloutContext* context);
   std::string service_name_;
+  // Outlives the deferred requests, whose replies it may keep.
+  ReplyCache reply_cache_;
+  DeferredReplies deferred_replies_;
 };
 
 #endif  // WEBOS_PALM_SERVICE_BASE_H_
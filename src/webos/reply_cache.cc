@@ -0,0 +1,127 @@
+// Copyright (c) 2021 LG Electronics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#include "reply_cache.h"
+
+#include <chrono>
+#include <utility>
+
+#include <json/json.h>
+
+#include "metrics_registry.h"
+
+namespace {
+
+CounterFamily hits("wam_reply_cache_hits_total",
+                   "Bus requests answered from the reply cache",
+                   "method");
+CounterFamily misses("wam_reply_cache_misses_total",
+                     "Bus requests of cached methods built again",
+                     "method");
+CounterFamily invalidations("wam_reply_cache_invalidations_total",
+                            "Reply cache invalidations on app state changes",
+                            "");
+
+int64_t SteadyClockMs() {
+  return std::chrono::duration_cast<std::chrono::milliseconds>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+std::string EntryKey(const ReplyCache::Key& key) {
+  std::string entry_key;
+  entry_key.reserve(key.method.size() + key.request.size() + 1);
+  entry_key.append(key.method).append(1, '\n').append(key.request);
+  return entry_key;
+}
+
+}  // namespace
+
+ReplyCache::ReplyCache(size_t max_entries)
+    : max_entries_(max_entries), clock_(&SteadyClockMs) {}
+
+void ReplyCache::Enable(const std::string& method, int ttl_ms) {
+  ttl_ms_[method] = ttl_ms;
+}
+
+std::optional<ReplyCache::Key> ReplyCache::KeyFor(
+    const std::string& method,
+    const Json::Value& request) const {
+  if (!ttl_ms_.contains(method)) {
+    return std::nullopt;
+  }
+
+  Json::StreamWriterBuilder builder;
+  builder["indentation"] = "";
+  return Key{method, Json::writeString(builder, request), generation_};
+}
+
+ReplyCache::Content ReplyCache::Get(const Key& key) {
+  auto found = entries_.find(EntryKey(key));
+  if (found != entries_.end() && found->second.expires_ms > clock_()) {
+    ++stats_.hits;
+    hits.WithLabel(key.method).Increment();
+    return found->second.reply;
+  }
+
+  ++stats_.misses;
+  misses.WithLabel(key.method).Increment();
+  return nullptr;
+}
+
+void ReplyCache::Put(const Key& key, std::string reply) {
+  auto ttl = ttl_ms_.find(key.method);
+  if (key.generation != generation_ || ttl == ttl_ms_.end()) {
+    return;
+  }
+
+  const int64_t now = clock_();
+  std::string entry_key = EntryKey(key);
+  if (!entries_.contains(entry_key) && entries_.size() >= max_entries_) {
+    EraseExpired(now);
+    if (entries_.size() >= max_entries_) {
+      return;
+    }
+  }
+
+  entries_[std::move(entry_key)] =
+      Entry{std::make_shared<const std::string>(std::move(reply)),
+            now + ttl->second};
+  stats_.entries = entries_.size();
+}
+
+void ReplyCache::Invalidate() {
+  ++generation_;
+  ++stats_.invalidations;
+  invalidations.Get().Increment();
+  entries_.clear();
+  stats_.entries = 0;
+}
+
+ReplyCache::Stats ReplyCache::GetStats() const {
+  return stats_;
+}
+
+void ReplyCache::SetClockForTesting(Clock clock) {
+  clock_ = clock ? clock : &SteadyClockMs;
+}
+
+void ReplyCache::EraseExpired(int64_t now) {
+  std::erase_if(entries_, [now](const auto& item) {
+    return item.second.expires_ms <= now;
+  });
+  stats_.entries = entries_.size();
+}
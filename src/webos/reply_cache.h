@@ -0,0 +1,96 @@
+// Copyright (c) 2021 LG Electronics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef WEBOS_REPLY_CACHE_H_
+#define WEBOS_REPLY_CACHE_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string>
+#include <unordered_map>
+
+namespace Json {
+class Value;
+}
+
+// Serialized replies of idempotent bus getters, so that services polling
+// them get the same bytes again instead of a rebuilt reply. Only the
+// methods enabled with Enable() are cached. An entry lives for the time to
+// live of its method or until Invalidate(), which the service calls when
+// the state the replies are built from changes. Must be used on the main
+// thread.
+class ReplyCache {
+ public:
+  using Content = std::shared_ptr<const std::string>;
+  // Monotonic time in milliseconds.
+  using Clock = int64_t (*)();
+
+  // Replies to one request. A reply built under an older generation was
+  // built from a state invalidated since, and is not kept.
+  struct Key {
+    std::string method;
+    std::string request;
+    uint64_t generation = 0;
+  };
+
+  struct Stats {
+    uint64_t hits = 0;
+    uint64_t misses = 0;
+    uint64_t invalidations = 0;
+    size_t entries = 0;
+  };
+
+  static constexpr size_t kDefaultMaxEntries = 64;
+
+  explicit ReplyCache(size_t max_entries = kDefaultMaxEntries);
+
+  ReplyCache(const ReplyCache&) = delete;
+  ReplyCache& operator=(const ReplyCache&) = delete;
+
+  void Enable(const std::string& method, int ttl_ms);
+
+  // Nothing is returned if |method| isn't cached. The request is keyed by
+  // its compact JSON form, in which the members are sorted.
+  std::optional<Key> KeyFor(const std::string& method,
+                            const Json::Value& request) const;
+  // Returns null on a miss.
+  Content Get(const Key& key);
+  void Put(const Key& key, std::string reply);
+  void Invalidate();
+
+  Stats GetStats() const;
+  void SetClockForTesting(Clock clock);
+
+ private:
+  struct Entry {
+    Content reply;
+    int64_t expires_ms;
+  };
+
+  void EraseExpired(int64_t now);
+
+  const size_t max_entries_;
+  Clock clock_;
+  std::unordered_map<std::string, int> ttl_ms_;
+  // Keyed by the method and the request.
+  std::unordered_map<std::string, Entry> entries_;
+  uint64_t generation_ = 0;
+  Stats stats_;
+};
+
+#endif  // WEBOS_REPLY_CACHE_H_
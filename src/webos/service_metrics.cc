@@ -0,0 +1,203 @@
+// Copyright (c) 2021 LG Electronics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+
+#include "service_metrics.h"
+
+#include <algorithm>
+#include <chrono>
+
+#include <json/value.h>
+
+namespace {
+
+int64_t SteadyClockUs() {
+  return std::chrono::duration_cast<std::chrono::microseconds>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+Json::Value StatsToJson(const ServiceMetrics::Stats& stats) {
+  const LatencyHistogram& histogram = stats.latency;
+  Json::Value latency;
+  latency["count"] = static_cast<Json::UInt64>(histogram.Count());
+  latency["minUs"] = static_cast<Json::Int64>(histogram.Min());
+  latency["meanUs"] = static_cast<Json::Int64>(histogram.Mean());
+  latency["p50Us"] = static_cast<Json::Int64>(histogram.Percentile(50));
+  latency["p90Us"] = static_cast<Json::Int64>(histogram.Percentile(90));
+  latency["p99Us"] = static_cast<Json::Int64>(histogram.Percentile(99));
+  latency["maxUs"] = static_cast<Json::Int64>(histogram.Max());
+
+  Json::Value result;
+  result["calls"] = static_cast<Json::UInt64>(stats.calls);
+  result["errors"] = static_cast<Json::UInt64>(stats.errors);
+  result["inFlight"] = stats.in_flight;
+  result["maxInFlight"] = stats.max_in_flight;
+  result["latency"] = std::move(latency);
+  return result;
+}
+
+}  // namespace
+
+// static
+ServiceMetrics& ServiceMetrics::Instance() {
+  static ServiceMetrics metrics;
+  return metrics;
+}
+
+ServiceMetrics::ServiceMetrics() : clock_(&SteadyClockUs) {}
+
+ServiceMetrics::CallId ServiceMetrics::BeginCall(std::string_view method) {
+  const CallId id = next_call_id_++;
+  Begin(Direction::kInbound, method, {nullptr, id});
+  return id;
+}
+
+void ServiceMetrics::EndCall(CallId id, bool succeeded) {
+  End({nullptr, id}, succeeded);
+}
+
+void ServiceMetrics::BeginCallout(std::string_view callee,
+                                  const void* channel,
+                                  uint64_t token) {
+  if (channel) {
+    Begin(Direction::kOutbound, callee, {channel, token});
+  }
+}
+
+void ServiceMetrics::EndCallout(const void* channel,
+                                uint64_t token,
+                                bool succeeded) {
+  if (channel) {
+    End({channel, token}, succeeded);
+  }
+}
+
+void ServiceMetrics::CancelCallout(const void* channel, uint64_t token) {
+  if (channel) {
+    Cancel({channel, token});
+  }
+}
+
+// static
+bool ServiceMetrics::Succeeded(const Json::Value& reply) {
+  return !reply.isObject() || !reply.isMember("returnValue") ||
+         reply["returnValue"] != false;
+}
+
+const ServiceMetrics::Stats* ServiceMetrics::Find(Direction direction,
+                                                  std::string_view name) const {
+  const StatsMap& map =
+      direction == Direction::kInbound ? methods_ : callouts_;
+  auto found = map.find(name);
+  return found == map.end() ? nullptr : &found->second;
+}
+
+size_t ServiceMetrics::Overdue(std::string_view callee) const {
+  const int64_t now = clock_();
+  return std::count_if(pending_.begin(), pending_.end(), [&](const auto& it) {
+    const Pending& pending = it.second;
+    return pending.direction == Direction::kOutbound &&
+           pending.entry->first == callee &&
+           now - pending.start_us > timeout_us_;
+  });
+}
+
+void ServiceMetrics::Reset() {
+  for (StatsMap* map : {&methods_, &callouts_}) {
+    for (auto& [name, stats] : *map) {
+      const uint32_t in_flight = stats.in_flight;
+      stats = Stats();
+      stats.in_flight = in_flight;
+      stats.max_in_flight = in_flight;
+    }
+  }
+}
+
+Json::Value ServiceMetrics::ToJson() const {
+  Json::Value methods(Json::objectValue);
+  for (const auto& [name, stats] : methods_) {
+    methods[name] = StatsToJson(stats);
+  }
+
+  Json::Value callouts(Json::objectValue);
+  for (const auto& [callee, stats] : callouts_) {
+    Json::Value callout = StatsToJson(stats);
+    callout["timeouts"] = static_cast<Json::UInt64>(stats.timeouts);
+    callout["overdue"] = static_cast<Json::UInt64>(Overdue(callee));
+    callouts[callee] = std::move(callout);
+  }
+
+  Json::Value result;
+  result["timeoutMs"] = static_cast<Json::Int64>(timeout_us_ / 1000);
+  result["methods"] = std::move(methods);
+  result["callouts"] = std::move(callouts);
+  return result;
+}
+
+ServiceMetrics::StatsMap& ServiceMetrics::Map(Direction direction) {
+  return direction == Direction::kInbound ? methods_ : callouts_;
+}
+
+void ServiceMetrics::Begin(Direction direction,
+                           std::string_view name,
+                           const Key& key) {
+  StatsMap& map = Map(direction);
+  auto entry = map.find(name);
+  if (entry == map.end()) {
+    entry = map.emplace(std::string(name), Stats()).first;
+  }
+  Stats& stats = entry->second;
+  ++stats.calls;
+  ++stats.in_flight;
+  stats.max_in_flight = std::max(stats.max_in_flight, stats.in_flight);
+
+  // A token reused by LS2 replaces a call which never got its reply.
+  auto [it, inserted] =
+      pending_.try_emplace(key, Pending{direction, entry, clock_()});
+  if (!inserted) {
+    --it->second.entry->second.in_flight;
+    it->second = Pending{direction, entry, clock_()};
+  }
+}
+
+void ServiceMetrics::End(const Key& key, bool succeeded) {
+  auto found = pending_.find(key);
+  if (found == pending_.end()) {
+    return;
+  }
+  const Pending& pending = found->second;
+  Stats& stats = pending.entry->second;
+  const int64_t latency_us = clock_() - pending.start_us;
+  stats.latency.Add(latency_us);
+  --stats.in_flight;
+  if (!succeeded) {
+    ++stats.errors;
+  }
+  if (pending.direction == Direction::kOutbound && latency_us > timeout_us_) {
+    ++stats.timeouts;
+  }
+  pending_.erase(found);
+}
+
+void ServiceMetrics::Cancel(const Key& key) {
+  auto found = pending_.find(key);
+  if (found == pending_.end()) {
+    return;
+  }
+  --found->second.entry->second.in_flight;
+  pending_.erase(found);
+}
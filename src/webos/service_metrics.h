@@ -0,0 +1,121 @@
+// Copyright (c) 2021 LG Electronics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+
+#ifndef WEBOS_SERVICE_METRICS_H_
+#define WEBOS_SERVICE_METRICS_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <string>
+#include <string_view>
+#include <utility>
+
+#include "latency_histogram.h"
+
+namespace Json {
+class Value;
+}
+
+// Latency histograms and in-flight counts of the bus traffic of WAM, kept
+// per method called on WAM and per callee URI WAM calls out to. Calls are
+// timed with the monotonic clock from their dispatch (or send) to their
+// reply. Outbound calls are identified by the handle they were sent on and
+// their LS2 token, and only those with a reply handler are tracked. A
+// callout is timed out if its reply arrives after |timeout|; the calls
+// still waiting past it are reported as overdue. Not synchronized, the bus
+// is served from the main loop.
+class ServiceMetrics {
+ public:
+  enum class Direction { kInbound, kOutbound };
+
+  struct Stats {
+    uint64_t calls = 0;
+    uint64_t errors = 0;
+    uint64_t timeouts = 0;
+    uint32_t in_flight = 0;
+    uint32_t max_in_flight = 0;
+    LatencyHistogram latency;
+  };
+
+  using CallId = uint64_t;
+  static constexpr CallId kInvalidCallId = 0;
+  static constexpr int64_t kDefaultTimeoutUs = 5 * 1000 * 1000;
+
+  // Monotonic time in microseconds.
+  using Clock = int64_t (*)();
+
+  static ServiceMetrics& Instance();
+
+  ServiceMetrics();
+
+  ServiceMetrics(const ServiceMetrics&) = delete;
+  ServiceMetrics& operator=(const ServiceMetrics&) = delete;
+
+  // A method of WAM is dispatched, |EndCall| gets its reply.
+  CallId BeginCall(std::string_view method);
+  void EndCall(CallId id, bool succeeded);
+
+  // A call to |callee| was sent on |channel| and got |token|. The first
+  // reply ends it, the following ones of a subscription are not timed.
+  void BeginCallout(std::string_view callee,
+                    const void* channel,
+                    uint64_t token);
+  void EndCallout(const void* channel, uint64_t token, bool succeeded);
+  void CancelCallout(const void* channel, uint64_t token);
+
+  // False if |reply| is an object with a false "returnValue".
+  static bool Succeeded(const Json::Value& reply);
+
+  const Stats* Find(Direction direction, std::string_view name) const;
+  // Callouts to |callee| waiting for longer than the timeout.
+  size_t Overdue(std::string_view callee) const;
+
+  void SetTimeout(int64_t timeout_us) { timeout_us_ = timeout_us; }
+  int64_t Timeout() const { return timeout_us_; }
+  void SetClockForTesting(Clock clock) { clock_ = clock; }
+
+  // Clears the counters and histograms, calls in flight are kept.
+  void Reset();
+
+  Json::Value ToJson() const;
+
+ private:
+  using StatsMap = std::map<std::string, Stats, std::less<>>;
+  using Key = std::pair<const void*, uint64_t>;
+
+  struct Pending {
+    Direction direction;
+    StatsMap::iterator entry;
+    int64_t start_us;
+  };
+
+  StatsMap& Map(Direction direction);
+  void Begin(Direction direction, std::string_view name, const Key& key);
+  void End(const Key& key, bool succeeded);
+  void Cancel(const Key& key);
+
+  StatsMap methods_;
+  StatsMap callouts_;
+  std::map<Key, Pending> pending_;
+  CallId next_call_id_ = kInvalidCallId + 1;
+  int64_t timeout_us_ = kDefaultTimeoutUs;
+  Clock clock_;
+};
+
+#endif  // WEBOS_SERVICE_METRICS_H_
@@ -71,3 +71,7 @@ void ServiceSenderLuna::ServiceCall(const std::string& url,
 void ServiceSenderLuna::CloseApp(const std::string& id) {
   WebAppManagerServiceLuna::Instance()->CloseApp(id);
 }
+
+void ServiceSenderLuna::RunningAppsChanged() {
+  WebAppManagerServiceLuna::Instance()->GetReplyCache().Invalidate();
+}
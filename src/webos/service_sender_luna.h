@@ -31,6 +31,7 @@ class ServiceSenderLuna : public ServiceSender {
                    const std::string& payload,
                    const std::string& app_id) override;
   void CloseApp(const std::string& id) override;
+  void RunningAppsChanged() override;
 };
 
 #endif  // WEBOS_SERVICE_SENDER_LUNA_H_
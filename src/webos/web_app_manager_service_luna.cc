@@ -18,6 +18,7 @@
 
 #include <codecvt>
 #include <locale>
+#include <optional>
 #include <string>
 #include <vector>
 
@@ -26,6 +27,9 @@
 #include "webos/webview_base.h"
 
 #include "log_manager.h"
+#include "service_metrics.h"
+#include "startup_profiler.h"
+#include "trace_recorder.h"
 #include "utils.h"
 #include "web_app_manager_tracer.h"
 
@@ -35,8 +39,13 @@
 #define QCB_subscription(FUNC)                             \
   bus_subscription_callback_json<WebAppManagerServiceLuna, \
                                  &WebAppManagerServiceLuna::FUNC>
+#define QCB_deferred(FUNC)                             \
+  bus_deferred_callback_json<WebAppManagerServiceLuna, \
+                             &WebAppManagerServiceLuna::FUNC>
 #define LS2_METHOD_ENTRY(FUNC) \
   { #FUNC, QCB(FUNC), LUNA_METHOD_FLAGS_NONE }
+#define LS2_DEFERRED_METHOD_ENTRY(FUNC) \
+  { #FUNC, QCB_deferred(FUNC), LUNA_METHOD_FLAGS_NONE }
 #define LS2_SUBSCRIPTION_ENTRY(FUNC) \
   { #FUNC, QCB_subscription(FUNC), LUNA_METHOD_FLAGS_NONE }
 
@@ -47,6 +56,16 @@
   Call<WebAppManagerServiceLuna, &WebAppManagerServiceLuna::FUNC>( \
       SERVICE, PARAMS, this)
 
+namespace {
+
+// Memory sizes drift without app state changes, so their replies are only
+// kept for a few polls. The app list is invalidated on every change and its
+// time to live is only a safety net.
+constexpr int kMemoryReplyTtlMs = 3000;
+constexpr int kRunningAppsReplyTtlMs = 60000;
+
+}  // namespace
+
 LSMethod WebAppManagerServiceLuna::methods_[] = {
     LS2_METHOD_ENTRY(launchApp),
     LS2_METHOD_ENTRY(killApp),
@@ -56,14 +75,25 @@ LSMethod WebAppManagerServiceLuna::methods_[] = {
     LS2_METHOD_ENTRY(setInspectorEnable),
 #endif
     LS2_METHOD_ENTRY(logControl),
-    LS2_METHOD_ENTRY(getWebProcessSize),
+    LS2_DEFERRED_METHOD_ENTRY(getWebProcessSize),
+    LS2_METHOD_ENTRY(getAppMemoryUsage),
+    LS2_METHOD_ENTRY(getInputLatency),
+    LS2_METHOD_ENTRY(dumpTrace),
+    LS2_METHOD_ENTRY(getServiceMetrics),
+    LS2_METHOD_ENTRY(getMetrics),
+    LS2_METHOD_ENTRY(getStartupProfile),
     LS2_METHOD_ENTRY(clearBrowsingData),
     LS2_METHOD_ENTRY(fireNotificationEvent),
     LS2_SUBSCRIPTION_ENTRY(listRunningApps),
     LS2_SUBSCRIPTION_ENTRY(webProcessCreated),
     {}};
 
-WebAppManagerServiceLuna::WebAppManagerServiceLuna() = default;
+WebAppManagerServiceLuna::WebAppManagerServiceLuna() {
+  ReplyCache& cache = GetReplyCache();
+  cache.Enable("getAppMemoryUsage", kMemoryReplyTtlMs);
+  cache.Enable("getWebProcessSize", kMemoryReplyTtlMs);
+  cache.Enable("listRunningApps", kRunningAppsReplyTtlMs);
+}
 
 WebAppManagerServiceLuna::~WebAppManagerServiceLuna() = default;
 
@@ -241,9 +271,14 @@ Json::Value WebAppManagerServiceLuna::closeAllApps(
 }
 
 Json::Value WebAppManagerServiceLuna::logControl(const Json::Value& request) {
+  LogManager::Level level;
   if (!request.isObject() ||
       (!request.isMember("keys") || !request["keys"].isString()) ||
-      (!request.isMember("value") || !request["value"].isString())) {
+      (!request.isMember("value") || !request["value"].isString()) ||
+      (request.isMember("category") && !request["category"].isString()) ||
+      (request["keys"] == "level" &&
+       !LogManager::LevelFromName(request["value"].asString(), level) &&
+       (request["value"] != "default" || !request.isMember("category")))) {
     Json::Value reply;
     reply["returnValue"] = false;
     reply["errorCode"] = kErrCodeInvalidParam;
@@ -252,7 +287,8 @@ Json::Value WebAppManagerServiceLuna::logControl(const Json::Value& request) {
   }
 
   return WebAppManagerService::OnLogControl(request["keys"].asString(),
-                                            request["value"].asString());
+                                            request["value"].asString(),
+                                            request["category"].asString());
 }
 
 Json::Value WebAppManagerServiceLuna::getWebProcessSize(
@@ -260,6 +296,145 @@ Json::Value WebAppManagerServiceLuna::getWebProcessSize(
   return WebAppManagerService::GetWebProcessProfiling();
 }
 
+Json::Value WebAppManagerServiceLuna::getWebProcessSize(
+    const Json::Value& /*request*/,
+    const DeferredReplies::Reply& reply) {
+  reply.Compute(WebAppManagerService::GetWebProcessProfilingTask());
+  return Json::Value();
+}
+
+Json::Value WebAppManagerServiceLuna::getAppMemoryUsage(
+    const Json::Value& request) {
+  if (!request.isObject() ||
+      (request.isMember("appId") && !request["appId"].isString())) {
+    Json::Value reply;
+    reply["returnValue"] = false;
+    reply["errorCode"] = kErrCodeInvalidParam;
+    reply["errorText"] = kErrInvalidParam;
+    return reply;
+  }
+
+  Json::Value reply =
+      WebAppManagerService::GetAppMemoryUsage(request["appId"].asString());
+  reply["returnValue"] = true;
+  return reply;
+}
+
+Json::Value WebAppManagerServiceLuna::getInputLatency(
+    const Json::Value& request) {
+  if (!request.isObject() ||
+      (request.isMember("appId") && !request["appId"].isString()) ||
+      (request.isMember("enable") && !request["enable"].isBool()) ||
+      (request.isMember("sampleInterval") &&
+       (!request["sampleInterval"].isUInt() ||
+        request["sampleInterval"].asUInt() == 0)) ||
+      (request.isMember("reset") && !request["reset"].isBool())) {
+    Json::Value reply;
+    reply["returnValue"] = false;
+    reply["errorCode"] = kErrCodeInvalidParam;
+    reply["errorText"] = kErrInvalidParam;
+    return reply;
+  }
+
+  std::optional<bool> enable;
+  if (request.isMember("enable")) {
+    enable = request["enable"].asBool();
+  }
+  WebAppManagerService::SetInputLatencyTracking(
+      enable, request["sampleInterval"].asUInt());
+
+  Json::Value reply = WebAppManagerService::GetInputLatency(
+      request["appId"].asString(), request["reset"].asBool());
+  reply["returnValue"] = true;
+  return reply;
+}
+
+Json::Value WebAppManagerServiceLuna::dumpTrace(const Json::Value& request) {
+  Json::Value reply;
+  if (!request.isObject() ||
+      (request.isMember("enable") && !request["enable"].isBool()) ||
+      request.isMember("path")) {
+    reply["returnValue"] = false;
+    reply["errorCode"] = kErrCodeInvalidParam;
+    reply["errorText"] = kErrInvalidParam;
+    return reply;
+  }
+
+  // Either switches the recording or writes the configured trace file.
+  if (request.isMember("enable")) {
+    WebAppManagerService::SetTracingEnabled(request["enable"].asBool());
+  } else {
+    std::string path;
+    size_t events = 0;
+    if (!WebAppManagerService::DumpTrace(path, events)) {
+      reply["returnValue"] = false;
+      reply["errorCode"] = kErrCodeDumpTraceFailed;
+      reply["errorText"] = kErrDumpTraceFailed;
+      return reply;
+    }
+    reply["path"] = path;
+    reply["events"] = static_cast<Json::UInt64>(events);
+  }
+
+  reply["enabled"] = TraceRecorder::IsEnabled();
+  reply["returnValue"] = true;
+  return reply;
+}
+
+Json::Value WebAppManagerServiceLuna::getServiceMetrics(
+    const Json::Value& request) {
+  if (!request.isObject() ||
+      (request.isMember("reset") && !request["reset"].isBool())) {
+    Json::Value reply;
+    reply["returnValue"] = false;
+    reply["errorCode"] = kErrCodeInvalidParam;
+    reply["errorText"] = kErrInvalidParam;
+    return reply;
+  }
+
+  ServiceMetrics& metrics = ServiceMetrics::Instance();
+  Json::Value reply = metrics.ToJson();
+  if (request["reset"].asBool()) {
+    metrics.Reset();
+  }
+  reply["returnValue"] = true;
+  return reply;
+}
+
+Json::Value WebAppManagerServiceLuna::getStartupProfile(
+    const Json::Value& /*request*/) {
+  Json::Value reply = StartupProfiler::Instance()->ToJson();
+  reply["returnValue"] = true;
+  return reply;
+}
+
+Json::Value WebAppManagerServiceLuna::getMetrics(const Json::Value& request) {
+  Json::Value reply;
+  if (!request.isObject() ||
+      (request.isMember("export") && !request["export"].isBool()) ||
+      request.isMember("path")) {
+    reply["returnValue"] = false;
+    reply["errorCode"] = kErrCodeInvalidParam;
+    reply["errorText"] = kErrInvalidParam;
+    return reply;
+  }
+
+  if (request["export"].asBool()) {
+    std::string path;
+    if (!WebAppManagerService::ExportMetrics(path)) {
+      reply["returnValue"] = false;
+      reply["errorCode"] = kErrCodeExportMetricsFailed;
+      reply["errorText"] = kErrExportMetricsFailed;
+      return reply;
+    }
+    reply["path"] = path;
+  } else {
+    reply["metrics"] = WebAppManagerService::GetMetrics();
+  }
+  reply["returnValue"] = true;
+  return reply;
+}
+
 Json::Value WebAppManagerServiceLuna::listRunningApps(
     const Json::Value& request,
     bool /*subscribed*/) {
@@ -407,6 +582,13 @@ Json::Value WebAppManagerServiceLuna::fireNotificationEvent(
 }
 
 void WebAppManagerServiceLuna::DidConnect() {
+  // Launches are served before the other services are followed.
+  StartupProfiler::Instance()->PostIdlePhase(
+      "RegisterServerStatus", [this] { RegisterServerStatus(); },
+      &idle_tasks_);
+}
+
+void WebAppManagerServiceLuna::RegisterServerStatus() {
   Json::Value params;
   params["subscribe"] = true;
 
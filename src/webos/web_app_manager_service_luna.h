@@ -20,6 +20,7 @@
 #include <string>
 
 #include "palm_service_base.h"
+#include "startup_profiler.h"
 #include "web_app_manager_service.h"
 
 namespace Json {
@@ -47,6 +48,15 @@ class WebAppManagerServiceLuna : public PalmServiceBase,
   Json::Value listRunningApps(const Json::Value& request,
                               bool subscribed) override;
   Json::Value getWebProcessSize(const Json::Value& request) override;
+  // The bus handler; the process sizes are read on the worker thread.
+  Json::Value getWebProcessSize(const Json::Value& request,
+                                const DeferredReplies::Reply& reply);
+  Json::Value getAppMemoryUsage(const Json::Value& request) override;
+  Json::Value getInputLatency(const Json::Value& request) override;
+  Json::Value dumpTrace(const Json::Value& request) override;
+  Json::Value getServiceMetrics(const Json::Value& request) override;
+  Json::Value getMetrics(const Json::Value& request) override;
+  Json::Value getStartupProfile(const Json::Value& request) override;
   Json::Value pauseApp(const Json::Value& request) override;
   Json::Value clearBrowsingData(const Json::Value& request) override;
   Json::Value webProcessCreated(const Json::Value& request,
@@ -84,6 +94,9 @@ class WebAppManagerServiceLuna : public PalmServiceBase,
 
  private:
   bool IsValidInstanceId(const std::string& instance_id);
+  void RegisterServerStatus();
+
+  StartupProfiler::IdleTasks idle_tasks_;
 };
 
 #endif  // WEBOS_WEB_APP_MANAGER_SERVICE_LUNA_H_